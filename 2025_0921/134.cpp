@@ -1,53 +1,187 @@
 #include<iostream>
 #include<vector>
+#include<chrono>
+#include<random>
+#include<limits>
+#include<thread>
+#include<cstring>
+#include<cstdlib>
+#include<cstdio>
+#include "../common/work_stealing_pool.h"
+#include "../common/trace_ring.h"
+#include "134.h"
 using namespace std;
+using namespace lc134;
 
-class Solution {
-public:
-    int canCompleteCircuit(vector<int>& gas, vector<int>& cost) {
-        int n = gas.size();
-        int i = 0;
-        cout << "\n=== Starting Gas Station Circuit Analysis ===" << endl;
-        cout << "Total stations: " << n << endl;
-        
-        while(i < n) {
-            cout << "\n--- Trying to start from station " << i << " ---" << endl;
-            int sumOfGas = 0;
-            int sumOfCost = 0;
-            int cnt = 0;
-            
-            while(cnt < n) {
-                int j = (i + cnt) % n;
-                sumOfGas += gas[j];
-                sumOfCost += cost[j];
-                
-                cout << "Step " << cnt + 1 << ": At station " << j 
-                     << " -> Gas: +" << gas[j] << " (total: " << sumOfGas 
-                     << "), Cost: +" << cost[j] << " (total: " << sumOfCost << ")";
-                
-                if (sumOfCost > sumOfGas) {
-                    cout << " -> FAILED! Not enough gas." << endl;
-                    break;
-                } else {
-                    cout << " -> OK, remaining gas: " << (sumOfGas - sumOfCost) << endl;
-                }
-                cnt++;
-            }
-            
-            if (cnt == n) {
-                cout << "SUCCESS! Completed full circuit from station " << i << endl;
-                return i;
-            } else {
-                cout << "Failed at step " << cnt + 1 << ", skipping to station " << (i + cnt + 1) << endl;
-                i = i + cnt + 1;
-            }
+// 编译运行：
+//   g++ -O3 -std=c++17 -pthread 134.cpp -o gas_station
+//   ./gas_station                    # 原来的逐步日志演示
+//   g++ -O3 -std=c++17 -pthread -DGAS_STATION_LOG=0 134.cpp -o gas_station_quiet
+//   ./gas_station_quiet bench [M 个加油站] [线程数]
+//   g++ -O3 -std=c++17 -pthread -DGAS_STATION_LOG=0 -DTRACE_COMPILED=1 134.cpp -o gas_station_trace
+//   ./gas_station_trace tracebench [M 个加油站]     # 追踪点关闭 / 打开时的开销
+
+// ================= 基准：bench [M 个加油站] [线程数] =================
+
+template <class F>
+static double bestSeconds(F&& f, int reps) {
+    double best = 1e100;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = chrono::steady_clock::now();
+        f();
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - t0).count());
+    }
+    return best;
+}
+
+static int runBenchmark(size_t millions, size_t threads) {
+    mt19937 rng(134);
+    ws::WorkStealingPool pool(threads);
+    bool ok = true;
+
+    // 正确性：小规模随机环路，与暴力解、原 Solution（日志编译掉时）、并行版逐一对照
+    for (int iter = 0; iter < 5000 && ok; ++iter) {
+        vector<int> g, c;
+        makeCircuit(rng, 1 + rng() % 40, rng() % 2, g, c);
+        int expect = bruteForceStart(g, c);
+        ok &= gas::canCompleteCircuit(g.data(), c.data(), g.size()) == expect;
+        ok &= gas::canCompleteCircuitParallel(pool, g.data(), c.data(), g.size(), 1 + rng() % 8) == expect;
+#if !GAS_STATION_LOG
+        ok &= Solution().canCompleteCircuit(g, c) == expect;
+#endif
+    }
+    cout << (ok ? "正确性校验通过" : "正确性校验失败") << endl;
+
+    // 1) 一条超长环路
+    const size_t n = millions * 1000000;
+    vector<int> g, c;
+    makeCircuit(rng, n, true, g, c);
+    volatile int sink = 0;
+    int expect = gas::canCompleteCircuit(g.data(), c.data(), n);
+    printf("单条环路：%zu M 个加油站（%.0f MB），起点 = %d\n", millions, 2.0 * n * sizeof(int) / (1 << 20), expect);
+    auto report = [&](const char* name, double t) {
+        printf("  %-30s: %8.2f ms  %6.2f G 站/秒\n", name, t * 1e3, n / t / 1e9);
+    };
+#if GAS_STATION_LOG
+    printf("  （Solution 带日志编译，跳过；用 -DGAS_STATION_LOG=0 重新编译才能对比）\n");
+#else
+    report("Solution（日志已编译掉）", bestSeconds([&] { sink = Solution().canCompleteCircuit(g, c); }, 3));
+    ok &= sink == expect;
+#endif
+    report("gas::canCompleteCircuit", bestSeconds([&] { sink = gas::canCompleteCircuit(g.data(), c.data(), n); }, 3));
+    ok &= sink == expect;
+    char name[64];
+    snprintf(name, sizeof(name), "canCompleteCircuitParallel(%zu)", threads);
+    report(name, bestSeconds([&] { sink = gas::canCompleteCircuitParallel(pool, g.data(), c.data(), n); }, 3));
+    ok &= sink == expect;
+
+    // 2) 很多条短环路：10 万条 × 1000 站
+    const size_t count = 100000, len = 1000;
+    vector<vector<int>> gs(count), cs(count);
+    vector<gas::Circuit> circuits;
+    vector<int> expectBatch(count);
+    for (size_t i = 0; i < count; ++i) {
+        makeCircuit(rng, len, i % 2 == 0, gs[i], cs[i]);
+        circuits.push_back({gs[i].data(), cs[i].data(), len});
+        expectBatch[i] = gas::canCompleteCircuit(gs[i].data(), cs[i].data(), len);
+    }
+    printf("批量：%zu 条环路 × %zu 站\n", count, len);
+    auto reportBatch = [&](const char* label, double t) {
+        printf("  %-30s: %8.2f ms  %6.2f M 环路/秒\n", label, t * 1e3, count / t / 1e6);
+    };
+    vector<int> got(count);
+#if !GAS_STATION_LOG
+    reportBatch("逐条 Solution", bestSeconds([&] {
+        for (size_t i = 0; i < count; ++i) got[i] = Solution().canCompleteCircuit(gs[i], cs[i]);
+    }, 3));
+    ok &= got == expectBatch;
+#endif
+    reportBatch("逐条 gas::canCompleteCircuit", bestSeconds([&] {
+        for (size_t i = 0; i < count; ++i) got[i] = gas::canCompleteCircuit(gs[i].data(), cs[i].data(), len);
+    }, 3));
+    ok &= got == expectBatch;
+    snprintf(name, sizeof(name), "canCompleteCircuitBatch(%zu)", threads);
+    reportBatch(name, bestSeconds([&] { gas::canCompleteCircuitBatch(pool, circuits, got); }, 3));
+    ok &= got == expectBatch;
+
+    cout << (ok ? "✅ 所有版本结果一致" : "❌ 结果不一致") << endl;
+    return ok ? 0 : 1;
+}
+
+// ================= 追踪开销：tracebench [M 个加油站] =================
+
+// 与 gas::canCompleteCircuit 完全相同、只是没有追踪点的对照版本
+static int canCompleteCircuitUntraced(const int* gas, const int* cost, size_t n) {
+    long long p = 0, minP = 0;
+    size_t start = 0;
+    for (size_t i = 0; i < n; ++i) {
+        p += gas[i] - cost[i];
+        if (p < minP) {
+            minP = p;
+            start = i + 1;
         }
-        cout << "\nNo valid starting station found." << endl;
-        return -1;
     }
-};
+    return n == 0 || p < 0 ? -1 : static_cast<int>(start % n);
+}
+
+static int runTraceBenchmark(size_t millions) {
+    mt19937 rng(38);
+    const size_t n = millions * 1000000;
+    vector<int> g, c;
+    makeCircuit(rng, n, true, g, c);
+    volatile int sink = 0;
+    auto report = [&](const char* name, double t) {
+        printf("  %-28s: %8.2f ms  %6.3f ns/站\n", name, t * 1e3, t * 1e9 / n);
+    };
+
+    printf("%zu M 个加油站，TRACE_COMPILED=%d\n", millions, TRACE_COMPILED);
+    trace::setEnabled(false);
+    // 通过函数指针调用：两边都是独立的函数体，不会因为内联进不同的调用点而代码布局不同。
+    // 两个版本交替测、各取最好的一次，避免 CPU 频率爬升之类的顺序效应算到某一边
+    int (*volatile untraced)(const int*, const int*, size_t) = canCompleteCircuitUntraced;
+    int (*volatile traced)(const int*, const int*, size_t) = gas::canCompleteCircuit;
+    double base = 1e100, off = 1e100;
+    for (int r = 0; r < 9; ++r) {
+        base = min(base, bestSeconds([&] { sink = untraced(g.data(), c.data(), n); }, 1));
+        off = min(off, bestSeconds([&] { sink = traced(g.data(), c.data(), n); }, 1));
+    }
+    report("无追踪点", base);
+    report("有追踪点、运行期关闭", off);
+    printf("  关闭时的相对开销: %+.2f%%\n", (off / base - 1) * 100);
+#if TRACE_COMPILED
+    // 打开后每次起点后移都写一条 32 字节记录；随机数据上后移只有几十次，
+    // 所以构造一条一路下坡的环路，让每一站都触发一次记录（最坏情况）
+    vector<int> downG(n, 0), downC(n, 1);
+    downG[n - 1] = static_cast<int>(n);
+    trace::setEnabled(true);
+    trace::clear();
+    double on = bestSeconds([&] { sink = gas::canCompleteCircuit(g.data(), c.data(), n); }, 5);
+    report("运行期打开（随机数据）", on);
+    trace::clear();
+    double worst = bestSeconds([&] { sink = gas::canCompleteCircuit(downG.data(), downC.data(), n); }, 1);
+    report("运行期打开（每站一条记录）", worst);
+    trace::setEnabled(false);
+    trace::dumpText(cout, 5);
+#else
+    // 可以用 objdump -d 对比 canCompleteCircuitUntraced 与 gas::canCompleteCircuit，除跳转地址外逐条相同；
+    // 上面两行的差别只是测量噪声（分支预测器别名、内存页位置等），交换测量顺序符号就会翻转
+    printf("  （追踪点已在编译期去掉：TRACE_EVENT 展开为空语句，两个版本生成的指令相同）\n");
+#endif
+    (void)sink;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && strcmp(argv[1], "bench") == 0) {
+        size_t millions = argc >= 3 ? strtoull(argv[2], nullptr, 10) : 100;
+        size_t threads = argc >= 4 ? strtoull(argv[3], nullptr, 10) : thread::hardware_concurrency();
+        return runBenchmark(millions ? millions : 1, threads ? threads : 1);
+    }
+    if (argc >= 2 && strcmp(argv[1], "tracebench") == 0) {
+        size_t millions = argc >= 3 ? strtoull(argv[2], nullptr, 10) : 100;
+        return runTraceBenchmark(millions ? millions : 1);
+    }
 
-int main() {
     Solution s = Solution();
     std::vector<int> gas = {5,1,2,3,4};
     std::vector<int> cost = {4,4,1,5,1};
@@ -74,4 +208,4 @@ int main() {
     }
     
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+// LeetCode 134（加油站）的各个解法，134.cpp 和 2026_0227/leetcode/bench_leetcode.cpp 共用：
+//   lc134::Solution                          提交版（带逐步日志）
+//   lc134::gas::canCompleteCircuit*          O(n) 单遍 / 并行前缀和 / 批量
+//   lc134::bruteForceStart, makeCircuit      小规模校验用的暴力解、随机输入
+
+#include<iostream>
+#include<vector>
+#include<chrono>
+#include<random>
+#include<limits>
+#include<thread>
+#include<cstring>
+#include<cstdlib>
+#include<cstdio>
+#include "../common/work_stealing_pool.h"
+#include "../common/trace_ring.h"
+
+// GAS_STATION_LOG=0 时 Solution 里的日志在编译期整段去掉（不是运行时判断），基准测的才是算法本身
+#ifndef GAS_STATION_LOG
+#define GAS_STATION_LOG 1
+#endif
+
+#if GAS_STATION_LOG
+#define GAS_LOG(expr) do { std::cout << expr; } while (0)
+#else
+#define GAS_LOG(expr) do { } while (0)
+#endif
+
+namespace lc134 {
+
+class Solution {
+public:
+    int canCompleteCircuit(std::vector<int>& gas, std::vector<int>& cost) {
+        int n = gas.size();
+        int i = 0;
+        GAS_LOG("\n=== Starting Gas Station Circuit Analysis ===" << std::endl);
+        GAS_LOG("Total stations: " << n << std::endl);
+        
+        while(i < n) {
+            GAS_LOG("\n--- Trying to start from station " << i << " ---" << std::endl);
+            int sumOfGas = 0;
+            int sumOfCost = 0;
+            int cnt = 0;
+            
+            while(cnt < n) {
+                int j = (i + cnt) % n;
+                sumOfGas += gas[j];
+                sumOfCost += cost[j];
+                
+                GAS_LOG("Step " << cnt + 1 << ": At station " << j 
+                     << " -> Gas: +" << gas[j] << " (total: " << sumOfGas 
+                     << "), Cost: +" << cost[j] << " (total: " << sumOfCost << ")");
+                
+                if (sumOfCost > sumOfGas) {
+                    GAS_LOG(" -> FAILED! Not enough gas." << std::endl);
+                    break;
+                } else {
+                    GAS_LOG(" -> OK, remaining gas: " << (sumOfGas - sumOfCost) << std::endl);
+                }
+                cnt++;
+            }
+            
+            TRACE_EVENT("gas.solution.attempt", i, cnt);
+            if (cnt == n) {
+                GAS_LOG("SUCCESS! Completed full circuit from station " << i << std::endl);
+                return i;
+            } else {
+                GAS_LOG("Failed at step " << cnt + 1 << ", skipping to station " << (i + cnt + 1) << std::endl);
+                i = i + cnt + 1;
+            }
+        }
+        GAS_LOG("\nNo valid starting station found." << std::endl);
+        return -1;
+    }
+};
+
+// ================= 安静的 O(n) 单遍解法 + 并行前缀和 + 批量 =================
+// 设 d[i] = gas[i] - cost[i]，P[i] = d[0] + ... + d[i]。
+//   - 总和 P[n-1] < 0 时无解
+//   - 否则从 s 出发可行 ⇔ P[s-1] 是所有前缀和（含出发前的 0）里的最小值；第一个最小值位置 + 1 就是答案，
+//     与 Solution 的“失败就跳到下一站”得到的是同一个（最小的可行起点）
+// 这样问题变成“求总和 + 前缀最小值及其第一次出现的位置”，它是可结合的归约：
+// 每块算出 (块和, 块内前缀最小值, 位置)，按顺序合并时右块的最小值加上左块的和再比较，可以多核分块并行。
+// 累加用 64 位，1 亿个站的总和也不会溢出（Solution 用 int，只适合题目的规模）
+
+namespace gas {
+
+// 一段连续加油站的摘要
+struct Segment {
+    long long sum = 0;
+    long long minPrefix = std::numeric_limits<long long>::max();  // 空段：没有前缀
+    size_t argmin = 0;                                             // 第一次取到 minPrefix 的全局下标
+};
+
+inline Segment summarize(const int* gas, const int* cost, size_t lo, size_t hi) {
+    TRACE_EVENT("gas.block", lo, hi);
+    Segment s;
+    long long p = 0;
+    for (size_t i = lo; i < hi; ++i) {
+        p += gas[i] - cost[i];
+        if (p < s.minPrefix) {
+            s.minPrefix = p;
+            s.argmin = i;
+        }
+    }
+    s.sum = p;
+    return s;
+}
+
+// 左段 a 在前、右段 b 在后；相等时保留左边的位置（第一次出现）
+inline Segment combine(const Segment& a, const Segment& b) {
+    Segment r = a;
+    r.sum = a.sum + b.sum;
+    if (b.minPrefix != std::numeric_limits<long long>::max() && a.sum + b.minPrefix < a.minPrefix) {
+        r.minPrefix = a.sum + b.minPrefix;
+        r.argmin = b.argmin;
+    }
+    return r;
+}
+
+inline int startFrom(const Segment& all, size_t n) {
+    if (n == 0 || all.sum < 0) return -1;
+    return all.minPrefix < 0 ? static_cast<int>((all.argmin + 1) % n) : 0;
+}
+
+// 单遍、无输出：油箱见底就把起点挪到下一站
+inline int canCompleteCircuit(const int* gas, const int* cost, size_t n) {
+    long long p = 0, minP = 0;
+    size_t start = 0;
+    for (size_t i = 0; i < n; ++i) {
+        p += gas[i] - cost[i];
+        if (p < minP) {
+            minP = p;
+            start = i + 1;
+            TRACE_EVENT("gas.reset", start, p);
+        }
+    }
+    return n == 0 || p < 0 ? -1 : static_cast<int>(start % n);
+}
+
+// 多核版：按 grain 固定分块归约，结果与线程数无关
+inline int canCompleteCircuitParallel(ws::WorkStealingPool& pool, const int* gas, const int* cost, size_t n,
+                                      size_t grain = 1 << 20) {
+    Segment all = ws::parallel_reduce(
+        pool, 0, n, grain, Segment{}, [&](size_t lo, size_t hi) { return summarize(gas, cost, lo, hi); },
+        combine);
+    return startFrom(all, n);
+}
+
+struct Circuit {
+    const int* gas;
+    const int* cost;
+    size_t n;
+};
+
+// 批量：很多条互不相关的环路，按环路分给各个线程，每条环路内部用单遍解法
+inline void canCompleteCircuitBatch(ws::WorkStealingPool& pool, const std::vector<Circuit>& circuits,
+                                    std::vector<int>& out) {
+    out.resize(circuits.size());
+    ws::parallel_for(pool, 0, circuits.size(), 64, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) out[i] = canCompleteCircuit(circuits[i].gas, circuits[i].cost, circuits[i].n);
+    });
+}
+
+}  // namespace gas
+
+// ================= 校验与测试输入 =================
+
+// 逐个起点暴力尝试，返回最小的可行起点：只用于小规模校验
+inline int bruteForceStart(const std::vector<int>& gas, const std::vector<int>& cost) {
+    size_t n = gas.size();
+    for (size_t s = 0; s < n; ++s) {
+        long long tank = 0;
+        size_t k = 0;
+        for (; k < n; ++k) {
+            tank += gas[(s + k) % n] - cost[(s + k) % n];
+            if (tank < 0) break;
+        }
+        if (k == n) return static_cast<int>(s);
+    }
+    return -1;
+}
+
+// gas、cost 取 [0, 15]，总和 7.5e8 左右，Solution 的 int 累加也不会溢出；
+// solvable 时把缺口补在随机一站上，保证有解
+inline void makeCircuit(std::mt19937& rng, size_t n, bool solvable, std::vector<int>& gas, std::vector<int>& cost) {
+    gas.resize(n);
+    cost.resize(n);
+    long long total = 0;
+    for (size_t i = 0; i < n; ++i) {
+        gas[i] = static_cast<int>(rng() % 16);
+        cost[i] = static_cast<int>(rng() % 16);
+        total += gas[i] - cost[i];
+    }
+    if (solvable && total < 0) gas[rng() % n] += static_cast<int>(-total);
+}
+
+}  // namespace lc134
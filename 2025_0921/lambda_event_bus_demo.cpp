@@ -0,0 +1,295 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <functional>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace std;
+
+// 对应 lambda_expressions_demo.cpp 里 7.1 的 eventHandler：直接以 ("click", "button1") 调用回调。
+// 这里把它扩展成一个高吞吐事件总线：
+//   - 事件类型“驻留”（intern）：注册时把字符串映射成一个小整数 id，之后发布/分发只用 id
+//   - 每个类型一个订阅者数组：dispatch 时 subscribers_[id] 直接下标访问，没有任何 map 查找
+//   - 批量分发：消费线程一次从队列里取出最多 kBatch 个事件再逐个分发，摊薄队列同步开销
+//   - 跨线程发布：多生产者单消费者（MPSC）无锁有界环形队列
+//
+// 编译运行：
+//   g++ -O2 -std=c++17 -pthread lambda_event_bus_demo.cpp -o lambda_event_bus
+//   ./lambda_event_bus           # 默认 4 个生产者线程
+//   ./lambda_event_bus 2
+
+// ================= 1. 事件与类型驻留 =================
+
+using EventTypeId = uint32_t;
+
+// 事件本身保持小而平坦（可平凡拷贝），才能在队列里按值传递而不分配内存
+struct Event {
+    EventTypeId type;
+    uint32_t source;        // 发布者编号
+    uint64_t payload;       // 业务数据（例如按钮 id / 键码）
+    uint64_t publishNs;     // 发布时刻，用于统计分发延迟
+    const char* text;       // 可选：指向静态字符串的附加信息
+};
+
+class EventTypeRegistry {
+public:
+    // 只在初始化阶段调用：字符串 → id
+    EventTypeId intern(const string& name) {
+        auto it = ids_.find(name);
+        if (it != ids_.end()) return it->second;
+        EventTypeId id = static_cast<EventTypeId>(names_.size());
+        ids_.emplace(name, id);
+        names_.push_back(name);
+        return id;
+    }
+
+    const string& name(EventTypeId id) const { return names_.at(id); }
+    size_t size() const { return names_.size(); }
+
+private:
+    unordered_map<string, EventTypeId> ids_;
+    vector<string> names_;
+};
+
+// ================= 2. MPSC 无锁有界队列 =================
+
+// Dmitry Vyukov 的有界队列：每个槽位带一个序号，生产者用 CAS 抢 tail，
+// 只有一个消费者，所以 head 不需要 CAS
+template <class T>
+class MpscRingQueue {
+public:
+    explicit MpscRingQueue(size_t capacityPow2) : mask_(capacityPow2 - 1), slots_(capacityPow2) {
+        if (capacityPow2 == 0 || (capacityPow2 & mask_) != 0) {
+            throw invalid_argument("MpscRingQueue 容量必须是 2 的幂");
+        }
+        for (size_t i = 0; i < capacityPow2; ++i) slots_[i].seq.store(i, memory_order_relaxed);
+    }
+
+    // 任意线程调用；队列满时返回 false
+    bool tryPush(const T& v) {
+        size_t pos = tail_.load(memory_order_relaxed);
+        while (true) {
+            Slot& s = slots_[pos & mask_];
+            size_t seq = s.seq.load(memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    s.value = v;
+                    s.seq.store(pos + 1, memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // 满
+            } else {
+                pos = tail_.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    // 仅消费者线程调用：最多取 maxCount 个，返回实际个数
+    size_t popBatch(T* out, size_t maxCount) {
+        size_t n = 0;
+        while (n < maxCount) {
+            Slot& s = slots_[head_ & mask_];
+            size_t seq = s.seq.load(memory_order_acquire);
+            if (seq != head_ + 1) break;  // 还没写好（或空）
+            out[n++] = s.value;
+            s.seq.store(head_ + mask_ + 1, memory_order_release);
+            ++head_;
+        }
+        return n;
+    }
+
+private:
+    struct alignas(64) Slot {
+        atomic<size_t> seq;
+        T value;
+    };
+
+    const size_t mask_;
+    vector<Slot> slots_;
+    alignas(64) atomic<size_t> tail_{0};
+    alignas(64) size_t head_ = 0;
+};
+
+// ================= 3. 事件总线 =================
+
+class EventBus {
+public:
+    using Handler = function<void(const Event&)>;
+    static constexpr size_t kBatch = 256;
+
+    explicit EventBus(size_t queueCapacity = 1 << 16) : queue_(queueCapacity) {}
+
+    EventTypeId registerType(const string& name) {
+        EventTypeId id = registry_.intern(name);
+        if (subscribers_.size() <= id) subscribers_.resize(id + 1);
+        return id;
+    }
+
+    // 订阅在初始化阶段完成；分发期间不支持增删订阅者（省掉分发路径上的同步）
+    void subscribe(EventTypeId type, Handler h) { subscribers_.at(type).push_back(std::move(h)); }
+
+    const string& typeName(EventTypeId id) const { return registry_.name(id); }
+
+    // 同线程立即分发：下标 → 订阅者数组 → 逐个调用
+    void dispatch(const Event& e) const {
+        for (const Handler& h : subscribers_[e.type]) h(e);
+    }
+
+    void dispatchBatch(const Event* events, size_t n) const {
+        for (size_t i = 0; i < n; ++i) dispatch(events[i]);
+    }
+
+    // 跨线程发布：进队列，由 drain() 所在的消费线程分发；队列满时让出 CPU 重试
+    void publish(const Event& e) {
+        while (!queue_.tryPush(e)) this_thread::yield();
+    }
+
+    // 消费线程调用：取一批、分发一批，返回本次分发的事件数
+    size_t drain() {
+        Event batch[kBatch];
+        size_t n = queue_.popBatch(batch, kBatch);
+        dispatchBatch(batch, n);
+        return n;
+    }
+
+private:
+    EventTypeRegistry registry_;
+    vector<vector<Handler>> subscribers_;
+    MpscRingQueue<Event> queue_;
+};
+
+// ================= 4. 演示：eventHandler 接入总线 =================
+
+void eventBusDemo() {
+    cout << "=== 📮 事件总线演示 ===" << endl;
+
+    EventBus bus;
+    EventTypeId click = bus.registerType("click");
+    EventTypeId keypress = bus.registerType("keypress");
+
+    auto eventHandler = [&bus](const Event& e) {
+        cout << "处理事件: " << bus.typeName(e.type) << ", 数据: " << e.text << endl;
+    };
+    bus.subscribe(click, eventHandler);
+    bus.subscribe(keypress, eventHandler);
+
+    int clickCount = 0;
+    bus.subscribe(click, [&clickCount](const Event&) { ++clickCount; });
+
+    bus.dispatch({click, 0, 1, 0, "button1"});
+    bus.dispatch({keypress, 0, 13, 0, "Enter"});
+
+    // 跨线程发布，由当前线程批量分发
+    thread producer([&] {
+        bus.publish({click, 1, 2, 0, "button2"});
+        bus.publish({click, 1, 3, 0, "button3"});
+    });
+    producer.join();
+    while (bus.drain() > 0) {
+    }
+    cout << "click 订阅者计数: " << clickCount << endl;
+}
+
+// ================= 5. 基准：吞吐与分发延迟 =================
+
+inline uint64_t nowNs() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void eventBusBenchmark(int producers) {
+    cout << "\n=== ⏱️ 事件总线基准 ===" << endl;
+
+    const int typeCount = 64;
+    EventBus bus(1 << 16);
+    vector<EventTypeId> types;
+    for (int i = 0; i < typeCount; ++i) types.push_back(bus.registerType("event_" + to_string(i)));
+
+    // 每个类型两个订阅者：一个累加 payload，一个（可选）记录延迟
+    uint64_t checksum = 0;
+    vector<uint32_t> latencies;
+    bool recordLatency = false;
+    for (EventTypeId t : types) {
+        bus.subscribe(t, [&checksum](const Event& e) { checksum += e.payload; });
+        bus.subscribe(t, [&](const Event& e) {
+            if (recordLatency) latencies.push_back(static_cast<uint32_t>(nowNs() - e.publishNs));
+        });
+    }
+
+    // 5.1 同线程直接分发（批量）
+    {
+        const size_t n = 10000000;
+        vector<Event> events(1024);
+        for (size_t i = 0; i < events.size(); ++i) {
+            events[i] = {types[i % typeCount], 0, i, 0, nullptr};
+        }
+        auto t0 = chrono::steady_clock::now();
+        for (size_t done = 0; done < n; done += events.size()) {
+            bus.dispatchBatch(events.data(), events.size());
+        }
+        double sec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        printf("同线程批量分发: %.2f M 事件/秒\n", n / sec / 1e6);
+    }
+
+    // 5.2 多生产者跨线程发布 + 单消费者批量分发
+    //     生产者满速发布，测到的延迟包含在队列里排队的时间（饱和负载下的上界）
+    {
+        const size_t perProducer = 2000000;
+        const size_t total = perProducer * producers;
+        latencies.clear();
+        latencies.reserve(total);
+        recordLatency = true;
+        checksum = 0;
+
+        atomic<bool> go{false};
+        vector<thread> ts;
+        for (int p = 0; p < producers; ++p) {
+            ts.emplace_back([&, p] {
+                while (!go.load(memory_order_acquire)) this_thread::yield();
+                for (size_t i = 0; i < perProducer; ++i) {
+                    bus.publish({types[(i + p) % typeCount], static_cast<uint32_t>(p), 1, nowNs(), nullptr});
+                }
+            });
+        }
+
+        auto t0 = chrono::steady_clock::now();
+        go.store(true, memory_order_release);
+        size_t dispatched = 0;
+        while (dispatched < total) {
+            size_t n = bus.drain();
+            if (n == 0) this_thread::yield();
+            dispatched += n;
+        }
+        double sec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        for (auto& t : ts) t.join();
+        recordLatency = false;
+
+        sort(latencies.begin(), latencies.end());
+        auto pct = [&](double p) { return latencies[static_cast<size_t>(p * (latencies.size() - 1))] / 1e3; };
+        printf("%d 生产者 → 1 消费者: %.2f M 事件/秒, 延迟 p50=%.2f us, p99=%.2f us, p99.9=%.2f us\n",
+               producers, total / sec / 1e6, pct(0.50), pct(0.99), pct(0.999));
+        cout << (checksum == total ? "✅ 事件无丢失" : "❌ 事件丢失") << endl;
+    }
+}
+
+// ================= 主函数 =================
+
+int main(int argc, char** argv) {
+    int producers = 4;
+    if (argc >= 2) producers = max(1, atoi(argv[1]));
+
+    eventBusDemo();
+    eventBusBenchmark(producers);
+    return 0;
+}
@@ -324,7 +324,7 @@ void practicalLambdaApplications() {
     eventHandler("click", "button1");
     eventHandler("keypress", "Enter");
     
-    // 7.2 数据过滤和处理管道
+    // 7.2 数据过滤和处理管道（无中间 vector 的惰性融合版本见 lambda_pipeline_demo.cpp）
     cout << "\n2️⃣ 数据处理管道：" << endl;
     vector<int> data = {1, -2, 3, -4, 5, -6, 7, -8, 9, -10};
     
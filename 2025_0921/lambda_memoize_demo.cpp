@@ -0,0 +1,325 @@
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <tuple>
+#include <functional>
+#include <shared_mutex>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <type_traits>
+#include <utility>
+
+using namespace std;
+
+// 对应 lambda_expressions_demo.cpp 里 7.4 的 lazyCalculation：
+//   返回的闭包每次调用都重新计算 x*x + y*y。
+// 这里实现一个通用的记忆化包装器 memoize(f)，适用于“纯函数” lambda（相同参数 → 相同结果、无副作用）：
+//   - 以参数元组为 key，缓存容量有上限
+//   - 分片（shard）：key 的哈希决定落在哪个分片，每个分片一把读写锁，多线程下互不干扰
+//   - CLOCK 淘汰（近似 LRU）：命中时只把引用位置 1，读路径只需共享锁；
+//     真正的 LRU 每次命中都要移动链表节点，必须拿独占锁，并发读会被串行化
+//   - 命中/未命中/淘汰计数
+//
+// 编译运行：
+//   g++ -O2 -std=c++17 -pthread lambda_memoize_demo.cpp -o lambda_memoize
+//   ./lambda_memoize
+
+// ================= 1. 工具：从 lambda 推导参数/返回类型、元组哈希 =================
+
+template <class T>
+struct callable_traits : callable_traits<decltype(&T::operator())> {};
+
+template <class C, class R, class... Args>
+struct callable_traits<R (C::*)(Args...) const> {
+    using result_type = R;
+    using key_type = tuple<decay_t<Args>...>;
+};
+
+template <class C, class R, class... Args>
+struct callable_traits<R (C::*)(Args...)> : callable_traits<R (C::*)(Args...) const> {};
+
+template <class R, class... Args>
+struct callable_traits<R (*)(Args...)> {
+    using result_type = R;
+    using key_type = tuple<decay_t<Args>...>;
+};
+
+struct TupleHash {
+    template <class... Ts>
+    size_t operator()(const tuple<Ts...>& t) const {
+        size_t h = 0x9E3779B97F4A7C15ull;
+        apply([&h](const auto&... xs) {
+            // boost::hash_combine 的做法
+            ((h ^= hash<decay_t<decltype(xs)>>{}(xs) + 0x9E3779B9 + (h << 6) + (h >> 2)), ...);
+        }, t);
+        // 再混一次，避免 std::hash<int> 是恒等映射导致分片分布不均
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        return h;
+    }
+};
+
+// ================= 2. 分片 CLOCK 缓存 =================
+
+template <class Key, class Value>
+class ShardedClockCache {
+public:
+    ShardedClockCache(size_t capacity, size_t shardCount) {
+        if (shardCount == 0) shardCount = 1;
+        size_t perShard = max<size_t>(1, (capacity + shardCount - 1) / shardCount);
+        for (size_t i = 0; i < shardCount; ++i) {
+            shards_.push_back(make_unique<Shard>(perShard));
+        }
+    }
+
+    bool get(const Key& key, Value& out) {
+        Shard& s = shardFor(key);
+        shared_lock<shared_mutex> lk(s.mtx);
+        auto it = s.index.find(key);
+        if (it == s.index.end()) {
+            s.misses.fetch_add(1, memory_order_relaxed);
+            return false;
+        }
+        Slot& slot = s.slots[it->second];
+        slot.referenced.store(true, memory_order_relaxed);  // 共享锁下只改原子引用位
+        out = slot.value;
+        s.hits.fetch_add(1, memory_order_relaxed);
+        return true;
+    }
+
+    void put(const Key& key, const Value& value) {
+        Shard& s = shardFor(key);
+        unique_lock<shared_mutex> lk(s.mtx);
+        if (s.index.count(key)) return;  // 其它线程已经算好并放进来了
+
+        size_t victim;
+        if (s.used < s.slots.size()) {
+            victim = s.used++;
+        } else {
+            // CLOCK：指针转一圈，跳过（并清掉）引用位为 1 的槽，遇到 0 就淘汰
+            while (true) {
+                Slot& slot = s.slots[s.hand];
+                size_t cur = s.hand;
+                s.hand = (s.hand + 1) % s.slots.size();
+                if (slot.referenced.exchange(false, memory_order_relaxed)) continue;
+                victim = cur;
+                break;
+            }
+            s.index.erase(s.slots[victim].key);
+            s.evictions.fetch_add(1, memory_order_relaxed);
+        }
+        Slot& slot = s.slots[victim];
+        slot.key = key;
+        slot.value = value;
+        slot.referenced.store(false, memory_order_relaxed);
+        s.index.emplace(key, victim);
+    }
+
+    struct Stats {
+        uint64_t hits = 0, misses = 0, evictions = 0;
+        double hitRate() const { return hits + misses ? double(hits) / (hits + misses) : 0.0; }
+    };
+
+    Stats stats() const {
+        Stats st;
+        for (auto& s : shards_) {
+            st.hits += s->hits.load(memory_order_relaxed);
+            st.misses += s->misses.load(memory_order_relaxed);
+            st.evictions += s->evictions.load(memory_order_relaxed);
+        }
+        return st;
+    }
+
+private:
+    struct Slot {
+        Key key{};
+        Value value{};
+        atomic<bool> referenced{false};
+    };
+
+    // 每个分片独占缓存行，避免不同分片的锁/计数器伪共享
+    struct alignas(64) Shard {
+        explicit Shard(size_t cap) : slots(cap) { index.reserve(cap * 2); }
+        shared_mutex mtx;
+        unordered_map<Key, size_t, TupleHash> index;
+        vector<Slot> slots;
+        size_t used = 0;
+        size_t hand = 0;
+        atomic<uint64_t> hits{0};
+        atomic<uint64_t> misses{0};
+        atomic<uint64_t> evictions{0};
+    };
+
+    Shard& shardFor(const Key& key) {
+        return *shards_[TupleHash{}(key) % shards_.size()];
+    }
+
+    vector<unique_ptr<Shard>> shards_;
+};
+
+// ================= 3. memoize 包装器 =================
+
+template <class F>
+class Memoized {
+    using traits = callable_traits<F>;
+
+public:
+    using result_type = decay_t<typename traits::result_type>;
+    using key_type = typename traits::key_type;
+
+    Memoized(F fn, size_t capacity, size_t shards)
+        : fn_(std::move(fn)), cache_(make_shared<ShardedClockCache<key_type, result_type>>(capacity, shards)) {}
+
+    template <class... Args>
+    result_type operator()(Args&&... args) const {
+        key_type key(args...);
+        result_type value;
+        if (cache_->get(key, value)) return value;
+        // 未命中：在锁外计算。两个线程可能同时算同一个 key，对纯函数来说只是浪费一点算力
+        value = fn_(std::forward<Args>(args)...);
+        cache_->put(key, value);
+        return value;
+    }
+
+    typename ShardedClockCache<key_type, result_type>::Stats stats() const { return cache_->stats(); }
+
+private:
+    F fn_;
+    // 共享所有权：Memoized 被按值捕获/拷贝后，各副本仍使用同一份缓存
+    shared_ptr<ShardedClockCache<key_type, result_type>> cache_;
+};
+
+template <class F>
+Memoized<decay_t<F>> memoize(F&& fn, size_t capacity = 4096, size_t shards = 16) {
+    return Memoized<decay_t<F>>(std::forward<F>(fn), capacity, shards);
+}
+
+// ================= 4. 演示：记忆化的 lazyCalculation =================
+
+void memoizeDemo() {
+    cout << "=== 🧠 记忆化延迟计算 ===" << endl;
+
+    auto lazyCalculation = [](bool shouldCalculate) {
+        return [shouldCalculate](int x, int y) {
+            if (shouldCalculate) {
+                cout << "执行复杂计算..." << endl;
+                return x * x + y * y;
+            }
+            return 0;
+        };
+    };
+
+    // 注意：闭包里的打印只是为了看清是否真的执行了计算；真正使用时被包装的函数应当无副作用
+    auto calc = memoize(lazyCalculation(true), /*capacity=*/128, /*shards=*/4);
+    int r1 = calc(3, 4);  // 未命中，执行计算
+    cout << "calc(3, 4) = " << r1 << endl;
+    int r2 = calc(3, 4);  // 命中，不再打印“执行复杂计算...”
+    cout << "calc(3, 4) = " << r2 << endl;
+    int r3 = calc(5, 12);
+    cout << "calc(5, 12) = " << r3 << endl;
+
+    auto st = calc.stats();
+    cout << "命中 " << st.hits << " 次，未命中 " << st.misses << " 次" << endl;
+}
+
+// ================= 5. 多线程基准 =================
+
+// 模拟一个昂贵的纯函数（约几微秒）
+double expensive(int x, int y) {
+    double acc = 0;
+    for (int i = 1; i <= 200; ++i) acc += sin(x * 0.001 * i) * cos(y * 0.002 * i) / i;
+    return acc;
+}
+
+void memoizeBenchmark() {
+    cout << "\n=== ⏱️ 重复参数负载下的记忆化收益 ===" << endl;
+
+    const size_t opsPerThread = 200000;
+    const int keySpace = 20000;     // 不同参数组合数
+    const size_t capacity = 8192;   // 缓存容量 < keySpace，会触发淘汰
+
+    // 预生成 Zipf 分布的参数：少数热点参数被反复调用
+    vector<double> cdf(keySpace);
+    double norm = 0;
+    for (int k = 0; k < keySpace; ++k) norm += 1.0 / pow(k + 1, 1.1);
+    double run = 0;
+    for (int k = 0; k < keySpace; ++k) {
+        run += 1.0 / pow(k + 1, 1.1) / norm;
+        cdf[k] = run;
+    }
+    auto sampleKeys = [&](unsigned seed) {
+        mt19937 rng(seed);
+        uniform_real_distribution<double> u(0, 1);
+        vector<int> keys(opsPerThread);
+        for (auto& k : keys) k = int(lower_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin());
+        return keys;
+    };
+
+    printf("%-8s %14s %14s %10s %10s\n", "threads", "无缓存 ops/s", "记忆化 ops/s", "命中率", "加速比");
+    for (int threads : {1, 2, 4, 8}) {
+        vector<vector<int>> keys;
+        for (int t = 0; t < threads; ++t) keys.push_back(sampleKeys(1234 + t));
+
+        // 返回吞吐和每个线程的累加和（各线程按固定顺序累加，同样的 key 序列结果逐位相同）
+        auto runWith = [&](auto&& fn) {
+            vector<double> sums(threads, 0.0);
+            auto t0 = chrono::steady_clock::now();
+            vector<thread> ts;
+            for (int t = 0; t < threads; ++t) {
+                ts.emplace_back([&, t] {
+                    double local = 0;
+                    for (int k : keys[t]) local += fn(k % 200, k / 200);
+                    sums[t] = local;
+                });
+            }
+            for (auto& th : ts) th.join();
+            double sec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+            size_t ops = 0;
+            for (auto& k : keys) ops += k.size();
+            return make_pair(ops / sec, std::move(sums));
+        };
+
+        // 无缓存的基线只跑 1/10 的量，按比例换算吞吐
+        auto plainFn = [](int x, int y) { return expensive(x, y); };
+        auto memoFn = memoize(plainFn, capacity, 64);
+        auto memoOps = runWith(memoFn).first;
+        auto st = memoFn.stats();
+
+        for (auto& k : keys) k.resize(k.size() / 10);
+        auto [plainOps, plainSums] = runWith(plainFn);
+        // 校验：同样的 key 序列再用（已经热起来的）缓存跑一遍，结果必须和直接计算逐位相同
+        auto memoSums = runWith(memoFn).second;
+        for (int t = 0; t < threads; ++t) {
+            if (memoSums[t] != plainSums[t]) {
+                printf("❌ 记忆化结果与直接计算不一致：threads=%d 线程 %d memo=%.17g plain=%.17g\n", threads, t,
+                       memoSums[t], plainSums[t]);
+                exit(1);
+            }
+        }
+
+        printf("%-8d %14.0f %14.0f %9.1f%% %9.1fx\n", threads, plainOps, memoOps, st.hitRate() * 100,
+               memoOps / plainOps);
+    }
+    cout << "✅ 各线程的记忆化结果与直接计算逐位一致" << endl;
+}
+
+// ================= 主函数 =================
+
+int main() {
+    memoizeDemo();
+    memoizeBenchmark();
+
+    cout << "\n📚 要点：" << endl;
+    cout << "- 只对纯函数做记忆化：有副作用的闭包命中后副作用就不再发生" << endl;
+    cout << "- 分片 + 读写锁：不同 key 落在不同分片，命中路径只拿共享锁" << endl;
+    cout << "- CLOCK 用一个引用位近似 LRU，命中时不需要改链表" << endl;
+    return 0;
+}
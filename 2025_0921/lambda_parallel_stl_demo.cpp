@@ -0,0 +1,245 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <iterator>
+#include <cstdlib>
+#include <cstdio>
+
+#include "../common/work_stealing_pool.h"
+
+using namespace std;
+
+// 对应 lambda_expressions_demo.cpp 里的 lambdaWithSTL()：
+//   find_if / count_if / transform / for_each / accumulate 都是串行执行的。
+// 这里实现一个“分块 + 工作窃取”的并行执行器，让同样的 lambda 跑在多个核上：
+//   - 数据按固定大小切块（chunk），块由 work_stealing_pool.h 的 parallel_for 调度
+//   - 每个工作线程有自己的双端队列：自己从尾部取（LIFO，缓存友好），空闲时从别人头部偷（FIFO）
+//   - accumulate：块大小只由数据量决定、与线程数无关，部分和按块序合并 → 任意线程数结果逐位一致
+//   - find_if：找到后用原子量记录最小下标，位置更靠后的块直接跳过/中途退出
+//
+// 编译运行：
+//   g++ -O3 -std=c++17 -pthread lambda_parallel_stl_demo.cpp -o lambda_parallel_stl
+//   ./lambda_parallel_stl            # 默认 10M 个 int，线程数 1..64
+//   ./lambda_parallel_stl 50000000
+
+// ================= 1. 并行版 STL 算法 =================
+
+class ParallelExecutor {
+public:
+    // grain：每块的元素个数。块划分与线程数无关，这是 accumulate 结果确定性的前提
+    // threads 个工作线程；调用方在等待期间也会帮忙执行块
+    explicit ParallelExecutor(size_t threads, size_t grain = 1 << 16)
+        : pool_(threads), grain_(grain) {}
+
+    size_t threads() const { return pool_.size(); }
+
+    template <class It, class Pred>
+    It find_if(It first, It last, Pred pred) {
+        const size_t n = distance(first, last);
+        atomic<size_t> found{n};
+        runChunks(chunkCount(n), [&](size_t c) {
+            size_t begin = c * grain_;
+            size_t end = min(n, begin + grain_);
+            // 更靠前的块已经找到了：本块的结果不可能是“第一个”，直接跳过
+            if (begin >= found.load(memory_order_relaxed)) return;
+            for (size_t i = begin; i < end; ++i) {
+                // 每 1024 个元素检查一次取消标志，避免每次迭代都读原子量
+                if ((i & 1023) == 0 && i >= found.load(memory_order_relaxed)) return;
+                if (pred(first[i])) {
+                    size_t cur = found.load(memory_order_relaxed);
+                    while (i < cur && !found.compare_exchange_weak(cur, i, memory_order_relaxed)) {
+                    }
+                    return;
+                }
+            }
+        });
+        return first + found.load();
+    }
+
+    template <class It, class Pred>
+    size_t count_if(It first, It last, Pred pred) {
+        const size_t n = distance(first, last);
+        vector<size_t> partial(chunkCount(n), 0);
+        runChunks(partial.size(), [&](size_t c) {
+            size_t cnt = 0;
+            for (size_t i = c * grain_, end = min(n, i + grain_); i < end; ++i) {
+                if (pred(first[i])) ++cnt;
+            }
+            partial[c] = cnt;
+        });
+        return std::accumulate(partial.begin(), partial.end(), size_t{0});
+    }
+
+    // 输出必须是随机访问迭代器（预先分配好空间），不能用 back_inserter
+    template <class It, class Out, class Fn>
+    Out transform(It first, It last, Out out, Fn fn) {
+        const size_t n = distance(first, last);
+        runChunks(chunkCount(n), [&](size_t c) {
+            for (size_t i = c * grain_, end = min(n, i + grain_); i < end; ++i) {
+                out[i] = fn(first[i]);
+            }
+        });
+        return out + n;
+    }
+
+    // 注意：各块之间的执行顺序不确定，fn 不应依赖遍历顺序（例如打印）
+    template <class It, class Fn>
+    void for_each(It first, It last, Fn fn) {
+        const size_t n = distance(first, last);
+        runChunks(chunkCount(n), [&](size_t c) {
+            for (size_t i = c * grain_, end = min(n, i + grain_); i < end; ++i) {
+                fn(first[i]);
+            }
+        });
+    }
+
+    // 与 std::accumulate(first, last, init, op) 不同，并行版需要把 op 拆成两部分：
+    //   op(acc, x)      块内累积，每块从 T{} 开始
+    //   combine(a, b)   把各块部分和按块序合并到 init 上
+    template <class It, class T, class Op, class Combine>
+    T accumulate(It first, It last, T init, Op op, Combine combine) {
+        const size_t n = distance(first, last);
+        vector<T> partial(chunkCount(n), T{});
+        runChunks(partial.size(), [&](size_t c) {
+            T acc{};
+            for (size_t i = c * grain_, end = min(n, i + grain_); i < end; ++i) {
+                acc = op(acc, first[i]);
+            }
+            partial[c] = acc;
+        });
+        for (const T& p : partial) init = combine(init, p);
+        return init;
+    }
+
+private:
+    size_t chunkCount(size_t n) const { return (n + grain_ - 1) / grain_; }
+
+    // 把 [0, chunkCount) 个块交给线程池，阻塞直到全部完成
+    template <class Body>
+    void runChunks(size_t chunkCount, const Body& body) {
+        ws::parallel_for(pool_, 0, chunkCount, 1, [&](size_t c0, size_t c1) {
+            for (size_t c = c0; c < c1; ++c) body(c);
+        });
+    }
+
+    ws::WorkStealingPool pool_;
+    size_t grain_;
+};
+
+// ================= 2. 与 lambdaWithSTL() 相同的调用 =================
+
+void parallelLambdaDemo() {
+    cout << "=== 🧵 并行执行器 + Lambda ===" << endl;
+
+    vector<int> numbers = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    ParallelExecutor ex(4, /*grain=*/2);  // 小数据演示用很小的块，方便看到多块并行
+
+    auto it = ex.find_if(numbers.begin(), numbers.end(), [](int n) {
+        return n % 2 == 0;
+    });
+    cout << "第一个偶数: " << (it != numbers.end() ? *it : -1) << endl;
+
+    auto evenCount = ex.count_if(numbers.begin(), numbers.end(), [](int n) {
+        return n % 2 == 0;
+    });
+    cout << "偶数个数: " << evenCount << endl;
+
+    vector<int> squares(numbers.size());
+    ex.transform(numbers.begin(), numbers.end(), squares.begin(), [](int n) {
+        return n * n;
+    });
+    cout << "平方数: ";
+    for (int n : squares) cout << n << " ";
+    cout << endl;
+
+    vector<int> copy = numbers;
+    ex.for_each(copy.begin(), copy.end(), [](int& n) { n *= 10; });
+    cout << "for_each 原地乘10: ";
+    for (int n : copy) cout << n << " ";
+    cout << endl;
+
+    auto sum = ex.accumulate(numbers.begin(), numbers.end(), 0,
+                             [](int acc, int n) { return acc + n * n; },
+                             [](int a, int b) { return a + b; });
+    cout << "平方和: " << sum << endl;
+}
+
+// ================= 3. 扩展性测试：1 ~ 64 线程 =================
+
+// 防止基准里的结果被编译器当成死代码删掉
+static volatile long long g_sink = 0;
+
+template <class F>
+double bestMs(F&& f, int reps = 3) {
+    double best = 1e100;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = chrono::steady_clock::now();
+        f();
+        auto t1 = chrono::steady_clock::now();
+        best = min(best, chrono::duration<double, milli>(t1 - t0).count());
+    }
+    return best;
+}
+
+void scalingBenchmark(size_t n) {
+    cout << "\n=== ⏱️ 扩展性测试：N = " << n << "，硬件线程数 = "
+         << thread::hardware_concurrency() << " ===" << endl;
+
+    vector<int> data(n);
+    mt19937 rng(7);
+    uniform_int_distribution<int> dist(0, 1 << 20);
+    for (auto& x : data) x = dist(rng) | 1;  // 全是奇数
+    data[n * 3 / 4] = 2;                       // 唯一的偶数放在 3/4 处，测 find_if 的提前退出
+
+    vector<long long> out(n);
+    auto isEven = [](int v) { return v % 2 == 0; };
+    auto sq = [](int v) { return static_cast<long long>(v) * v; };
+    auto sqAcc = [](double acc, int v) { return acc + static_cast<double>(v) * v; };
+    auto plus = [](double a, double b) { return a + b; };
+
+    // 串行基线
+    double serialFind = bestMs([&] { g_sink = *std::find_if(data.begin(), data.end(), isEven); });
+    double serialCount = bestMs([&] { g_sink = std::count_if(data.begin(), data.end(), isEven); });
+    double serialTransform = bestMs([&] { std::transform(data.begin(), data.end(), out.begin(), sq); });
+    double serialAcc = bestMs([&] { g_sink = static_cast<long long>(std::accumulate(data.begin(), data.end(), 0.0, sqAcc)); });
+    printf("%-8s %12s %12s %12s %12s\n", "threads", "find_if", "count_if", "transform", "accumulate");
+    printf("%-8s %10.2fms %10.2fms %10.2fms %10.2fms\n", "serial", serialFind, serialCount,
+           serialTransform, serialAcc);
+
+    double reference = 0;
+    bool deterministic = true;
+    for (size_t t : {1, 2, 4, 8, 16, 32, 64}) {
+        ParallelExecutor ex(t);
+        double accResult = 0;
+        double findMs = bestMs([&] { g_sink = *ex.find_if(data.begin(), data.end(), isEven); });
+        double countMs = bestMs([&] { g_sink = ex.count_if(data.begin(), data.end(), isEven); });
+        double transformMs = bestMs([&] { ex.transform(data.begin(), data.end(), out.begin(), sq); });
+        double accMs = bestMs([&] { accResult = ex.accumulate(data.begin(), data.end(), 0.0, sqAcc, plus); });
+
+        if (t == 1) reference = accResult;
+        if (accResult != reference) deterministic = false;  // 浮点和要求逐位相等
+        printf("%-8zu %10.2fms %10.2fms %10.2fms %10.2fms  (accumulate 加速 %.2fx)\n", t, findMs,
+               countMs, transformMs, accMs, serialAcc / accMs);
+    }
+    cout << (deterministic ? "✅ accumulate 在所有线程数下结果逐位一致"
+                           : "❌ accumulate 结果随线程数变化")
+         << endl;
+}
+
+// ================= 主函数 =================
+
+int main(int argc, char** argv) {
+    size_t n = 10000000;
+    if (argc >= 2) n = strtoull(argv[1], nullptr, 10);
+    if (n < 4) n = 4;
+
+    parallelLambdaDemo();
+    scalingBenchmark(n);
+    return 0;
+}
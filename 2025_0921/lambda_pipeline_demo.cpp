@@ -0,0 +1,248 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <chrono>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <cstdlib>
+
+using namespace std;
+
+// 对应 lambda_expressions_demo.cpp 里 practicalLambdaApplications() 的 7.2 数据处理管道：
+//   copy_if -> positives，transform -> squares，accumulate -> sum
+// 这种写法要额外分配两个中间 vector、扫三遍数据。
+// 这里实现一个惰性（lazy）管道：data | filter(...) | transform(...) | sum()
+// 各阶段在终结操作 sum() 处才真正执行，且被融合成一个循环，不产生任何中间容器。
+//
+// 编译运行：
+//   g++ -O3 -march=native -std=c++17 lambda_pipeline_demo.cpp -o lambda_pipeline
+//   ./lambda_pipeline              # 默认 100M 个 int
+//   ./lambda_pipeline 10000000     # 自定义规模
+
+// ================= 1. 惰性管道实现 =================
+
+namespace lazy {
+
+// 1.1 管道节点（view）：只保存“怎么算”，不保存数据
+//     每个节点提供 run(sink)：把自己产生的每个元素推给 sink（push 模型）
+//     push 模型下，嵌套的 lambda 全部内联后就是一个普通 for 循环
+
+template <class Range>
+struct SourceView {
+    const Range& range;
+    using value_type = typename Range::value_type;
+
+    template <class Sink>
+    void run(Sink&& sink) const {
+        for (const auto& x : range) sink(x);
+    }
+};
+
+template <class Prev, class Pred>
+struct FilterView {
+    Prev prev;
+    Pred pred;
+    using value_type = typename Prev::value_type;
+
+    template <class Sink>
+    void run(Sink&& sink) const {
+        const Pred& p = pred;
+        prev.run([&](const value_type& x) {
+            if (p(x)) sink(x);
+        });
+    }
+};
+
+template <class Prev, class Fn>
+struct TransformView {
+    Prev prev;
+    Fn fn;
+    using value_type = decay_t<invoke_result_t<const Fn&, const typename Prev::value_type&>>;
+
+    template <class Sink>
+    void run(Sink&& sink) const {
+        const Fn& f = fn;
+        prev.run([&](const typename Prev::value_type& x) {
+            sink(f(x));
+        });
+    }
+};
+
+// 1.2 管道阶段（stage）：filter(...) / transform(...) / sum() 返回的“半成品”
+template <class Pred> struct FilterStage { Pred pred; };
+template <class Fn> struct TransformStage { Fn fn; };
+struct SumStage {};
+
+template <class Pred>
+FilterStage<Pred> filter(Pred pred) { return {std::move(pred)}; }
+
+template <class Fn>
+TransformStage<Fn> transform(Fn fn) { return {std::move(fn)}; }
+
+inline SumStage sum() { return {}; }
+
+// 1.3 区分“已经是 view”与“普通容器”
+template <class T> struct is_view : false_type {};
+template <class R> struct is_view<SourceView<R>> : true_type {};
+template <class P, class F> struct is_view<FilterView<P, F>> : true_type {};
+template <class P, class F> struct is_view<TransformView<P, F>> : true_type {};
+
+template <class T>
+auto as_view(const T& r) {
+    if constexpr (is_view<T>::value) {
+        return r;
+    } else {
+        return SourceView<T>{r};
+    }
+}
+
+// 1.4 operator|：通过 ADL 在 Stage 类型所在的命名空间里找到
+//     注意：容器必须是左值（SourceView 只保存引用），临时 vector 会悬空
+template <class R, class Pred>
+auto operator|(const R& r, FilterStage<Pred> s) {
+    using V = decltype(as_view(r));
+    return FilterView<V, Pred>{as_view(r), std::move(s.pred)};
+}
+
+template <class R, class Fn>
+auto operator|(const R& r, TransformStage<Fn> s) {
+    using V = decltype(as_view(r));
+    return TransformView<V, Fn>{as_view(r), std::move(s.fn)};
+}
+
+// 终结操作：到这里才真正遍历数据，累加器是一个局部变量，编译器可以把它放进寄存器/向量寄存器
+template <class R>
+auto operator|(const R& r, SumStage) {
+    auto v = as_view(r);
+    using T = typename decltype(v)::value_type;
+    T acc{};
+    v.run([&acc](const T& x) { acc += x; });
+    return acc;
+}
+
+}  // namespace lazy
+
+// ================= 2. 三种写法 =================
+
+// 2.1 原写法：两个中间 vector + 三遍扫描
+long long eagerPipeline(const vector<int>& data) {
+    vector<int> positives;
+    copy_if(data.begin(), data.end(), back_inserter(positives), [](int n) {
+        return n > 0;
+    });
+
+    vector<long long> squares;
+    transform(positives.begin(), positives.end(), back_inserter(squares), [](int n) {
+        return static_cast<long long>(n) * n;
+    });
+
+    return accumulate(squares.begin(), squares.end(), 0LL);
+}
+
+// 2.2 手写融合循环：性能上限参照
+long long handFusedLoop(const vector<int>& data) {
+    long long acc = 0;
+    for (int n : data) {
+        // 写成无分支形式，方便编译器向量化
+        long long sq = static_cast<long long>(n) * n;
+        acc += n > 0 ? sq : 0;
+    }
+    return acc;
+}
+
+// 2.3 惰性管道
+long long lazyPipeline(const vector<int>& data) {
+    using namespace lazy;
+    return data
+         | filter([](int n) { return n > 0; })
+         | transform([](int n) { return static_cast<long long>(n) * n; })
+         | sum();
+}
+
+// ================= 3. 小数据演示 =================
+
+void pipelineDemo() {
+    cout << "=== 🔗 惰性管道演示 ===" << endl;
+
+    vector<int> data = {1, -2, 3, -4, 5, -6, 7, -8, 9, -10};
+    cout << "原数据: ";
+    for (int n : data) cout << n << " ";
+    cout << endl;
+
+    using namespace lazy;
+    auto squaresOfPositives = data
+        | filter([](int n) { return n > 0; })
+        | transform([](int n) { return n * n; });
+    // 到这里还没有做任何计算，squaresOfPositives 只是一个 view
+
+    cout << "正数平方和（惰性管道）: " << (squaresOfPositives | sum()) << endl;
+    cout << "正数平方和（原写法）:   " << eagerPipeline(data) << endl;
+
+    // view 可以继续接阶段，复用同一个数据源
+    auto bigOnes = squaresOfPositives | filter([](int sq) { return sq > 10; }) | sum();
+    cout << "大于10的平方之和: " << bigOnes << endl;
+}
+
+// ================= 4. 性能对比 =================
+
+template <class F>
+double timeMs(F&& f, long long& result, int reps) {
+    double best = 1e100;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = chrono::steady_clock::now();
+        result = f();
+        auto t1 = chrono::steady_clock::now();
+        best = min(best, chrono::duration<double, milli>(t1 - t0).count());
+    }
+    return best;
+}
+
+void pipelineBenchmark(size_t n) {
+    cout << "\n=== ⏱️ 性能对比：N = " << n << " 个 int ===" << endl;
+
+    vector<int> data(n);
+    mt19937 rng(42);
+    uniform_int_distribution<int> dist(-1000, 1000);
+    for (auto& x : data) x = dist(rng);
+
+    const int reps = 3;
+    long long r1 = 0, r2 = 0, r3 = 0;
+    double eagerMs = timeMs([&] { return eagerPipeline(data); }, r1, reps);
+    double fusedMs = timeMs([&] { return handFusedLoop(data); }, r2, reps);
+    double lazyMs = timeMs([&] { return lazyPipeline(data); }, r3, reps);
+
+    auto report = [&](const string& name, double ms, long long r) {
+        double gbps = n * sizeof(int) / (ms * 1e-3) / 1e9;
+        cout << name << ": " << ms << " ms, " << gbps << " GB/s, 结果=" << r
+             << ", 相对原写法加速 " << eagerMs / ms << "x" << endl;
+    };
+    report("原写法(copy_if+transform+accumulate)", eagerMs, r1);
+    report("手写融合循环                        ", fusedMs, r2);
+    report("惰性管道                            ", lazyMs, r3);
+
+    if (r1 != r2 || r1 != r3) {
+        cout << "❌ 结果不一致！" << endl;
+    } else {
+        cout << "✅ 三种写法结果一致" << endl;
+    }
+}
+
+// ================= 主函数 =================
+
+int main(int argc, char** argv) {
+    size_t n = 100000000;  // 默认 100M
+    if (argc >= 2) n = strtoull(argv[1], nullptr, 10);
+
+    pipelineDemo();
+    pipelineBenchmark(n);
+
+    cout << "\n📚 要点：" << endl;
+    cout << "- 惰性：filter/transform 只组装 view，sum() 时才遍历" << endl;
+    cout << "- 融合：多个 lambda 内联进同一个循环，没有中间 vector" << endl;
+    cout << "- view 只保存容器引用，不要对临时容器建管道" << endl;
+    return 0;
+}
@@ -0,0 +1,239 @@
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include "../common/work_stealing_pool.h"
+
+using namespace std;
+
+// work_stealing_pool.h 的微基准：
+//   1) 任务派生延迟：外部 submit -> future.get() 往返；池内 spawn 单个任务的均摊开销
+//   2) 窃取率：parallel_for 期间有多少任务是偷来的、多少来自注入队列（分开统计；
+//      main 调用 parallel_for 时占用池的外部槽位，子任务进 Chase-Lev 队列而不是注入队列）
+//   3) 细粒度任务吞吐：工作窃取池 vs “一把锁 + 一个队列”的传统线程池
+//
+// 编译运行：
+//   g++ -O3 -std=c++17 -pthread work_stealing_pool_bench.cpp -o ws_bench
+//   ./ws_bench          # 默认线程数 = 硬件线程数
+//   ./ws_bench 8
+
+// ================= 1. 对照组：互斥锁保护的单队列线程池 =================
+
+class MutexQueuePool {
+public:
+    explicit MutexQueuePool(size_t threadCount) {
+        for (size_t i = 0; i < threadCount; ++i) {
+            threads_.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~MutexQueuePool() {
+        {
+            lock_guard<mutex> lk(m_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+
+    void spawn(function<void()> f) {
+        {
+            lock_guard<mutex> lk(m_);
+            tasks_.push(std::move(f));
+        }
+        cv_.notify_one();
+    }
+
+private:
+    void workerLoop() {
+        while (true) {
+            function<void()> task;
+            {
+                unique_lock<mutex> lk(m_);
+                cv_.wait(lk, [this] { return stop_ || !tasks_.empty(); });
+                if (stop_ && tasks_.empty()) return;
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+        }
+    }
+
+    vector<thread> threads_;
+    mutex m_;
+    condition_variable cv_;
+    queue<function<void()>> tasks_;
+    bool stop_ = false;
+};
+
+// ================= 2. 工具 =================
+
+using Clock = chrono::steady_clock;
+
+double elapsedUs(Clock::time_point t0) {
+    return chrono::duration<double, micro>(Clock::now() - t0).count();
+}
+
+void printStats(const ws::PoolStats& s) {
+    auto pct = [&](uint64_t x) { return s.executed ? 100.0 * x / s.executed : 0.0; };
+    printf("执行任务 %llu 个：偷来的 %llu 个（%.2f%%），来自注入队列 %llu 个（%.2f%%），其余从自己队列 pop\n",
+           (unsigned long long)s.executed, (unsigned long long)s.stolen, pct(s.stolen),
+           (unsigned long long)s.injected, pct(s.injected));
+}
+
+// 模拟很小的计算量（约几十 ns）
+inline uint64_t tinyWork(uint64_t x) {
+    for (int i = 0; i < 16; ++i) x = x * 6364136223846793005ull + 1442695040888963407ull;
+    return x;
+}
+
+// ================= 3. 派生延迟 =================
+
+void spawnLatency(ws::WorkStealingPool& pool) {
+    cout << "\n=== 1️⃣ 派生延迟 ===" << endl;
+
+    // 3.1 外部线程 submit -> get 的往返延迟（含唤醒工作线程）
+    const int rounds = 20000;
+    vector<double> lat;
+    lat.reserve(rounds);
+    for (int i = 0; i < rounds; ++i) {
+        auto t0 = Clock::now();
+        auto fut = pool.submit([i] { return i; });
+        fut.get();
+        lat.push_back(elapsedUs(t0));
+    }
+    sort(lat.begin(), lat.end());
+    printf("submit->get 往返: p50=%.2f us, p99=%.2f us\n", lat[rounds / 2], lat[rounds * 99 / 100]);
+
+    // 3.2 池内派生：一个根任务里 spawn N 个空任务，均摊每个任务的 spawn+执行开销
+    const size_t n = 1000000;
+    atomic<size_t> done{0};
+    auto t0 = Clock::now();
+    {
+        ws::TaskGroup g(pool);
+        g.run([&] {
+            ws::TaskGroup inner(pool);
+            for (size_t i = 0; i < n; ++i) {
+                inner.run([&done] { done.fetch_add(1, memory_order_relaxed); });
+            }
+            inner.wait();
+        });
+        g.wait();
+    }
+    double us = elapsedUs(t0);
+    printf("池内 spawn %zu 个空任务: %.1f ms, 均摊 %.1f ns/任务\n", n, us / 1e3, us * 1e3 / n);
+}
+
+// ================= 4. 窃取率 =================
+
+void stealRate(ws::WorkStealingPool& pool) {
+    cout << "\n=== 2️⃣ 窃取率（parallel_for，叶子块 grain=64）===" << endl;
+
+    const size_t n = 1 << 22;
+    vector<uint64_t> data(n, 1);
+    pool.resetStats();
+    auto t0 = Clock::now();
+    ws::parallel_for(pool, 0, n, 64, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) data[i] = tinyWork(data[i] + i);
+    });
+    double us = elapsedUs(t0);
+    ws::PoolStats s = pool.stats();
+    printStats(s);
+    printf("耗时 %.2f ms，窃取速率 %.0f 次/秒\n", us / 1e3, s.stolen / (us * 1e-6));
+}
+
+// ================= 5. 细粒度任务吞吐 =================
+
+void throughputCompare(size_t threads) {
+    cout << "\n=== 3️⃣ 细粒度任务吞吐：" << threads << " 个工作线程 ===" << endl;
+
+    const size_t n = 1000000;
+    vector<uint64_t> out(n);
+
+    double wsUs;
+    ws::PoolStats wsStats;
+    {
+        ws::WorkStealingPool pool(threads);
+        auto t0 = Clock::now();
+        // grain=1：每个元素一个任务，专门考察调度开销
+        ws::parallel_for(pool, 0, n, 1, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) out[i] = tinyWork(i);
+        });
+        wsUs = elapsedUs(t0);
+        wsStats = pool.stats();
+    }
+
+    double mqUs;
+    {
+        MutexQueuePool pool(threads);
+        atomic<size_t> remaining{n};
+        auto t0 = Clock::now();
+        for (size_t i = 0; i < n; ++i) {
+            pool.spawn([&out, &remaining, i] {
+                out[i] = tinyWork(i);
+                remaining.fetch_sub(1, memory_order_acq_rel);
+            });
+        }
+        while (remaining.load(memory_order_acquire) != 0) this_thread::yield();
+        mqUs = elapsedUs(t0);
+    }
+
+    printf("工作窃取池: %.2f ms, %.2f M 任务/秒\n", wsUs / 1e3, n / wsUs);
+    printf("  ");
+    printStats(wsStats);
+    printf("互斥锁队列: %.2f ms, %.2f M 任务/秒\n", mqUs / 1e3, n / mqUs);
+    printf("吞吐比: %.2fx\n", mqUs / wsUs);
+}
+
+// ================= 6. 正确性自检 =================
+
+bool selfCheck(ws::WorkStealingPool& pool) {
+    const size_t n = 1000003;
+    vector<int> v(n);
+    ws::parallel_for(pool, 0, n, 1000, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) v[i] = static_cast<int>(i % 7);
+    });
+    long long expect = 0;
+    for (size_t i = 0; i < n; ++i) expect += static_cast<long long>(i % 7);
+
+    long long got = ws::parallel_reduce(
+        pool, 0, n, 4096, 0LL,
+        [&](size_t lo, size_t hi) {
+            long long s = 0;
+            for (size_t i = lo; i < hi; ++i) s += v[i];
+            return s;
+        },
+        [](long long a, long long b) { return a + b; });
+
+    auto fut = pool.submit([] { return string("future ok"); });
+    bool ok = got == expect && fut.get() == "future ok";
+    cout << (ok ? "✅ 自检通过" : "❌ 自检失败") << " (parallel_reduce=" << got
+         << ", 期望=" << expect << ")" << endl;
+    return ok;
+}
+
+// ================= 主函数 =================
+
+int main(int argc, char** argv) {
+    size_t threads = thread::hardware_concurrency();
+    if (argc >= 2) threads = strtoul(argv[1], nullptr, 10);
+    if (threads == 0) threads = 1;
+
+    cout << "=== 🧵 工作窃取线程池微基准（" << threads << " 线程）===" << endl;
+
+    ws::WorkStealingPool pool(threads);
+    if (!selfCheck(pool)) return 1;
+    spawnLatency(pool);
+    stealRate(pool);
+    throughputCompare(threads);
+    return 0;
+}
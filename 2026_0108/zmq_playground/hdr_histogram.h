@@ -0,0 +1,128 @@
+#pragma once
+
+// HDR 直方图（header-only）：固定相对精度的延迟记录，和 HdrHistogram 的桶布局相同。
+//
+// 值按 2 的幂分段（bucket），每段再等分成 subBucketCount/2 个子桶：
+//   - 小于 subBucketCount 的值：一个值一个格子，精确
+//   - 更大的值：第 b 段的格子宽 2^b，相对误差 < 1 / (subBucketCount/2)
+// 有效数字 3 位时 subBucketCount = 2048，相对误差 < 0.1%；记录是 O(1) 的位运算 + 一次自增，
+// 不保存原始样本，所以几百万个请求也只占一个固定大小的数组（按微秒记、上限 1 小时约 190KB）。
+//
+// 用法：
+//   hdr::Histogram h(3600ll * 1000 * 1000, 3);   // 最大可记录值，有效数字
+//   h.record(latencyUs);
+//   h.valueAtPercentile(99.0);  h.print("hedged");
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+namespace hdr {
+
+class Histogram {
+public:
+    Histogram(int64_t highestTrackable, int significantDigits) {
+        if (highestTrackable < 2 || significantDigits < 1 || significantDigits > 5)
+            throw std::invalid_argument("hdr::Histogram: bad range or precision");
+        int64_t largestSingleUnit = 2;
+        for (int i = 0; i < significantDigits; ++i) largestSingleUnit *= 10;
+        subBucketMagnitude_ = 0;
+        while ((int64_t{1} << subBucketMagnitude_) < largestSingleUnit) ++subBucketMagnitude_;
+        subBucketCount_ = int64_t{1} << subBucketMagnitude_;
+        subBucketHalf_ = subBucketCount_ / 2;
+        // 需要多少段才能覆盖 highestTrackable
+        int buckets = 1;
+        for (int64_t top = subBucketCount_; top <= highestTrackable; top <<= 1) ++buckets;
+        highest_ = highestTrackable;
+        counts_.assign(static_cast<size_t>(buckets + 1) * subBucketHalf_, 0);
+    }
+
+    // 超出上限的值按上限记（计入 saturated()），负值按 0 记
+    void record(int64_t v, int64_t n = 1) {
+        if (v > highest_) {
+            v = highest_;
+            saturated_ += n;
+        }
+        v = std::max<int64_t>(v, 0);
+        counts_[indexOf(v)] += n;
+        total_ += n;
+        sum_ += static_cast<double>(v) * n;
+        min_ = std::min(min_, v);
+        max_ = std::max(max_, v);
+    }
+
+    void merge(const Histogram& o) {
+        if (o.counts_.size() != counts_.size() || o.subBucketCount_ != subBucketCount_)
+            throw std::invalid_argument("hdr::Histogram: merging histograms with different layouts");
+        for (size_t i = 0; i < counts_.size(); ++i) counts_[i] += o.counts_[i];
+        total_ += o.total_;
+        sum_ += o.sum_;
+        saturated_ += o.saturated_;
+        min_ = std::min(min_, o.min_);
+        max_ = std::max(max_, o.max_);
+    }
+
+    void reset() {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        total_ = saturated_ = 0;
+        sum_ = 0;
+        min_ = INT64_MAX;
+        max_ = 0;
+    }
+
+    // 第 p 百分位（0..100）：返回该格子内的最大等价值（与 HdrHistogram 一致，偏保守）
+    int64_t valueAtPercentile(double p) const {
+        if (total_ == 0) return 0;
+        const int64_t want = std::max<int64_t>(1, static_cast<int64_t>(p / 100.0 * total_ + 0.5));
+        int64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen >= want) return std::min(highestEquivalent(i), max_);
+        }
+        return max_;
+    }
+
+    int64_t count() const { return total_; }
+    int64_t saturated() const { return saturated_; }
+    int64_t min() const { return total_ ? min_ : 0; }
+    int64_t max() const { return max_; }
+    double mean() const { return total_ ? sum_ / total_ : 0.0; }
+
+    void print(const char* label, const char* unit = "us") const {
+        std::printf("%-22s n=%-7lld p50=%7lld p90=%7lld p95=%7lld p99=%7lld p99.9=%7lld max=%7lld %s\n", label,
+                    static_cast<long long>(total_), static_cast<long long>(valueAtPercentile(50)),
+                    static_cast<long long>(valueAtPercentile(90)), static_cast<long long>(valueAtPercentile(95)),
+                    static_cast<long long>(valueAtPercentile(99)), static_cast<long long>(valueAtPercentile(99.9)),
+                    static_cast<long long>(max()), unit);
+    }
+
+private:
+    // 段号 b = floor(log2(v | (subBucketCount-1))) - (subBucketMagnitude-1)；小值都在第 0 段
+    size_t indexOf(int64_t v) const {
+        const int log2v = 63 - __builtin_clzll(static_cast<uint64_t>(v) | (subBucketCount_ - 1));
+        const int b = log2v - (subBucketMagnitude_ - 1);
+        const int64_t sub = v >> b;  // b > 0 时落在 [half, count)
+        return static_cast<size_t>(static_cast<int64_t>(b) * subBucketHalf_ + sub);
+    }
+
+    int64_t highestEquivalent(size_t idx) const {
+        int64_t i = static_cast<int64_t>(idx);
+        int b = 0;
+        if (i >= subBucketCount_) {
+            b = static_cast<int>((i - subBucketCount_) / subBucketHalf_) + 1;
+        }
+        const int64_t sub = i - static_cast<int64_t>(b) * subBucketHalf_;
+        return ((sub + 1) << b) - 1;
+    }
+
+    int subBucketMagnitude_ = 0;
+    int64_t subBucketCount_ = 0, subBucketHalf_ = 0, highest_ = 0;
+    std::vector<int64_t> counts_;
+    int64_t total_ = 0, saturated_ = 0;
+    double sum_ = 0;
+    int64_t min_ = INT64_MAX, max_ = 0;
+};
+
+}  // namespace hdr
@@ -0,0 +1,254 @@
+#pragma once
+
+// 建在 shm_transport.h 上的异步请求客户端（header-only）：把 req_rep_timeout_retry_client.py 的
+// “超时 -> 重建 socket -> 重试”做成一个能同时挂很多请求的事件循环，并加上三样东西：
+//
+//   - 每个请求一个截止时间（deadline）：到点还没有回复就以 DeadlineExceeded 结束，不会无限等
+//   - 对冲（hedging）：首个副本发出后，若超过“近期延迟的 p95”仍未回复，再发一个副本给服务队列，
+//     谁先回来用谁（“The Tail at Scale” 里的 hedged request）。p95 来自 HDR 直方图，样本不够时用 hedgeInitialMs
+//   - 重试（retry）：某个副本超过 attemptTimeoutMs 没回复就再发一个；和对冲一样，旧副本的回复仍然有效
+//   - 重试预算（retry budget）：对冲和重试共用一个令牌桶，每个新请求存入 budgetRatio 个令牌，
+//     每个额外副本花 1 个，上限 budgetBurst。服务端整体变慢时，额外副本被预算卡住，不会把负载放大成雪崩
+//
+// 协议：客户端是一个 Dealer（自己的 inbox 队列），服务端是若干个读同一服务队列的 Rep；
+// 消息头的 tag = 请求号 * 8 + 副本序号；服务端原地回复收到的消息（或把 tag 抄到回复上），
+// 客户端就能认出是哪个请求的哪个副本（Rep 不改 tag）。
+// 请求完成后记录保留到它的 deadline：第一个副本迟到的回复仍然计入对冲阈值用的直方图
+// （只统计“赢了的那个副本”会把慢的样本系统性地丢掉，p95 越估越低），之后才真正丢弃。
+// 服务端不知道副本被放弃了（没有取消），这部分额外负载由预算限制。
+// 发送从不阻塞：槽全被占用时（在途消息达到 Config::numSlots）额外副本直接放弃（slotDenied，不花预算），
+// 第一个副本每隔 1ms 再试一次直到 deadline（slotDelayed）；poll 里阻塞在 alloc 上会让所有定时器一起停摆。
+//
+// 用法：
+//   shmq::AsyncClient client(arena, serviceQueue, inboxQueue, policy);
+//   client.submit(payload, len, [](shmq::AsyncClient::Result r) { ... });   // 不阻塞
+//   while (client.inflight()) client.poll(10);                                 // 收回复、触发定时器、调回调
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "hdr_histogram.h"
+#include "shm_transport.h"
+
+namespace shmq {
+
+struct Policy {
+    int deadlineMs = 200;         // 整个请求的截止时间
+    int attemptTimeoutMs = -1;    // 单个副本多久没回复就重试；< 0 表示不重试
+    int maxAttempts = 3;          // 一个请求最多发几个副本（含第一个），最多 8
+    bool hedge = false;           // 是否对冲
+    double hedgePercentile = 95;  // 超过这个分位数的延迟就发对冲副本
+    int hedgeInitialMs = 5;       // 样本不足 hedgeMinSamples 时的对冲阈值
+    int hedgeMinSamples = 200;
+    double budgetRatio = 0.1;     // 每个新请求给预算存入的令牌数（0.1 = 额外副本最多约占 10%）
+    double budgetBurst = 20;      // 令牌桶上限
+};
+
+class AsyncClient {
+public:
+    enum class Status { Ok, DeadlineExceeded };
+
+    struct Result {
+        Status status;
+        Message reply;      // Ok 时有效，零拷贝读 reply.data()
+        int64_t latencyUs;  // 从 submit 到完成
+        int attempts;       // 一共发了几个副本
+        bool wonByExtra;    // 回复来自对冲 / 重试副本
+    };
+    using Callback = std::function<void(Result&&)>;
+
+    struct Stats {
+        int64_t submitted = 0, ok = 0, deadlineExceeded = 0;
+        int64_t hedges = 0, retries = 0, budgetDenied = 0, lateReplies = 0;
+        int64_t slotDenied = 0;   // 额外副本因为没有空闲槽被放弃
+        int64_t slotDelayed = 0;  // 第一个副本因为没有空闲槽推迟发送的次数
+    };
+
+    AsyncClient(Arena& arena, uint32_t service, uint32_t inbox, Policy policy)
+        : arena_(arena), dealer_(arena, service, inbox), policy_(policy),
+          budget_(policy.budgetBurst), firstAttempt_(60ll * 1000 * 1000, 3) {}
+
+    // 复制一份请求内容（重试 / 对冲时要重发），发出第一个副本，返回请求号
+    uint32_t submit(const void* payload, size_t len, Callback cb) {
+        const uint32_t id = nextId_++ & kIdMask;
+        const int64_t now = nowUs();
+        Pending& p = pending_[id];
+        p.payload.assign(static_cast<const char*>(payload), len);
+        p.cb = std::move(cb);
+        p.startUs = now;
+        p.deadlineUs = now + int64_t{policy_.deadlineMs} * 1000;
+        budget_ = std::min(policy_.budgetBurst, budget_ + policy_.budgetRatio);
+        ++stats_.submitted;
+        ++active_;
+        timers_.push({p.deadlineUs, id, TimerKind::Deadline});
+        sendFirst(id, p, now);
+        return id;
+    }
+
+    // 最多等 maxWaitMs：收回复、处理到期的定时器。返回这次完成的请求数
+    int poll(int maxWaitMs) {
+        int done = fireTimers();
+        const int64_t now = nowUs();
+        int64_t waitUs = int64_t{maxWaitMs} * 1000;
+        if (!timers_.empty()) waitUs = std::min(waitUs, std::max<int64_t>(0, timers_.top().atUs - now));
+        Message m;
+        // futex 等待是毫秒粒度，向上取整，避免定时器差一点没到又空转一圈
+        int waitMs = static_cast<int>((waitUs + 999) / 1000);
+        while (dealer_.recv(m, waitMs)) {
+            done += onReply(std::move(m));
+            waitMs = 0;  // 把已经到达的回复一次收完
+        }
+        return done + fireTimers();
+    }
+
+    // 还没有结果（未回调）的请求数
+    size_t inflight() const { return active_; }
+    const Stats& stats() const { return stats_; }
+    // 第一个副本的延迟（含请求已被别的副本完成后才迟到的回复），对冲阈值取它的分位数
+    const hdr::Histogram& firstAttemptLatency() const { return firstAttempt_; }
+
+private:
+    enum class TimerKind { Deadline, Send, Hedge, Retry };
+
+    struct Timer {
+        int64_t atUs;
+        uint32_t id;
+        TimerKind kind;
+        bool operator>(const Timer& o) const { return atUs > o.atUs; }
+    };
+
+    struct Pending {
+        std::string payload;
+        Callback cb;
+        int64_t startUs = 0, deadlineUs = 0;
+        int attempts = 0;
+        bool done = false;  // 已回调；记录留到 deadline 为止，用来识别迟到的回复
+    };
+
+    static constexpr int kAttemptBits = 3;
+    static constexpr uint32_t kIdMask = (1u << (32 - kAttemptBits)) - 1;
+    static constexpr int64_t kSlotRetryUs = 1000;
+
+    static int64_t nowUs() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    int64_t hedgeDelayUs() const {
+        if (firstAttempt_.count() < policy_.hedgeMinSamples) return int64_t{policy_.hedgeInitialMs} * 1000;
+        return std::max<int64_t>(1, firstAttempt_.valueAtPercentile(policy_.hedgePercentile));
+    }
+
+    // 发一个副本；没有空闲槽时不等，返回 false。对冲计时从第一个副本真正发出时算起
+    bool sendAttempt(uint32_t id, Pending& p, int64_t now) {
+        Message m = arena_.alloc(p.payload.size(), 0);
+        if (!m.valid()) return false;
+        std::memcpy(m.data(), p.payload.data(), p.payload.size());
+        m.setTag(id << kAttemptBits | static_cast<uint32_t>(p.attempts));
+        dealer_.send(std::move(m));
+        ++p.attempts;
+        if (p.attempts == 1 && policy_.hedge) timers_.push({now + hedgeDelayUs(), id, TimerKind::Hedge});
+        if (policy_.attemptTimeoutMs >= 0 && p.attempts < maxAttempts())
+            timers_.push({now + int64_t{policy_.attemptTimeoutMs} * 1000, id, TimerKind::Retry});
+        return true;
+    }
+
+    // 第一个副本发不出去就过一会儿再试，直到 deadline 把请求结束
+    void sendFirst(uint32_t id, Pending& p, int64_t now) {
+        if (sendAttempt(id, p, now)) return;
+        ++stats_.slotDelayed;
+        timers_.push({now + kSlotRetryUs, id, TimerKind::Send});
+    }
+
+    // 额外副本：次数、预算和空闲槽都够才发；没有槽时预算不扣
+    bool trySendExtra(uint32_t id, Pending& p, int64_t now) {
+        if (p.attempts >= maxAttempts()) return false;
+        if (budget_ < 1.0) {
+            ++stats_.budgetDenied;
+            return false;
+        }
+        if (!sendAttempt(id, p, now)) {
+            ++stats_.slotDenied;
+            return false;
+        }
+        budget_ -= 1.0;
+        return true;
+    }
+
+    int maxAttempts() const { return std::clamp(policy_.maxAttempts, 1, 1 << kAttemptBits); }
+
+    int onReply(Message&& m) {
+        const uint32_t attempt = m.tag() & ((1u << kAttemptBits) - 1);
+        auto it = pending_.find(m.tag() >> kAttemptBits);
+        if (it == pending_.end()) {
+            ++stats_.lateReplies;  // 已经过了 deadline
+            return 0;
+        }
+        Pending& p = it->second;
+        const int64_t lat = nowUs() - p.startUs;
+        if (attempt == 0) firstAttempt_.record(lat);
+        if (p.done) {
+            ++stats_.lateReplies;  // 另一个副本已经赢了
+            return 0;
+        }
+        p.done = true;
+        --active_;
+        ++stats_.ok;
+        Callback cb = std::move(p.cb);
+        const int attempts = p.attempts;
+        p.payload.clear();
+        cb(Result{Status::Ok, std::move(m), lat, attempts, attempt != 0});
+        return 1;
+    }
+
+    int fireTimers() {
+        int done = 0;
+        const int64_t now = nowUs();
+        while (!timers_.empty() && timers_.top().atUs <= now) {
+            Timer t = timers_.top();
+            timers_.pop();
+            auto it = pending_.find(t.id);
+            if (it == pending_.end()) continue;
+            Pending& p = it->second;
+            if (t.kind == TimerKind::Deadline) {
+                Pending dead = std::move(p);
+                pending_.erase(it);
+                if (dead.done) continue;  // 早已完成，只是到点清理记录
+                --active_;
+                ++stats_.deadlineExceeded;
+                dead.cb(Result{Status::DeadlineExceeded, Message(), now - dead.startUs, dead.attempts, false});
+                ++done;
+            } else if (p.done) {
+                continue;  // 已完成，对冲 / 重试定时器作废
+            } else if (t.kind == TimerKind::Send) {
+                sendFirst(t.id, p, now);
+            } else if (t.kind == TimerKind::Hedge) {
+                if (trySendExtra(t.id, p, now)) ++stats_.hedges;
+            } else {
+                if (trySendExtra(t.id, p, now)) ++stats_.retries;
+            }
+        }
+        return done;
+    }
+
+    Arena& arena_;
+    Dealer dealer_;
+    Policy policy_;
+    double budget_;
+    uint32_t nextId_ = 1;
+    size_t active_ = 0;
+    std::unordered_map<uint32_t, Pending> pending_;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+    hdr::Histogram firstAttempt_;
+    Stats stats_;
+};
+
+}  // namespace shmq
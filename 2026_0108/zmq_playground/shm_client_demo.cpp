@@ -0,0 +1,290 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "hdr_histogram.h"
+#include "shm_client.h"
+
+// shm_client.h 的 demo：req_rep_slow_server.py 的“慢服务端”换成共享内存上的几个 Rep 进程，
+// 同一批请求在四种策略下各跑一遍，用 HDR 直方图比较尾延迟：
+//   baseline      只有 deadline（对应 req_rep_basic_client.py：慢了就干等）
+//   retry         单个副本超过 --retry-ms 没回复就再发一个（对应 req_rep_timeout_retry_client.py）
+//   hedge@p95     超过近期第一个副本延迟的 p95 就发对冲副本
+//   hedge+retry   两者都开，共用同一个重试预算
+//
+// 服务端：--workers 个进程读同一个服务队列，每个请求 sleep --service-us；
+// 以概率 --slow-prob 卡顿 --slow-ms（模拟 GC、换页、锁竞争这类和请求内容无关的偶发慢）。
+// 客户端是开环的：按 --rate 的固定到达率发请求（第 i 个请求的计划发送时刻 = 开始 + i / rate），
+// 四种策略的到达时刻完全相同；延迟从计划发送时刻算起，发送方落后时排队的时间也算在内
+// （闭环的“保持 N 个在途”会在服务变慢时自动少发，慢请求挡住的那些请求根本没被测到，即 coordinated omission；
+// 而且各策略的实际负载不同，没法直接比）。
+//
+// 编译运行：
+//   g++ -O3 -std=c++17 -pthread shm_client_demo.cpp -o shm_client_demo
+//   ./shm_client_demo                                  # 默认 20000 个请求，3000 req/s，2% 卡 20ms
+//   ./shm_client_demo --rate 6000                      # 负载翻倍：额外副本开始和正常请求抢 worker
+//   ./shm_client_demo --slow-prob 0.3                  # 服务端整体变慢：看重试预算把额外副本卡住
+//   ./shm_client_demo --slow-ms 150 --deadline-ms 100  # 卡顿超过 deadline：看 deadline 和对冲救回多少
+//   ./shm_client_demo --slots 6                        # 共享内存只有 6 个槽：额外副本因没有槽被放弃（slotDenied）
+//
+// 对比表列出 p50 ~ p99.9 各分位数，变慢超过 10% 的单独列出来。对冲 / 重试换来的是 p99 以上的尾部；
+// 低负载时 p50 ~ p95 基本不变，负载升高后额外副本和正常请求抢 worker，p95 开始变差（见 README Demo 5）。
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    int requests = 20000;
+    double rate = 3000;  // 每秒到达的请求数
+    int workers = 8;
+    int serviceUs = 200;
+    double slowProb = 0.02;
+    int slowMs = 20;
+    int deadlineMs = 100;
+    int retryMs = 10;
+    double budgetRatio = 0.1;
+    int slots = 4096;
+};
+
+// 服务队列号；客户端 inbox 用 1
+constexpr uint32_t kService = 0, kInbox = 1;
+constexpr uint32_t kStopTag = 0xffffffffu;
+
+// fork 一个子进程跑 fn，返回 pid；子进程里 fn 返回值就是退出码
+static pid_t spawn(const std::function<int()>& fn) {
+    pid_t pid = ::fork();
+    if (pid < 0) {
+        std::perror("fork");
+        std::exit(1);
+    }
+    if (pid == 0) {
+        int rc = fn();
+        std::fflush(stdout);
+        ::_exit(rc);
+    }
+    return pid;
+}
+
+static bool wait_ok(pid_t pid) {
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// ================= 1. 慢服务端 =================
+
+static int slow_worker(shmq::Arena& arena, const Options& opt, int index) {
+    shmq::Rep rep(arena, kService);
+    std::mt19937_64 rng(0x5eed + index * 7919 + ::getpid());
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    shmq::Message m;
+    for (;;) {
+        if (!rep.recv(m, 30000)) return 1;
+        if (m.tag() == kStopTag) return 0;
+        const bool slow = coin(rng) < opt.slowProb;
+        std::this_thread::sleep_for(slow ? std::chrono::microseconds(opt.slowMs * 1000)
+                                         : std::chrono::microseconds(opt.serviceUs));
+        rep.send(std::move(m));  // 原样发回：内容就是请求号，客户端据此校验
+    }
+}
+
+// ================= 2. 一种策略跑一遍 =================
+
+struct RunResult {
+    hdr::Histogram latency{60ll * 1000 * 1000, 3};
+    shmq::AsyncClient::Stats stats;
+    int64_t attempts = 0, wrongReplies = 0;
+    int64_t hedgeThresholdUs = 0;
+    int64_t maxSendLagUs = 0;  // 实际 submit 比计划发送时刻晚了多少（发送方跟不上到达率时变大）
+    double seconds = 0;
+};
+
+static RunResult run_policy(const Options& opt, const shmq::Policy& policy, const char* label) {
+    const std::string name = "/shmq.client." + std::string(label) + "." + std::to_string(::getpid());
+    shmq::Config cfg;
+    cfg.numSlots = static_cast<uint32_t>(opt.slots);
+    shmq::Arena arena = shmq::Arena::create(name, cfg);
+    shmq::Arena::unlink(name);  // fork 继承映射，名字用不着了
+
+    std::vector<pid_t> workers;
+    for (int w = 0; w < opt.workers; ++w) workers.push_back(spawn([&, w] { return slow_worker(arena, opt, w); }));
+
+    RunResult r;
+    {
+        shmq::AsyncClient client(arena, kService, kInbox, policy);
+        int submitted = 0, completed = 0;
+        const auto t0 = Clock::now();
+        // 第 i 个请求的计划发送时刻；和策略无关，四次运行的到达序列完全一样
+        auto intended = [&](int i) {
+            return t0 + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(i / opt.rate));
+        };
+        while (completed < opt.requests) {
+            Clock::time_point now = Clock::now();
+            // 到点的请求全部发出：落后了就连着补发，不跳过也不顺延
+            while (submitted < opt.requests && intended(submitted) <= now) {
+                const uint64_t seq = static_cast<uint64_t>(submitted);
+                const Clock::time_point sendAt = intended(submitted++);
+                r.maxSendLagUs = std::max<int64_t>(
+                    r.maxSendLagUs, std::chrono::duration_cast<std::chrono::microseconds>(now - sendAt).count());
+                client.submit(&seq, sizeof(seq), [&r, seq, sendAt](shmq::AsyncClient::Result&& res) {
+                    // 不用 res.latencyUs（从 submit 算起）：从计划发送时刻算，发送方的排队也算进去
+                    r.latency.record(
+                        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - sendAt).count());
+                    r.attempts += res.attempts;
+                    if (res.status == shmq::AsyncClient::Status::Ok) {
+                        uint64_t echoed = ~0ull;
+                        std::memcpy(&echoed, res.reply.data(), sizeof(echoed));
+                        if (res.reply.size() != sizeof(seq) || echoed != seq) ++r.wrongReplies;
+                    }
+                });
+            }
+            // poll 的等待是毫秒粒度：离下一个到达不足 1ms 时只收已到的回复，再短睡一下，
+            // 既不空转抢 worker 的 CPU，回复也最多晚 ~50us 被记录
+            if (submitted == opt.requests) {
+                completed += client.poll(10);
+                continue;
+            }
+            const auto gap = intended(submitted) - Clock::now();
+            const int waitMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(gap).count());
+            completed += client.poll(std::max(0, waitMs));
+            if (waitMs <= 0)
+                std::this_thread::sleep_for(std::min<Clock::duration>(gap, std::chrono::microseconds(50)));
+        }
+        r.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+        r.stats = client.stats();
+        r.hedgeThresholdUs = client.firstAttemptLatency().valueAtPercentile(policy.hedgePercentile);
+    }
+
+    // 还在处理被放弃副本的 worker 处理完才会看到 stop
+    shmq::Push stop(arena, kService);
+    for (int w = 0; w < opt.workers; ++w) {
+        shmq::Message m = arena.alloc(0);
+        m.setTag(kStopTag);
+        stop.send(std::move(m));
+    }
+    for (pid_t pid : workers) wait_ok(pid);
+    return r;
+}
+
+// ================= 3. main =================
+
+static void usage(const char* prog) {
+    std::fprintf(stderr,
+                 "usage: %s [--requests N] [--rate REQ_PER_S] [--workers W] [--service-us US]\n"
+                 "          [--slow-prob P] [--slow-ms MS] [--deadline-ms MS] [--retry-ms MS] [--budget R]\n"
+                 "          [--slots N]\n",
+                 prog);
+}
+
+int main(int argc, char** argv) {
+    // 子进程会继承 fork 时未刷出的 stdout 缓冲
+    std::setvbuf(stdout, nullptr, _IONBF, 0);
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                usage(argv[0]);
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        if (!std::strcmp(argv[i], "--requests")) opt.requests = std::atoi(next());
+        else if (!std::strcmp(argv[i], "--rate")) opt.rate = std::atof(next());
+        else if (!std::strcmp(argv[i], "--workers")) opt.workers = std::atoi(next());
+        else if (!std::strcmp(argv[i], "--service-us")) opt.serviceUs = std::atoi(next());
+        else if (!std::strcmp(argv[i], "--slow-prob")) opt.slowProb = std::atof(next());
+        else if (!std::strcmp(argv[i], "--slow-ms")) opt.slowMs = std::atoi(next());
+        else if (!std::strcmp(argv[i], "--deadline-ms")) opt.deadlineMs = std::atoi(next());
+        else if (!std::strcmp(argv[i], "--retry-ms")) opt.retryMs = std::atoi(next());
+        else if (!std::strcmp(argv[i], "--budget")) opt.budgetRatio = std::atof(next());
+        else if (!std::strcmp(argv[i], "--slots")) opt.slots = std::atoi(next());
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    // 每个 worker 结束时要拿到一条 stop 消息，槽数至少要能同时放下它们
+    if (opt.requests <= 0 || !(opt.rate > 0) || opt.workers <= 0 || opt.slots < opt.workers) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::printf("requests=%d rate=%.0f/s (open loop) workers=%d service=%dus slow=%.1f%% x %dms deadline=%dms budget=%.2f "
+                "slots=%d, %u hardware threads\n\n",
+                opt.requests, opt.rate, opt.workers, opt.serviceUs, opt.slowProb * 100, opt.slowMs,
+                opt.deadlineMs, opt.budgetRatio, opt.slots, std::thread::hardware_concurrency());
+
+    shmq::Policy base;
+    base.deadlineMs = opt.deadlineMs;
+    base.budgetRatio = opt.budgetRatio;
+
+    struct Case {
+        const char* label;
+        shmq::Policy policy;
+    };
+    std::vector<Case> cases(4, Case{"", base});
+    cases[0].label = "baseline";
+    cases[1].label = "retry";
+    cases[1].policy.attemptTimeoutMs = opt.retryMs;
+    cases[2].label = "hedge@p95";
+    cases[2].policy.hedge = true;
+    cases[3].label = "hedge+retry";
+    cases[3].policy.hedge = true;
+    cases[3].policy.attemptTimeoutMs = opt.retryMs;
+
+    std::vector<RunResult> results;
+    bool ok = true;
+    for (const Case& c : cases) {
+        results.push_back(run_policy(opt, c.policy, c.label));
+        const RunResult& r = results.back();
+        const auto& s = r.stats;
+        r.latency.print(c.label);
+        std::printf("%-22s req/s=%8.0f maxSendLag=%lldus attempts/req=%.3f hedges=%lld retries=%lld budgetDenied=%lld "
+                    "slotDenied=%lld slotDelayed=%lld deadlineMiss=%lld late=%lld",
+                    "", opt.requests / r.seconds, static_cast<long long>(r.maxSendLagUs), static_cast<double>(r.attempts) / opt.requests,
+                    static_cast<long long>(s.hedges), static_cast<long long>(s.retries),
+                    static_cast<long long>(s.budgetDenied), static_cast<long long>(s.slotDenied),
+                    static_cast<long long>(s.slotDelayed), static_cast<long long>(s.deadlineExceeded),
+                    static_cast<long long>(s.lateReplies));
+        if (c.policy.hedge) std::printf(" hedgeAt=%lldus", static_cast<long long>(r.hedgeThresholdUs));
+        std::printf("\n");
+        if (r.wrongReplies || s.ok + s.deadlineExceeded != opt.requests) {
+            std::printf("%-22s ❌ %lld wrong replies, %lld results for %d requests\n", "",
+                        static_cast<long long>(r.wrongReplies), static_cast<long long>(s.ok + s.deadlineExceeded),
+                        opt.requests);
+            ok = false;
+        }
+    }
+
+    // 不只看 p99：对冲 / 重试可能让 p90、p95 变差，全部列出来
+    const double pcts[] = {50, 90, 95, 99, 99.9};
+    std::printf("\n各分位数相对 baseline（us，括号里是 baseline / 该策略，< 1 表示变慢）：\n");
+    const RunResult& b = results[0];
+    for (size_t i = 1; i < cases.size(); ++i) {
+        const RunResult& r = results[i];
+        std::string worse;
+        std::printf("  %-12s", cases[i].label);
+        for (double p : pcts) {
+            const int64_t bv = b.latency.valueAtPercentile(p), rv = r.latency.valueAtPercentile(p);
+            std::printf(" p%-4g %6lld -> %-6lld(%.2fx)", p, static_cast<long long>(bv), static_cast<long long>(rv),
+                        static_cast<double>(bv) / std::max<int64_t>(1, rv));
+            if (rv > bv * 1.1) {
+                char buf[48];
+                std::snprintf(buf, sizeof(buf), " p%g %+.0f%%", p, 100.0 * (rv - bv) / std::max<int64_t>(1, bv));
+                worse += buf;
+            }
+        }
+        std::printf("  额外副本 %+.1f%%\n", 100.0 * (r.stats.hedges + r.stats.retries) / opt.requests);
+        if (!worse.empty()) std::printf("  %-12s ⚠️ 比 baseline 慢 10%% 以上：%s\n", "", worse.c_str() + 1);
+    }
+    std::printf("\n%s\n", ok ? "✅ 所有回复和请求号一致" : "❌ 回复校验失败");
+    return ok ? 0 : 1;
+}
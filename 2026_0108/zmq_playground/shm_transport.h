@@ -0,0 +1,556 @@
+#pragma once
+
+// 本机用的 ZMQ 替代品（header-only）：REQ/REP、ROUTER/DEALER、PUSH/PULL，线程之间和进程之间都能用。
+//
+// 结构（全部放在一块 POSIX 共享内存里）：
+//   - 消息槽（slot）：固定大小，消息体直接写在共享内存里。发送/接收只传 32 位的槽号（“零拷贝句柄”），
+//     收到的一方原地读，回复时可以直接改写同一个槽再发回去
+//   - 队列：有界 MPMC 无锁环形队列（Vyukov 的 per-cell 序号方案），元素就是槽号。
+//     每个队列相当于一个“地址”（ZMQ 的 endpoint），多个生产者 / 多个消费者都可以
+//   - 空闲槽也放在一个同样的 MPMC 队列里；队列容量 >= 槽数，所以往队列里放永远不会满
+//   - 等待：先自旋一小会儿，再用 futex 睡眠（不带 FUTEX_PRIVATE_FLAG，跨进程有效）；
+//     生产者只有在有人睡着时才做 FUTEX_WAKE 系统调用
+//
+// 套接字（都是进程内的小对象，只记着队列号）：
+//   Push(q) / Pull(q)            ：往 q 放 / 从 q 取；多个 Pull 读同一个 q 就是负载均衡
+//   Req(service, inbox) / Rep(service)
+//                                ：Req 发出的消息带上自己的 inbox，Rep 记住它并把回复放回去；
+//                                  和 ZMQ 一样有严格的 send -> recv 状态机，违反时抛 std::logic_error
+//   Dealer(router, inbox) / Router(inbox)
+//                                ：Dealer 的 identity 就是它的 inbox 号；Router 收到的消息 from() 是 identity，
+//                                  send(identity, msg) 放进那个 Dealer 的 inbox
+// 和 ZMQ 的差别：没有 multipart（消息头里有一个 tag 字段代替 b"ADD" / b"STOP" 这类类型帧）；
+// 队列号由程序自己分配（相当于事先约定好的端口号）。
+// tag 完全归应用：Req/Rep 配对用的请求号在消息头里单独一个 seq 字段，Req 盖上、Rep 带回，不碰 tag。
+//
+// 用法：
+//   auto arena = shmq::Arena::create("/shmq.demo", {});        // 或 Arena::open(name)（另一个进程），fork 也行
+//   （同名的共享内存已存在时 create 抛异常；确定要覆盖就传 replaceExisting = true）
+//   （Message 和套接字都引用 arena，建好之后不要再移动它）
+//   shmq::Req req(arena, 0, 1);  shmq::Rep rep(arena, 0);
+//   shmq::Message m = arena.alloc(5);  std::memcpy(m.data(), "hello", 5);
+//   req.send(std::move(m));  ...  rep.recv(m);  rep.send(std::move(m));  ...  req.recv(m, timeoutMs);
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace shmq {
+
+struct Config {
+    uint32_t numQueues = 16;   // 可用的“地址”个数：队列号 0 .. numQueues-1
+    uint32_t numSlots = 4096;  // 同时在途的消息上限
+    uint32_t slotBytes = 4096; // 每个槽的大小（含 64 字节消息头）
+};
+
+namespace detail {
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#endif
+}
+
+inline long futexWait(std::atomic<uint32_t>* addr, uint32_t expect, const timespec* rel) {
+    return ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT, expect, rel, nullptr, 0);
+}
+
+inline void futexWake(std::atomic<uint32_t>* addr, int n) {
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE, n, nullptr, nullptr, 0);
+}
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32-bit integer");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory atomics must be lock-free");
+
+struct Cell {
+    std::atomic<uint64_t> seq;
+    uint64_t value;
+};
+
+struct QueueHeader {
+    alignas(64) std::atomic<uint64_t> tail;
+    alignas(64) std::atomic<uint64_t> head;
+    alignas(64) std::atomic<uint32_t> futexSeq;  // 每次唤醒前 +1，睡眠方拿它做 FUTEX_WAIT 的期望值
+    std::atomic<uint32_t> waiters;               // 正在（或准备）睡眠的消费者数
+    uint64_t mask;
+};
+
+// 共享内存里一个队列的视图：QueueHeader 后面紧跟 mask+1 个 Cell
+class MpmcQueue {
+public:
+    MpmcQueue() = default;
+    explicit MpmcQueue(void* at) : h_(static_cast<QueueHeader*>(at)), cells_(reinterpret_cast<Cell*>(h_ + 1)) {}
+
+    static size_t bytesFor(uint64_t capacity) { return sizeof(QueueHeader) + capacity * sizeof(Cell); }
+
+    // 只在创建共享内存时调用一次；capacity 必须是 2 的幂
+    void init(uint64_t capacity) {
+        new (h_) QueueHeader();
+        h_->tail.store(0, std::memory_order_relaxed);
+        h_->head.store(0, std::memory_order_relaxed);
+        h_->futexSeq.store(0, std::memory_order_relaxed);
+        h_->waiters.store(0, std::memory_order_relaxed);
+        h_->mask = capacity - 1;
+        for (uint64_t i = 0; i < capacity; ++i) {
+            new (&cells_[i]) Cell();
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(uint64_t v) {
+        uint64_t pos = h_->tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& c = cells_[pos & h_->mask];
+            const int64_t dif = static_cast<int64_t>(c.seq.load(std::memory_order_acquire) - pos);
+            if (dif == 0) {
+                if (h_->tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    c.value = v;
+                    c.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (dif < 0) {
+                return false;  // 满
+            } else {
+                pos = h_->tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(uint64_t& v) {
+        uint64_t pos = h_->head.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& c = cells_[pos & h_->mask];
+            const int64_t dif = static_cast<int64_t>(c.seq.load(std::memory_order_acquire) - (pos + 1));
+            if (dif == 0) {
+                if (h_->head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    v = c.value;
+                    c.seq.store(pos + h_->mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (dif < 0) {
+                return false;  // 空
+            } else {
+                pos = h_->head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 放进去并在有人睡眠时唤醒一个。容量 >= 槽数时不会满；万一满了就让出 CPU 重试
+    void push(uint64_t v) {
+        while (!tryPush(v)) ::sched_yield();
+        // 与 pop 里的 waiters.fetch_add 配对：要么我看到 waiters > 0，要么对方在睡前的 tryPop 里看到这条数据
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (h_->waiters.load(std::memory_order_relaxed) > 0) {
+            h_->futexSeq.fetch_add(1, std::memory_order_release);
+            futexWake(&h_->futexSeq, 1);
+        }
+    }
+
+    // timeoutMs < 0 表示一直等；超时返回 false
+    bool pop(uint64_t& v, int timeoutMs) {
+        for (int i = 0; i < kSpin; ++i) {
+            if (tryPop(v)) return true;
+            cpuRelax();
+        }
+        if (timeoutMs == 0) return tryPop(v);
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        for (;;) {
+            h_->waiters.fetch_add(1, std::memory_order_seq_cst);
+            const uint32_t seq = h_->futexSeq.load(std::memory_order_acquire);
+            if (tryPop(v)) {
+                h_->waiters.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+            timespec rel{};
+            const timespec* relp = nullptr;
+            if (timeoutMs >= 0) {
+                auto left = deadline - std::chrono::steady_clock::now();
+                if (left <= std::chrono::nanoseconds(0)) {
+                    h_->waiters.fetch_sub(1, std::memory_order_relaxed);
+                    return tryPop(v);
+                }
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+                rel.tv_sec = ns / 1000000000;
+                rel.tv_nsec = ns % 1000000000;
+                relp = &rel;
+            }
+            futexWait(&h_->futexSeq, seq, relp);  // 被唤醒、超时、或 seq 已变都会返回，统一回到循环开头重试
+            h_->waiters.fetch_sub(1, std::memory_order_relaxed);
+            if (tryPop(v)) return true;
+        }
+    }
+
+private:
+    static constexpr int kSpin = 64;
+    QueueHeader* h_ = nullptr;
+    Cell* cells_ = nullptr;
+};
+
+struct ArenaHeader {
+    uint64_t magic;
+    uint64_t totalBytes;
+    Config cfg;
+    uint64_t queueCap;
+    uint64_t queueBytes;
+    uint64_t queuesOff;  // numQueues 个用户队列 + 1 个空闲槽队列
+    uint64_t slotsOff;
+};
+
+constexpr uint64_t kMagic = 0x73686d7131ull;  // "shmq1"
+
+inline uint64_t roundUp(uint64_t x, uint64_t a) { return (x + a - 1) / a * a; }
+
+inline uint64_t nextPow2(uint64_t x) {
+    uint64_t p = 1;
+    while (p < x) p <<= 1;
+    return p;
+}
+
+}  // namespace detail
+
+// 槽开头的消息头；消息体从第 64 字节开始（cache line 对齐）
+struct MsgHeader {
+    uint32_t size;  // 消息体字节数
+    uint32_t from;  // 发送方的 inbox 队列号（Rep / Router 靠它回复）；没有时为 kNoQueue
+    uint32_t tag;   // 应用自定义的消息类型，传输层不改
+    uint32_t seq;   // Req 的请求号，Rep 回复时带回；Req 据此丢掉迟到的旧回复。其余套接字不用
+};
+
+constexpr uint32_t kNoQueue = 0xffffffffu;
+constexpr size_t kMsgHeaderBytes = 64;
+
+class Arena;
+
+// 一个槽的所有权。只能移动；析构时若还拿着槽就还回空闲队列
+class Message {
+public:
+    Message() = default;
+    Message(const Message&) = delete;
+    Message& operator=(const Message&) = delete;
+    Message(Message&& o) noexcept : arena_(o.arena_), slot_(o.slot_) { o.arena_ = nullptr; }
+    Message& operator=(Message&& o) noexcept {
+        if (this != &o) {
+            release();
+            arena_ = o.arena_;
+            slot_ = o.slot_;
+            o.arena_ = nullptr;
+        }
+        return *this;
+    }
+    ~Message() { release(); }
+
+    bool valid() const { return arena_ != nullptr; }
+    char* data();
+    const char* data() const;
+    size_t size() const { return header()->size; }
+    size_t capacity() const;
+    void resize(size_t n);
+    uint32_t tag() const { return header()->tag; }
+    void setTag(uint32_t t) { header()->tag = t; }
+    uint32_t from() const { return header()->from; }
+    uint32_t slot() const { return slot_; }
+    void release();
+
+private:
+    friend class Arena;
+    friend class Req;
+    friend class Rep;
+    Message(Arena* a, uint32_t slot) : arena_(a), slot_(slot) {}
+    MsgHeader* header();
+    const MsgHeader* header() const;
+    uint32_t detach() {
+        arena_ = nullptr;
+        return slot_;
+    }
+
+    Arena* arena_ = nullptr;
+    uint32_t slot_ = 0;
+};
+
+class Arena {
+public:
+    // 建一块新的共享内存。同名的已存在时抛 std::system_error(EEXIST)：它可能正被别的进程使用，
+    // 静默 unlink 会让双方各用一块、互相收不到消息。确定是上次崩溃留下的才传 replaceExisting = true
+    static Arena create(const std::string& name, const Config& cfg, bool replaceExisting = false) {
+        if (cfg.numQueues == 0 || cfg.numSlots == 0 || cfg.slotBytes <= kMsgHeaderBytes)
+            throw std::invalid_argument("shmq: bad Config");
+        detail::ArenaHeader h{};
+        h.magic = detail::kMagic;
+        h.cfg = cfg;
+        h.cfg.slotBytes = static_cast<uint32_t>(detail::roundUp(cfg.slotBytes, 64));
+        h.queueCap = detail::nextPow2(cfg.numSlots);
+        h.queueBytes = detail::roundUp(detail::MpmcQueue::bytesFor(h.queueCap), 64);
+        h.queuesOff = detail::roundUp(sizeof(detail::ArenaHeader), 64);
+        h.slotsOff = detail::roundUp(h.queuesOff + h.queueBytes * (cfg.numQueues + 1), 4096);
+        h.totalBytes = h.slotsOff + static_cast<uint64_t>(h.cfg.slotBytes) * cfg.numSlots;
+
+        if (replaceExisting) ::shm_unlink(name.c_str());
+        int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+        if (::ftruncate(fd, static_cast<off_t>(h.totalBytes)) != 0) {
+            int e = errno;
+            ::close(fd);
+            throw std::system_error(e, std::generic_category(), "ftruncate " + name);
+        }
+        Arena a = mapFd(fd, h.totalBytes, name);
+        std::memcpy(a.base_, &h, sizeof(h));
+        a.bind();
+        for (uint32_t q = 0; q <= cfg.numQueues; ++q) a.queue(q).init(h.queueCap);
+        for (uint32_t s = 0; s < cfg.numSlots; ++s) a.freeList().tryPush(s);
+        return a;
+    }
+
+    // 另一个进程按名字打开已有的共享内存
+    static Arena open(const std::string& name) {
+        int fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd < 0) throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+        detail::ArenaHeader h{};
+        if (::pread(fd, &h, sizeof(h), 0) != static_cast<ssize_t>(sizeof(h)) || h.magic != detail::kMagic) {
+            ::close(fd);
+            throw std::runtime_error("shmq: " + name + " is not an arena");
+        }
+        Arena a = mapFd(fd, h.totalBytes, name);
+        a.bind();
+        return a;
+    }
+
+    // 所有进程都映射好之后即可 unlink，名字消失，内存随最后一个进程退出回收
+    static void unlink(const std::string& name) { ::shm_unlink(name.c_str()); }
+
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena(Arena&& o) noexcept { *this = std::move(o); }
+    Arena& operator=(Arena&& o) noexcept {
+        std::swap(base_, o.base_);
+        std::swap(bytes_, o.bytes_);
+        std::swap(hdr_, o.hdr_);
+        return *this;
+    }
+    ~Arena() {
+        if (base_) ::munmap(base_, bytes_);
+    }
+
+    uint32_t numQueues() const { return hdr_->cfg.numQueues; }
+    size_t maxMessageBytes() const { return hdr_->cfg.slotBytes - kMsgHeaderBytes; }
+
+    // 取一个空闲槽；槽全被占用时等到有人释放（timeoutMs < 0 一直等），超时返回 !valid() 的消息
+    Message alloc(size_t bytes, int timeoutMs = -1) {
+        if (bytes > maxMessageBytes())
+            throw std::length_error("shmq: message of " + std::to_string(bytes) + " bytes exceeds slot size");
+        uint64_t slot;
+        if (!freeList().pop(slot, timeoutMs)) return Message();
+        MsgHeader* mh = headerOf(static_cast<uint32_t>(slot));
+        mh->size = static_cast<uint32_t>(bytes);
+        mh->from = kNoQueue;
+        mh->tag = 0;
+        mh->seq = 0;
+        return Message(this, static_cast<uint32_t>(slot));
+    }
+
+    // 把消息放进队列 q，所有权随之转移
+    void post(uint32_t q, Message&& m, uint32_t from) {
+        checkQueue(q);
+        if (!m.valid()) throw std::invalid_argument("shmq: posting an empty message");
+        headerOf(m.slot())->from = from;
+        queue(q).push(m.detach());
+    }
+
+    // 从队列 q 取一条消息；超时返回 false
+    bool take(uint32_t q, Message& out, int timeoutMs) {
+        checkQueue(q);
+        uint64_t slot;
+        if (!queue(q).pop(slot, timeoutMs)) return false;
+        out = Message(this, static_cast<uint32_t>(slot));
+        return true;
+    }
+
+private:
+    friend class Message;
+
+    static Arena mapFd(int fd, uint64_t bytes, const std::string& name) {
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        int e = errno;
+        ::close(fd);
+        if (p == MAP_FAILED) throw std::system_error(e, std::generic_category(), "mmap " + name);
+        Arena a;
+        a.base_ = static_cast<char*>(p);
+        a.bytes_ = bytes;
+        return a;
+    }
+
+    void bind() { hdr_ = reinterpret_cast<detail::ArenaHeader*>(base_); }
+
+    void checkQueue(uint32_t q) const {
+        if (q >= hdr_->cfg.numQueues) throw std::out_of_range("shmq: queue " + std::to_string(q) + " out of range");
+    }
+
+    detail::MpmcQueue queue(uint32_t q) const { return detail::MpmcQueue(base_ + hdr_->queuesOff + hdr_->queueBytes * q); }
+    detail::MpmcQueue freeList() const { return queue(hdr_->cfg.numQueues); }
+
+    char* slotPtr(uint32_t s) const { return base_ + hdr_->slotsOff + static_cast<uint64_t>(hdr_->cfg.slotBytes) * s; }
+    MsgHeader* headerOf(uint32_t s) const { return reinterpret_cast<MsgHeader*>(slotPtr(s)); }
+
+    void freeSlot(uint32_t s) { freeList().push(s); }
+
+    char* base_ = nullptr;
+    uint64_t bytes_ = 0;
+    detail::ArenaHeader* hdr_ = nullptr;
+};
+
+inline char* Message::data() { return arena_->slotPtr(slot_) + kMsgHeaderBytes; }
+inline const char* Message::data() const { return arena_->slotPtr(slot_) + kMsgHeaderBytes; }
+inline size_t Message::capacity() const { return arena_->maxMessageBytes(); }
+inline MsgHeader* Message::header() { return arena_->headerOf(slot_); }
+inline const MsgHeader* Message::header() const { return arena_->headerOf(slot_); }
+
+inline void Message::resize(size_t n) {
+    if (n > capacity()) throw std::length_error("shmq: resize beyond slot size");
+    header()->size = static_cast<uint32_t>(n);
+}
+
+inline void Message::release() {
+    if (arena_) {
+        arena_->freeSlot(slot_);
+        arena_ = nullptr;
+    }
+}
+
+// ================= 套接字 =================
+
+class Push {
+public:
+    Push(Arena& a, uint32_t q) : a_(a), q_(q) {}
+    void send(Message&& m) { a_.post(q_, std::move(m), kNoQueue); }
+
+private:
+    Arena& a_;
+    uint32_t q_;
+};
+
+class Pull {
+public:
+    Pull(Arena& a, uint32_t q) : a_(a), q_(q) {}
+    bool recv(Message& m, int timeoutMs = -1) { return a_.take(q_, m, timeoutMs); }
+
+private:
+    Arena& a_;
+    uint32_t q_;
+};
+
+// 严格交替：send, recv, send, recv ...；recv 超时后状态不变，可以继续等，也可以 reset() 放弃这次请求
+// （相当于 req_rep_timeout_retry_client.py 里“重建 REQ socket”，迟到的回复由下一次 recv 丢弃）
+class Req {
+public:
+    Req(Arena& a, uint32_t service, uint32_t inbox) : a_(a), service_(service), inbox_(inbox) {}
+
+    void send(Message&& m) {
+        if (awaiting_) throw std::logic_error("shmq::Req: send() while a reply is outstanding");
+        m.header()->seq = ++seq_;
+        a_.post(service_, std::move(m), inbox_);
+        awaiting_ = true;
+    }
+
+    bool recv(Message& m, int timeoutMs = -1) {
+        if (!awaiting_) throw std::logic_error("shmq::Req: recv() without a request");
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(timeoutMs, 0));
+        for (;;) {
+            int left = timeoutMs;
+            if (timeoutMs >= 0) {
+                auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+                left = static_cast<int>(std::max<int64_t>(0, ms.count()));
+            }
+            if (!a_.take(inbox_, m, left)) return false;
+            // Rep 把请求号原样带回；对不上的是之前放弃掉的请求的迟到回复
+            if (m.header()->seq == seq_) break;
+            m.release();
+        }
+        awaiting_ = false;
+        return true;
+    }
+
+    void reset() { awaiting_ = false; }
+    uint32_t inbox() const { return inbox_; }
+
+private:
+    Arena& a_;
+    uint32_t service_, inbox_;
+    uint32_t seq_ = 0;
+    bool awaiting_ = false;
+};
+
+// 严格交替：recv, send, recv, send ...；多个 Rep 读同一个 service 队列就是多个 worker
+class Rep {
+public:
+    Rep(Arena& a, uint32_t service) : a_(a), service_(service) {}
+
+    bool recv(Message& m, int timeoutMs = -1) {
+        if (replyTo_ != kNoQueue) throw std::logic_error("shmq::Rep: recv() before replying");
+        if (!a_.take(service_, m, timeoutMs)) return false;
+        replyTo_ = m.from();
+        seq_ = m.header()->seq;
+        return true;
+    }
+
+    // 回复可以就是收到的那条消息（原地改写，零拷贝，tag 也一并留着），也可以是新 alloc 的（tag 由调用方设）
+    void send(Message&& m) {
+        if (replyTo_ == kNoQueue) throw std::logic_error("shmq::Rep: send() without a request");
+        m.header()->seq = seq_;
+        a_.post(replyTo_, std::move(m), service_);
+        replyTo_ = kNoQueue;
+    }
+
+private:
+    Arena& a_;
+    uint32_t service_;
+    uint32_t replyTo_ = kNoQueue;
+    uint32_t seq_ = 0;
+};
+
+// identity = inbox 队列号（对应 vLLM 里 engine 设置的 IDENTITY）
+class Dealer {
+public:
+    Dealer(Arena& a, uint32_t router, uint32_t inbox) : a_(a), router_(router), inbox_(inbox) {}
+    void send(Message&& m) { a_.post(router_, std::move(m), inbox_); }
+    bool recv(Message& m, int timeoutMs = -1) { return a_.take(inbox_, m, timeoutMs); }
+    uint32_t identity() const { return inbox_; }
+
+private:
+    Arena& a_;
+    uint32_t router_, inbox_;
+};
+
+class Router {
+public:
+    Router(Arena& a, uint32_t inbox) : a_(a), inbox_(inbox) {}
+    // 收到的 m.from() 就是发送方 Dealer 的 identity
+    bool recv(Message& m, int timeoutMs = -1) { return a_.take(inbox_, m, timeoutMs); }
+    void send(uint32_t identity, Message&& m) { a_.post(identity, std::move(m), inbox_); }
+
+private:
+    Arena& a_;
+    uint32_t inbox_;
+};
+
+}  // namespace shmq
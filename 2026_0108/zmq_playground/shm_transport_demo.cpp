@@ -0,0 +1,371 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "shm_transport.h"
+
+// shm_transport.h 的 demo + benchmark：把本目录几个 pyzmq demo 的拓扑用共享内存传输重做一遍。
+//   1) REQ/REP（req_rep_basic_*.py）：跨进程 ping-pong，以及 REQ 状态机
+//   2) ROUTER/DEALER + PUSH/PULL（router_dealer_two_engines_roundrobin_demo.py）：
+//      前端 Router 收集 2 个 engine 的 identity，round-robin 发请求，engine 通过 PUSH 回输出
+//   3) bench：三种模式的 msgs/s 与延迟分位数，和 zmq_bench.py（pyzmq，ipc://）输出同样格式
+//
+// 编译运行：
+//   g++ -O3 -std=c++17 -pthread shm_transport_demo.cpp -o shm_transport_demo
+//   ./shm_transport_demo                         # 功能 demo
+//   ./shm_transport_demo bench [msgs] [bytes]    # 默认 100000 条、64 字节
+//   python3 zmq_bench.py --msgs 100000 --size 64 # pyzmq 对照
+
+using Clock = std::chrono::steady_clock;
+
+// steady_clock 在 Linux 上是 CLOCK_MONOTONIC，全系统共用，跨进程比较时间戳没问题
+static int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+enum Tag : uint32_t { kRegister = 1, kAdd = 2, kOutput = 3, kStop = 4 };
+
+// fork 一个子进程跑 fn，返回 pid；子进程里 fn 返回值就是退出码
+static pid_t spawn(const std::function<int()>& fn) {
+    pid_t pid = ::fork();
+    if (pid < 0) {
+        std::perror("fork");
+        std::exit(1);
+    }
+    if (pid == 0) {
+        int rc = fn();
+        std::fflush(stdout);
+        ::_exit(rc);
+    }
+    return pid;
+}
+
+static bool wait_ok(pid_t pid) {
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static std::string arena_name(const char* what) { return "/shmq." + std::string(what) + "." + std::to_string(::getpid()); }
+
+static shmq::Message make_text(shmq::Arena& arena, const std::string& s) {
+    shmq::Message m = arena.alloc(s.size());
+    std::memcpy(m.data(), s.data(), s.size());
+    return m;
+}
+
+static std::string text_of(const shmq::Message& m) { return std::string(m.data(), m.size()); }
+
+// ================= 1. REQ/REP =================
+
+static bool demo_req_rep() {
+    const std::string name = arena_name("reqrep");
+    shmq::Arena arena = shmq::Arena::create(name, {});
+    shmq::Arena::unlink(name);  // fork 继承映射，名字用不着了
+    const uint32_t kService = 0, kClientInbox = 1;
+
+    pid_t server = spawn([&] {
+        shmq::Rep rep(arena, kService);
+        shmq::Message m;
+        for (int i = 0; i < 3; ++i) {
+            if (!rep.recv(m, 5000)) return 1;
+            std::printf("[server] recv: '%s'\n", text_of(m).c_str());
+            std::string reply = "pong: " + text_of(m);
+            m.resize(reply.size());  // 原地改写收到的槽，零拷贝回复
+            std::memcpy(m.data(), reply.data(), reply.size());
+            rep.send(std::move(m));
+        }
+        return 0;
+    });
+
+    bool ok = true;
+    shmq::Req req(arena, kService, kClientInbox);
+    bool tagKept = true;
+    for (int i = 0; i < 3; ++i) {
+        // tag 归应用：Req/Rep 的请求号在单独的 seq 字段里，原地回复时 tag 原样回来
+        shmq::Message m = make_text(arena, "ping " + std::to_string(i));
+        m.setTag(kAdd);
+        req.send(std::move(m));
+        shmq::Message reply;
+        ok &= req.recv(reply, 5000);
+        if (reply.valid()) std::printf("[client] recv: '%s'\n", text_of(reply).c_str());
+        tagKept &= reply.valid() && reply.tag() == kAdd;
+    }
+    ok &= wait_ok(server);
+    std::printf("%s caller's tag survives REQ -> REP -> REQ\n", tagKept ? "✅" : "❌");
+    ok &= tagKept;
+
+    // 同名共享内存已存在：create 默认拒绝（不去 unlink 别人可能正在用的那块），显式 replaceExisting 才覆盖
+    {
+        const std::string dup = arena_name("dup");
+        shmq::Arena first = shmq::Arena::create(dup, {});
+        bool refused = false;
+        try {
+            shmq::Arena second = shmq::Arena::create(dup, {});
+        } catch (const std::system_error& e) {
+            refused = e.code().value() == EEXIST;
+        }
+        shmq::Arena replaced = shmq::Arena::create(dup, {}, true);
+        shmq::Arena::unlink(dup);
+        std::printf("%s create() on an existing name fails with EEXIST unless replaceExisting\n",
+                    refused ? "✅" : "❌");
+        ok &= refused;
+    }
+
+    // REQ 状态机：没收到回复前再次 send 是错误（ZMQ 里是 EFSM）
+    req.send(make_text(arena, "nobody answers"));
+    try {
+        req.send(make_text(arena, "again"));
+        std::printf("❌ REQ allowed two sends in a row\n");
+        ok = false;
+    } catch (const std::logic_error& e) {
+        std::printf("✅ REQ state machine: %s\n", e.what());
+    }
+    shmq::Message none;
+    bool got = req.recv(none, 50);
+    std::printf("%s recv timeout after 50 ms returns false\n", got ? "❌" : "✅");
+    ok &= !got;
+    std::printf("%s REQ/REP across processes\n", ok ? "✅" : "❌");
+    return ok;
+}
+
+// ================= 2. ROUTER/DEALER + PUSH/PULL，2 个 engine round-robin =================
+
+static bool demo_router_dealer() {
+    const std::string name = arena_name("router");
+    shmq::Arena arena = shmq::Arena::create(name, {});
+    shmq::Arena::unlink(name);
+    const uint32_t kRouter = 0, kPull = 1;
+    const int kEngines = 2, kRequests = 10;
+
+    std::vector<std::thread> engines;
+    for (int e = 0; e < kEngines; ++e) {
+        engines.emplace_back([&, e] {
+            shmq::Dealer dealer(arena, kRouter, 2 + e);  // identity = inbox 队列号
+            shmq::Push push(arena, kPull);
+            shmq::Message reg = arena.alloc(0);
+            reg.setTag(kRegister);
+            dealer.send(std::move(reg));
+            for (shmq::Message m; dealer.recv(m, 10000);) {
+                if (m.tag() == kStop) return;
+                std::string out = text_of(m) + " engine=" + std::to_string(e) + " id=" + std::to_string(dealer.identity());
+                // 输出走 PUSH/PULL，不带 identity，所以 engine 标识放进消息体
+                m.resize(out.size());
+                std::memcpy(m.data(), out.data(), out.size());
+                m.setTag(kOutput);
+                push.send(std::move(m));
+            }
+        });
+    }
+
+    shmq::Router router(arena, kRouter);
+    shmq::Pull pull(arena, kPull);
+    std::vector<uint32_t> ids;
+    for (shmq::Message m; static_cast<int>(ids.size()) < kEngines && router.recv(m, 5000);) {
+        if (m.tag() == kRegister) ids.push_back(m.from());
+    }
+    std::sort(ids.begin(), ids.end());
+    std::vector<int> perEngine(kEngines, 0);
+    for (int i = 0; i < kRequests; ++i) {
+        shmq::Message m = make_text(arena, "r" + std::to_string(i));
+        m.setTag(kAdd);
+        router.send(ids[i % ids.size()], std::move(m));
+    }
+    int received = 0;
+    for (shmq::Message m; received < kRequests && pull.recv(m, 5000); ++received) {
+        std::printf("[frontend] got output %s\n", text_of(m).c_str());
+        int e = text_of(m).find("engine=1") != std::string::npos ? 1 : 0;
+        ++perEngine[e];
+    }
+    for (uint32_t id : ids) {
+        shmq::Message stop = arena.alloc(0);
+        stop.setTag(kStop);
+        router.send(id, std::move(stop));
+    }
+    for (auto& t : engines) t.join();
+    bool ok = received == kRequests && perEngine[0] == kRequests / 2 && perEngine[1] == kRequests / 2;
+    std::printf("%s ROUTER/DEALER round-robin: %d outputs, engine0=%d engine1=%d\n", ok ? "✅" : "❌", received,
+                perEngine[0], perEngine[1]);
+    return ok;
+}
+
+// ================= 3. benchmark =================
+
+static void report(const char* pattern, size_t msgs, size_t bytes, double seconds, std::vector<double>& latUs) {
+    std::sort(latUs.begin(), latUs.end());
+    auto pct = [&](double p) { return latUs.empty() ? 0.0 : latUs[std::min(latUs.size() - 1, static_cast<size_t>(p * latUs.size()))]; };
+    std::printf("%-22s msgs=%-8zu size=%-6zu msgs/s=%10.0f  p50=%8.1f us  p99=%8.1f us\n", pattern, msgs, bytes,
+                msgs / seconds, pct(0.50), pct(0.99));
+}
+
+// REQ/REP：一问一答的往返延迟（跨进程）
+static void bench_req_rep(size_t msgs, size_t bytes) {
+    const std::string name = arena_name("bench_rr");
+    shmq::Arena arena = shmq::Arena::create(name, {});
+    shmq::Arena::unlink(name);
+    pid_t server = spawn([&] {
+        shmq::Rep rep(arena, 0);
+        shmq::Message m;
+        for (size_t i = 0; i < msgs; ++i) {
+            if (!rep.recv(m, 10000)) return 1;
+            rep.send(std::move(m));  // 原样发回：零拷贝
+        }
+        return 0;
+    });
+    shmq::Req req(arena, 0, 1);
+    std::vector<double> lat;
+    lat.reserve(msgs);
+    auto t0 = Clock::now();
+    for (size_t i = 0; i < msgs; ++i) {
+        int64_t s = now_ns();
+        shmq::Message m = arena.alloc(bytes);
+        std::memset(m.data(), 'x', bytes);
+        req.send(std::move(m));
+        if (!req.recv(m, 10000)) break;
+        lat.push_back((now_ns() - s) / 1e3);
+    }
+    double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+    wait_ok(server);
+    report("req_rep (rtt)", lat.size(), bytes, sec, lat);
+}
+
+// PUSH/PULL：producers 个生产者进程、consumers 个消费者线程共用一个队列；延迟是单向的（发送时间戳在消息体里）
+static void bench_push_pull(size_t msgs, size_t bytes, int producers, int consumers) {
+    const std::string name = arena_name("bench_pp");
+    shmq::Arena arena = shmq::Arena::create(name, {});
+    shmq::Arena::unlink(name);
+    bytes = std::max(bytes, sizeof(int64_t));
+    const size_t perProducer = msgs / producers;
+    std::vector<pid_t> pids;
+    auto t0 = Clock::now();
+    for (int p = 0; p < producers; ++p) {
+        pids.push_back(spawn([&] {
+            shmq::Push push(arena, 0);
+            for (size_t i = 0; i < perProducer; ++i) {
+                shmq::Message m = arena.alloc(bytes);
+                int64_t ts = now_ns();
+                std::memcpy(m.data(), &ts, sizeof(ts));
+                push.send(std::move(m));
+            }
+            return 0;
+        }));
+    }
+    const size_t total = perProducer * producers;
+    std::atomic<size_t> taken{0};
+    std::vector<std::vector<double>> lats(consumers);
+    std::vector<std::thread> team;
+    for (int c = 0; c < consumers; ++c) {
+        team.emplace_back([&, c] {
+            shmq::Pull pull(arena, 0);
+            shmq::Message m;
+            // 先占名额再收：保证总共恰好收 total 条，不会有线程空等
+            while (taken.fetch_add(1) < total) {
+                if (!pull.recv(m, 10000)) return;
+                int64_t ts;
+                std::memcpy(&ts, m.data(), sizeof(ts));
+                lats[c].push_back((now_ns() - ts) / 1e3);
+                m.release();
+            }
+        });
+    }
+    for (auto& t : team) t.join();
+    double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+    for (pid_t pid : pids) wait_ok(pid);
+    std::vector<double> all;
+    for (auto& l : lats) all.insert(all.end(), l.begin(), l.end());
+    char label[48];
+    std::snprintf(label, sizeof(label), "push_pull %dx%d", producers, consumers);
+    report(label, all.size(), bytes, sec, all);
+}
+
+// vLLM 拓扑：前端 Router round-robin 发请求给 2 个 engine 进程，engine 经 PUSH 回到前端的 PULL。
+// 前端最多 window 个请求在途；延迟 = 发请求 -> 收到对应输出
+static void bench_router_dealer(size_t msgs, size_t bytes, int window) {
+    const std::string name = arena_name("bench_rd");
+    shmq::Arena arena = shmq::Arena::create(name, {});
+    shmq::Arena::unlink(name);
+    bytes = std::max(bytes, sizeof(int64_t));
+    const uint32_t kRouter = 0, kPull = 1;
+    const int kEngines = 2;
+    std::vector<pid_t> pids;
+    for (int e = 0; e < kEngines; ++e) {
+        pids.push_back(spawn([&, e] {
+            shmq::Dealer dealer(arena, kRouter, 2 + e);
+            shmq::Push push(arena, kPull);
+            shmq::Message reg = arena.alloc(0);
+            reg.setTag(kRegister);
+            dealer.send(std::move(reg));
+            for (shmq::Message m; dealer.recv(m, 10000);) {
+                if (m.tag() == kStop) return 0;
+                m.setTag(kOutput);
+                push.send(std::move(m));  // 时间戳原样带回
+            }
+            return 1;
+        }));
+    }
+    shmq::Router router(arena, kRouter);
+    shmq::Pull pull(arena, kPull);
+    std::vector<uint32_t> ids;
+    for (shmq::Message m; static_cast<int>(ids.size()) < kEngines && router.recv(m, 5000);) ids.push_back(m.from());
+
+    std::vector<double> lat;
+    lat.reserve(msgs);
+    size_t sent = 0, got = 0;
+    auto t0 = Clock::now();
+    while (got < msgs) {
+        while (sent < msgs && sent - got < static_cast<size_t>(window)) {
+            shmq::Message m = arena.alloc(bytes);
+            int64_t ts = now_ns();
+            std::memcpy(m.data(), &ts, sizeof(ts));
+            m.setTag(kAdd);
+            router.send(ids[sent % ids.size()], std::move(m));
+            ++sent;
+        }
+        shmq::Message out;
+        if (!pull.recv(out, 10000)) break;
+        int64_t ts;
+        std::memcpy(&ts, out.data(), sizeof(ts));
+        lat.push_back((now_ns() - ts) / 1e3);
+        ++got;
+    }
+    double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+    for (uint32_t id : ids) {
+        shmq::Message stop = arena.alloc(0);
+        stop.setTag(kStop);
+        router.send(id, std::move(stop));
+    }
+    for (pid_t pid : pids) wait_ok(pid);
+    char label[48];
+    std::snprintf(label, sizeof(label), "router_dealer w=%d", window);
+    report(label, lat.size(), bytes, sec, lat);
+}
+
+// ================= 主函数 =================
+
+int main(int argc, char** argv) {
+    // 子进程会继承 fork 时未刷出的 stdout 缓冲
+    std::setvbuf(stdout, nullptr, _IONBF, 0);
+    if (argc >= 2 && std::strcmp(argv[1], "bench") == 0) {
+        const size_t msgs = argc >= 3 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+        const size_t bytes = argc >= 4 ? std::strtoull(argv[3], nullptr, 10) : 64;
+        std::printf("shm transport, %u hardware threads\n", std::thread::hardware_concurrency());
+        bench_req_rep(msgs, bytes);
+        bench_push_pull(msgs, bytes, 1, 1);
+        bench_push_pull(msgs, bytes, 2, 2);
+        bench_router_dealer(msgs, bytes, 1);
+        bench_router_dealer(msgs, bytes, 64);
+        return 0;
+    }
+    bool ok = demo_req_rep();
+    ok &= demo_router_dealer();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,218 @@
+"""
+pyzmq 版的 benchmark，和 shm_transport_demo.cpp 的 bench 模式测同样三种拓扑、输出同样格式：
+
+    python3 zmq_bench.py --msgs 100000 --size 64
+    g++ -O3 -std=c++17 -pthread shm_transport_demo.cpp -o shm_transport_demo && ./shm_transport_demo bench 100000 64
+
+- req_rep (rtt)      ：REQ/REP 一问一答的往返延迟（跨进程）
+- push_pull PxC      ：P 个 PUSH 进程 -> C 个 PULL（这里 C 个线程在前端进程里），单向延迟（时间戳在消息体里）
+- router_dealer w=W  ：前端 ROUTER round-robin 发给 2 个 engine 进程（DEALER），engine 经 PUSH 回到前端 PULL，
+                       前端最多 W 个请求在途
+
+传输用 ipc://（本机 Unix domain socket，pyzmq 跨进程最快的方式）。
+time.monotonic_ns() 是 CLOCK_MONOTONIC，跨进程可比。
+"""
+
+import argparse
+import multiprocessing as mp
+import os
+import struct
+import tempfile
+import threading
+import time
+
+import zmq
+
+
+def endpoint(name: str) -> str:
+    return f"ipc://{tempfile.gettempdir()}/zmq_bench.{os.getpid()}.{name}"
+
+
+def report(pattern: str, size: int, seconds: float, lat_us: list):
+    lat_us.sort()
+
+    def pct(p):
+        return lat_us[min(len(lat_us) - 1, int(p * len(lat_us)))] if lat_us else 0.0
+
+    print(
+        f"{pattern:<22} msgs={len(lat_us):<8} size={size:<6} msgs/s={len(lat_us) / seconds:10.0f}  "
+        f"p50={pct(0.50):8.1f} us  p99={pct(0.99):8.1f} us",
+        flush=True,
+    )
+
+
+# ================= REQ/REP =================
+
+
+def rep_server(addr: str, msgs: int):
+    ctx = zmq.Context()
+    sock = ctx.socket(zmq.REP)
+    sock.bind(addr)
+    for _ in range(msgs):
+        sock.send(sock.recv(copy=False), copy=False)
+    sock.close(linger=0)
+    ctx.term()
+
+
+def bench_req_rep(msgs: int, size: int):
+    addr = endpoint("reqrep")
+    server = mp.Process(target=rep_server, args=(addr, msgs))
+    server.start()
+    ctx = zmq.Context()
+    sock = ctx.socket(zmq.REQ)
+    sock.connect(addr)
+    payload = b"x" * size
+    lat = []
+    t0 = time.perf_counter()
+    for _ in range(msgs):
+        s = time.monotonic_ns()
+        sock.send(payload)
+        sock.recv(copy=False)
+        lat.append((time.monotonic_ns() - s) / 1e3)
+    sec = time.perf_counter() - t0
+    sock.close(linger=0)
+    ctx.term()
+    server.join()
+    report("req_rep (rtt)", size, sec, lat)
+
+
+# ================= PUSH/PULL =================
+
+
+def bench_push_pull(msgs: int, size: int, producers: int, consumers: int):
+    addr = endpoint("pushpull")
+    ctx = zmq.Context()
+    # 一个 PULL 绑定地址，consumers 个线程通过 inproc 的 PUSH/PULL 再分发会引入额外一跳；
+    # 这里改为每个消费者线程各自 bind 一个 ipc 地址，生产者 connect 全部地址（PUSH 自动轮询分发）
+    addrs = [f"{addr}.{c}" for c in range(consumers)]
+    per = msgs // producers
+    total = per * producers
+    lats = [[] for _ in range(consumers)]
+    counts = [0] * consumers
+    ready = threading.Barrier(consumers + 1)
+    done = threading.Event()
+
+    def consumer(c):
+        sock = ctx.socket(zmq.PULL)
+        sock.bind(addrs[c])
+        ready.wait()
+        poller = zmq.Poller()
+        poller.register(sock, zmq.POLLIN)
+        while not done.is_set():
+            if not poller.poll(100):
+                continue
+            msg = sock.recv(copy=False)
+            (ts,) = struct.unpack_from("<q", msg.buffer)
+            lats[c].append((time.monotonic_ns() - ts) / 1e3)
+            counts[c] += 1
+        sock.close(linger=0)
+
+    team = [threading.Thread(target=consumer, args=(c,)) for c in range(consumers)]
+    for t in team:
+        t.start()
+    ready.wait()
+
+    def producer_main(count):
+        pctx = zmq.Context()
+        sock = pctx.socket(zmq.PUSH)
+        for a in addrs:
+            sock.connect(a)
+        pad = b"x" * max(0, size - 8)
+        for _ in range(count):
+            sock.send(struct.pack("<q", time.monotonic_ns()) + pad)
+        sock.close(linger=-1)
+        pctx.term()
+
+    t0 = time.perf_counter()
+    procs = [mp.Process(target=producer_main, args=(per,)) for _ in range(producers)]
+    for p in procs:
+        p.start()
+    while sum(counts) < total:
+        time.sleep(0.001)
+    sec = time.perf_counter() - t0
+    done.set()
+    for t in team:
+        t.join()
+    for p in procs:
+        p.join()
+    ctx.term()
+    report(f"push_pull {producers}x{consumers}", max(size, 8), sec, [x for l in lats for x in l])
+
+
+# ================= ROUTER/DEALER + PUSH/PULL =================
+
+
+def engine(index: int, router_addr: str, pull_addr: str):
+    ctx = zmq.Context()
+    dealer = ctx.socket(zmq.DEALER)
+    dealer.setsockopt(zmq.IDENTITY, index.to_bytes(2, "little"))
+    dealer.connect(router_addr)
+    push = ctx.socket(zmq.PUSH)
+    push.connect(pull_addr)
+    dealer.send(b"")
+    while True:
+        frames = dealer.recv_multipart(copy=False)
+        if bytes(frames[0].buffer) == b"STOP":
+            break
+        push.send_multipart([b"OUTPUT", frames[1]], copy=False)
+    dealer.close(linger=0)
+    push.close(linger=-1)
+    ctx.term()
+
+
+def bench_router_dealer(msgs: int, size: int, window: int):
+    router_addr, pull_addr = endpoint("router"), endpoint("pull")
+    ctx = zmq.Context()
+    router = ctx.socket(zmq.ROUTER)
+    router.bind(router_addr)
+    pull = ctx.socket(zmq.PULL)
+    pull.bind(pull_addr)
+    engines = [mp.Process(target=engine, args=(i, router_addr, pull_addr)) for i in range(2)]
+    for p in engines:
+        p.start()
+    ids = []
+    while len(ids) < 2:
+        eid, _ = router.recv_multipart()
+        ids.append(eid)
+
+    pad = b"x" * max(0, size - 8)
+    lat = []
+    sent = got = 0
+    t0 = time.perf_counter()
+    while got < msgs:
+        while sent < msgs and sent - got < window:
+            router.send_multipart([ids[sent % 2], b"ADD", struct.pack("<q", time.monotonic_ns()) + pad], copy=False)
+            sent += 1
+        out = pull.recv_multipart(copy=False)
+        (ts,) = struct.unpack_from("<q", out[1].buffer)
+        lat.append((time.monotonic_ns() - ts) / 1e3)
+        got += 1
+    sec = time.perf_counter() - t0
+    for eid in ids:
+        router.send_multipart([eid, b"STOP"])
+    for p in engines:
+        p.join()
+    router.close(linger=0)
+    pull.close(linger=0)
+    ctx.term()
+    report(f"router_dealer w={window}", max(size, 8), sec, lat)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--msgs", type=int, default=100000)
+    parser.add_argument("--size", type=int, default=64)
+    args = parser.parse_args()
+
+    print(f"pyzmq {zmq.pyzmq_version()} / libzmq {zmq.zmq_version()}, ipc://, {os.cpu_count()} cpus", flush=True)
+    bench_req_rep(args.msgs, args.size)
+    bench_push_pull(args.msgs, args.size, 1, 1)
+    bench_push_pull(args.msgs, args.size, 2, 2)
+    bench_router_dealer(args.msgs, args.size, 1)
+    bench_router_dealer(args.msgs, args.size, 64)
+
+
+if __name__ == "__main__":
+    # fork：子进程直接继承上面定义的函数；ipc 地址里带父进程 pid，多次运行互不干扰
+    mp.set_start_method("fork")
+    main()
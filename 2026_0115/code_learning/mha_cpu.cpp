@@ -0,0 +1,544 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../common/simd_isa.h"
+#include "../../common/verify.h"
+
+// mha_triton.py 的 CPU 版：同样的 online softmax（FlashAttention 式）MHA forward，跑在没有 GPU 的推理机上。
+//   O = softmax(Q K^T * sm_scale) V，张量布局与 Triton 版相同：[B, H, S, D]，contiguous
+//
+// 与 Triton kernel 一一对应：
+//   program_id(0) = Q 的第几个 BLOCK_M 行块 ↔ 工作项 (b*H + h, q 行块)，线程从共享计数器领工作项
+//   for start_n in range(0, S, BLOCK_N)     ↔ 沿 K/V 的 BN 列块循环，分数只在一个 [BN] 的行缓冲里，不生成 S×S 矩阵
+//   m_i / l_i / acc 的更新                  ↔ 完全相同的 online softmax 递推
+// 额外支持：
+//   - causal：对角线右上方的 K 块整块跳过（省一半计算），对角块内按行截断
+//   - 输入 fp32 或 bf16（bf16 在每个 K/V 块载入时转成 fp32，累加全程 fp32；输出 fp32）
+//   - SIMD：用 GCC 向量扩展写一份 kernel，分别按 AVX-512（16 宽）/ AVX2+FMA（8 宽）/ 通用指令集实例化，
+//           运行时按 CPU 选择；exp 用向量化的多项式近似（相对误差 ~1e-7）。向量操作和分派在 common/simd_isa.h
+//   - head_dim D 支持 64 / 128（与 Triton 版的 BLOCK_D 相同），D 是模板参数，acc 一行正好放进寄存器
+//
+// 对照：朴素实现 QK^T -> softmax -> V，每个 (b, h) 真的生成 S×S 分数矩阵（S=32k 时是 4GB，内存不够就跳过）；
+// causal 时朴素版也只算下三角，两边的 GFLOP/s 和加速比按同一个 FLOP 数算。
+// 大 S 时正确性用“抽样若干行、按定义用 double 逐行算”的参考值校验（verify.h）。
+//
+// 编译运行：
+//   g++ -O3 -std=c++17 -pthread mha_cpu.cpp -o mha_cpu
+//   ./mha_cpu                                   # 正确性：各 ISA × fp32/bf16 × causal/非 causal × 不整除的 S
+//   ./mha_cpu bench                             # B=1 H=8 D=64，S = 512 ... 8192
+//   ./mha_cpu bench --seq 512,4096,32768 --dtype bf16 --causal --heads 4 --dim 128 --threads 16
+
+using simd::Isa;
+using simd::Simd16;
+using simd::Simd8;
+
+// ================= 1. bf16 转换 =================
+
+// bf16 = fp32 的高 16 位；转换时四舍六入五成双
+static inline float bf16_to_f32(uint16_t h) {
+    uint32_t u = static_cast<uint32_t>(h) << 16;
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static inline uint16_t f32_to_bf16(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    u += 0x7fff + ((u >> 16) & 1);
+    return static_cast<uint16_t>(u >> 16);
+}
+
+static inline float to_f32(float x) { return x; }
+static inline float to_f32(uint16_t x) { return bf16_to_f32(x); }
+
+// ================= 2. FlashAttention 式 kernel =================
+
+constexpr int BM = 64;  // 每个工作项的 Q 行数（Triton 版 BLOCK_M）
+constexpr int BN = 64;  // 每次处理的 K/V 行数（Triton 版 BLOCK_N）
+
+struct Problem {
+    const void* q;
+    const void* k;
+    const void* v;
+    float* o;
+    int B, H, S, D;
+    bool causal;
+    float scale;
+};
+
+// 每个线程一份，整个 kernel 期间复用，不在循环里分配
+struct Workspace {
+    std::vector<float> qf, kt, vf, s, acc, m, l;
+    explicit Workspace(int D)
+        : qf(BM * D), kt(static_cast<size_t>(D) * BN), vf(static_cast<size_t>(BN) * D), s(BN), acc(BM * D), m(BM),
+          l(BM) {}
+};
+
+// 一个工作项：第 bh 个 (batch, head) 的第 q0 .. q0+BM 行
+template <class Ops, int D, class T>
+__attribute__((always_inline)) inline void flash_item(const Problem& pb, Workspace& ws, int bh, int q0) {
+    using VF = decltype(Ops::set1(0));
+    constexpr int W = Ops::W;
+    constexpr int NS = BN / W;  // 一行分数占几个向量
+    constexpr int ND = D / W;   // 一行 acc / V 占几个向量
+    const int S = pb.S;
+    const size_t base = static_cast<size_t>(bh) * S * D;
+    const T* q = static_cast<const T*>(pb.q) + base;
+    const T* k = static_cast<const T*>(pb.k) + base;
+    const T* v = static_cast<const T*>(pb.v) + base;
+    float* o = pb.o + base;
+    const int bm = std::min(BM, S - q0);
+
+    float* qf = ws.qf.data();
+    float* kt = ws.kt.data();
+    float* s = ws.s.data();
+    float* acc = ws.acc.data();
+    float* m = ws.m.data();
+    float* l = ws.l.data();
+
+    // Q 行块转成 fp32 并预先乘上 sm_scale：分数就不用每个再乘一次
+    for (int i = 0; i < bm; ++i)
+        for (int d = 0; d < D; ++d) qf[i * D + d] = to_f32(q[static_cast<size_t>(q0 + i) * D + d]) * pb.scale;
+    std::fill(acc, acc + bm * D, 0.0f);
+    std::fill(m, m + bm, -std::numeric_limits<float>::infinity());
+    std::fill(l, l + bm, 0.0f);
+
+    // causal：只有 k <= 本块最后一行的 K 才有用
+    const int kEnd = pb.causal ? q0 + bm : S;
+    for (int k0 = 0; k0 < kEnd; k0 += BN) {
+        const int bn = std::min(BN, kEnd - k0);
+        // K 块转置成 [D][BN]：算一行分数时沿 BN 方向向量化，q 的每个分量广播一次
+        for (int j = 0; j < BN; ++j) {
+            if (j < bn) {
+                const T* kr = k + static_cast<size_t>(k0 + j) * D;
+                for (int d = 0; d < D; ++d) kt[d * BN + j] = to_f32(kr[d]);
+            } else {
+                for (int d = 0; d < D; ++d) kt[d * BN + j] = 0.0f;
+            }
+        }
+        // V 块：fp32 直接用原数组，bf16 先转成 fp32
+        const float* vb;
+        if constexpr (std::is_same<T, float>::value) {
+            vb = v + static_cast<size_t>(k0) * D;
+        } else {
+            for (int j = 0; j < bn; ++j)
+                for (int d = 0; d < D; ++d) ws.vf[j * D + d] = to_f32(v[static_cast<size_t>(k0 + j) * D + d]);
+            vb = ws.vf.data();
+        }
+
+        for (int i = 0; i < bm; ++i) {
+            // 这一行在本块里的有效列数（causal 对角块里只到 k <= q）
+            const int valid = pb.causal ? std::min(bn, q0 + i - k0 + 1) : bn;
+            if (valid <= 0) continue;
+
+            // scores = q_i · K^T
+            VF sc[NS];
+            for (int c = 0; c < NS; ++c) sc[c] = Ops::set1(0.0f);
+            const float* qi = qf + i * D;
+            for (int d = 0; d < D; ++d) {
+                VF qd = Ops::set1(qi[d]);
+                for (int c = 0; c < NS; ++c) sc[c] += qd * Ops::load(kt + d * BN + c * W);
+            }
+            for (int c = 0; c < NS; ++c) Ops::store(s + c * W, sc[c]);
+            for (int j = valid; j < BN; ++j) s[j] = -std::numeric_limits<float>::infinity();
+
+            // online softmax：新的行最大值、本块的 p = exp(s - m_new)、旧累加量的缩放 alpha
+            VF mx = Ops::load(s);
+            for (int c = 1; c < NS; ++c) mx = Ops::vmax(mx, Ops::load(s + c * W));
+            const float mNew = std::max(m[i], Ops::hmax(mx));
+            const VF mv = Ops::set1(mNew);
+            VF sum = Ops::set1(0.0f);
+            for (int c = 0; c < NS; ++c) {
+                VF p = Ops::exp(Ops::load(s + c * W) - mv);
+                Ops::store(s + c * W, p);
+                sum += p;
+            }
+            const float alpha = std::exp(m[i] - mNew);  // 第一块时 m[i] = -inf，alpha = 0
+            l[i] = l[i] * alpha + Ops::hsum(sum);
+            m[i] = mNew;
+
+            // acc_i = acc_i * alpha + p · V，一行 acc 放在寄存器里
+            float* ai = acc + i * D;
+            VF a[ND];
+            const VF av = Ops::set1(alpha);
+            for (int c = 0; c < ND; ++c) a[c] = Ops::load(ai + c * W) * av;
+            for (int j = 0; j < valid; ++j) {
+                VF pj = Ops::set1(s[j]);
+                const float* vr = vb + j * D;
+                for (int c = 0; c < ND; ++c) a[c] += pj * Ops::load(vr + c * W);
+            }
+            for (int c = 0; c < ND; ++c) Ops::store(ai + c * W, a[c]);
+        }
+    }
+
+    for (int i = 0; i < bm; ++i) {
+        const float inv = 1.0f / l[i];
+        for (int d = 0; d < D; ++d) o[static_cast<size_t>(q0 + i) * D + d] = acc[i * D + d] * inv;
+    }
+}
+
+using ItemFn = void (*)(const Problem&, Workspace&, int, int);
+
+template <int D, class T>
+__attribute__((target("avx512f,avx2,fma"))) void flash_item_avx512(const Problem& pb, Workspace& ws, int bh, int q0) {
+    flash_item<Simd16, D, T>(pb, ws, bh, q0);
+}
+
+template <int D, class T>
+__attribute__((target("avx2,fma"))) void flash_item_avx2(const Problem& pb, Workspace& ws, int bh, int q0) {
+    flash_item<Simd8, D, T>(pb, ws, bh, q0);
+}
+
+template <int D, class T>
+void flash_item_generic(const Problem& pb, Workspace& ws, int bh, int q0) {
+    flash_item<Simd8, D, T>(pb, ws, bh, q0);
+}
+
+template <int D, class T>
+static ItemFn pick_item(Isa isa) {
+    return simd::pick<ItemFn>(isa, flash_item_avx512<D, T>, flash_item_avx2<D, T>, flash_item_generic<D, T>);
+}
+
+// 工作项 = (bh, q 行块)；causal 时各行块的工作量不同，动态领取比静态均分更均衡
+static void flash_attention(const Problem& pb, bool bf16, Isa isa, int threads) {
+    ItemFn fn = nullptr;
+    if (pb.D == 64) fn = bf16 ? pick_item<64, uint16_t>(isa) : pick_item<64, float>(isa);
+    else if (pb.D == 128) fn = bf16 ? pick_item<128, uint16_t>(isa) : pick_item<128, float>(isa);
+    else {
+        std::fprintf(stderr, "head_dim D=%d not supported (64 or 128)\n", pb.D);
+        std::exit(1);
+    }
+    const int qBlocks = (pb.S + BM - 1) / BM;
+    const long long items = static_cast<long long>(pb.B) * pb.H * qBlocks;
+    threads = static_cast<int>(std::max<long long>(1, std::min<long long>(threads, items)));
+    std::atomic<long long> next{0};
+    auto worker = [&] {
+        Workspace ws(pb.D);
+        for (long long it; (it = next.fetch_add(1, std::memory_order_relaxed)) < items;) {
+            // 行块从后往前领：causal 时靠后的行块最重，先派出去，尾部更整齐
+            int qb = qBlocks - 1 - static_cast<int>(it % qBlocks);
+            fn(pb, ws, static_cast<int>(it / qBlocks), qb * BM);
+        }
+    };
+    std::vector<std::thread> team;
+    for (int t = 1; t < threads; ++t) team.emplace_back(worker);
+    worker();
+    for (auto& th : team) th.join();
+}
+
+// ================= 3. 朴素参考：QK^T -> softmax -> V =================
+
+// 每个 (b, h) 生成完整的 S×S 分数矩阵，三步分开做；按 (b, h) 并行。
+// causal 时第 i 行只算 j <= i 的分数和 PV（右上半填 -inf 不参与计算），和 flash 版一样省一半，
+// 两边按同一个 attention_flops 比较才公平
+template <class T>
+static void naive_attention(const Problem& pb, int threads) {
+    const int S = pb.S, D = pb.D, BH = pb.B * pb.H;
+    std::atomic<int> next{0};
+    auto worker = [&] {
+        std::vector<float> P(static_cast<size_t>(S) * S);
+        std::vector<float> qf(static_cast<size_t>(S) * D), kf(qf.size()), vf(qf.size());
+        for (int bh; (bh = next.fetch_add(1)) < BH;) {
+            const size_t base = static_cast<size_t>(bh) * S * D;
+            for (size_t x = 0; x < qf.size(); ++x) {
+                qf[x] = to_f32(static_cast<const T*>(pb.q)[base + x]);
+                kf[x] = to_f32(static_cast<const T*>(pb.k)[base + x]);
+                vf[x] = to_f32(static_cast<const T*>(pb.v)[base + x]);
+            }
+            // 1) scores = Q K^T * scale
+            for (int i = 0; i < S; ++i) {
+                const int n = pb.causal ? i + 1 : S;
+                float* row = &P[static_cast<size_t>(i) * S];
+                for (int j = 0; j < n; ++j) {
+                    float dot = 0;
+                    for (int d = 0; d < D; ++d) dot += qf[i * D + d] * kf[j * D + d];
+                    row[j] = dot * pb.scale;
+                }
+                std::fill(row + n, row + S, -std::numeric_limits<float>::infinity());
+            }
+            // 2) 逐行 softmax
+            for (int i = 0; i < S; ++i) {
+                const int n = pb.causal ? i + 1 : S;
+                float* row = &P[static_cast<size_t>(i) * S];
+                float mx = *std::max_element(row, row + n);
+                float sum = 0;
+                for (int j = 0; j < n; ++j) sum += (row[j] = std::exp(row[j] - mx));
+                for (int j = 0; j < n; ++j) row[j] /= sum;
+                std::fill(row + n, row + S, 0.0f);
+            }
+            // 3) O = P V
+            float* o = pb.o + base;
+            std::fill(o, o + static_cast<size_t>(S) * D, 0.0f);
+            for (int i = 0; i < S; ++i)
+                for (int j = 0, n = pb.causal ? i + 1 : S; j < n; ++j) {
+                    float p = P[static_cast<size_t>(i) * S + j];
+                    for (int d = 0; d < D; ++d) o[i * D + d] += p * vf[j * D + d];
+                }
+        }
+    };
+    std::vector<std::thread> team;
+    for (int t = 1; t < std::min(threads, BH); ++t) team.emplace_back(worker);
+    worker();
+    for (auto& th : team) th.join();
+}
+
+// 按定义用 double 算 (bh, 第 i 行) 的输出：只需要 O(S·D)，大 S 时抽样校验用
+template <class T>
+static void reference_row(const Problem& pb, int bh, int i, float* out) {
+    const int S = pb.S, D = pb.D;
+    const size_t base = static_cast<size_t>(bh) * S * D;
+    const T* q = static_cast<const T*>(pb.q) + base;
+    const T* k = static_cast<const T*>(pb.k) + base;
+    const T* v = static_cast<const T*>(pb.v) + base;
+    const int n = pb.causal ? i + 1 : S;
+    std::vector<double> sc(n);
+    double mx = -std::numeric_limits<double>::infinity();
+    for (int j = 0; j < n; ++j) {
+        double dot = 0;
+        for (int d = 0; d < D; ++d)
+            dot += static_cast<double>(to_f32(q[static_cast<size_t>(i) * D + d])) * to_f32(k[static_cast<size_t>(j) * D + d]);
+        sc[j] = dot * pb.scale;
+        mx = std::max(mx, sc[j]);
+    }
+    double sum = 0;
+    for (int j = 0; j < n; ++j) sum += (sc[j] = std::exp(sc[j] - mx));
+    for (int d = 0; d < D; ++d) {
+        double o = 0;
+        for (int j = 0; j < n; ++j) o += sc[j] * to_f32(v[static_cast<size_t>(j) * D + d]);
+        out[d] = static_cast<float>(o / sum);
+    }
+}
+
+// ================= 4. 数据、校验、计时 =================
+
+struct Tensors {
+    std::vector<float> q32, k32, v32;
+    std::vector<uint16_t> q16, k16, v16;
+    std::vector<float> out, ref;
+};
+
+static Tensors make_inputs(size_t elems, bool bf16, uint32_t seed) {
+    Tensors t;
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    auto fill = [&](std::vector<float>& f, std::vector<uint16_t>& h) {
+        if (bf16) {
+            h.resize(elems);
+            for (auto& x : h) x = f32_to_bf16(dist(rng));
+        } else {
+            f.resize(elems);
+            for (auto& x : f) x = dist(rng);
+        }
+    };
+    fill(t.q32, t.q16);
+    fill(t.k32, t.k16);
+    fill(t.v32, t.v16);
+    t.out.assign(elems, 0.0f);
+    return t;
+}
+
+static Problem make_problem(Tensors& t, int B, int H, int S, int D, bool causal, bool bf16) {
+    Problem pb;
+    pb.q = bf16 ? static_cast<const void*>(t.q16.data()) : t.q32.data();
+    pb.k = bf16 ? static_cast<const void*>(t.k16.data()) : t.k32.data();
+    pb.v = bf16 ? static_cast<const void*>(t.v16.data()) : t.v32.data();
+    pb.o = t.out.data();
+    pb.B = B;
+    pb.H = H;
+    pb.S = S;
+    pb.D = D;
+    pb.causal = causal;
+    pb.scale = 1.0f / std::sqrt(static_cast<float>(D));
+    return pb;
+}
+
+// 输出都是 O(1) 量级（V ~ N(0,1) 的加权平均），绝对 + 相对误差各 1e-4 足够区分实现错误与舍入差异
+static const verify::Tolerance kTol{1e-4, 1e-4, -1};
+
+// 抽样校验：每个 (b, h) 取第一行、最后一行和几行随机行，用 double 逐行参考值对比
+static verify::Report check_sampled(const Problem& pb, bool bf16, const float* out) {
+    std::mt19937 rng(123);
+    std::vector<float> got, want;
+    std::vector<float> row(pb.D);
+    for (int bh = 0; bh < pb.B * pb.H; ++bh) {
+        std::vector<int> rows = {0, pb.S - 1};
+        for (int r = 0; r < 6; ++r) rows.push_back(static_cast<int>(rng() % pb.S));
+        for (int i : rows) {
+            if (bf16) reference_row<uint16_t>(pb, bh, i, row.data());
+            else reference_row<float>(pb, bh, i, row.data());
+            const float* o = out + (static_cast<size_t>(bh) * pb.S + i) * pb.D;
+            got.insert(got.end(), o, o + pb.D);
+            want.insert(want.end(), row.begin(), row.end());
+        }
+    }
+    return verify::compare(got.data(), want.data(), got.size(), kTol);
+}
+
+template <class F>
+static double best_ms(F&& f, int reps) {
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count());
+    }
+    return best;
+}
+
+// QK^T 和 PV 各 2·S·S·D 次浮点运算；causal 约一半（flash 和朴素版都跳过了被 mask 的那一半）
+static double attention_flops(const Problem& pb) {
+    double f = 4.0 * pb.B * pb.H * static_cast<double>(pb.S) * pb.S * pb.D;
+    return pb.causal ? f / 2 : f;
+}
+
+static double available_bytes() {
+    std::ifstream in("/proc/meminfo");
+    std::string key;
+    double kb = 0;
+    while (in >> key >> kb) {
+        if (key == "MemAvailable:") return kb * 1024.0;
+        in.ignore(256, '\n');
+    }
+    return 1e18;
+}
+
+// ================= 5. 正确性 demo =================
+
+static bool run_demo() {
+    bool ok = true;
+    const int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const std::vector<Isa> isas = simd::available_isas();
+    // S=200 不是 64 的倍数：覆盖尾块和对角块
+    const int B = 2, H = 3, S = 200;
+    for (int D : {64, 128}) {
+        for (bool bf16 : {false, true}) {
+            for (bool causal : {false, true}) {
+                Tensors t = make_inputs(static_cast<size_t>(B) * H * S * D, bf16, 7);
+                Problem pb = make_problem(t, B, H, S, D, causal, bf16);
+                std::vector<float> ref(t.out.size());
+                Problem rp = pb;
+                rp.o = ref.data();
+                if (bf16) naive_attention<uint16_t>(rp, threads);
+                else naive_attention<float>(rp, threads);
+                for (Isa isa : isas) {
+                    std::fill(t.out.begin(), t.out.end(), 0.0f);
+                    flash_attention(pb, bf16, isa, threads);
+                    verify::Report r = verify::compare(t.out.data(), ref.data(), ref.size(), kTol);
+                    std::printf("%s D=%-3d %-4s %-6s %-7s vs naive: max_abs_err=%.2e\n", r.ok ? "✅" : "❌", D,
+                                bf16 ? "bf16" : "fp32", causal ? "causal" : "full", simd::isa_name(isa), r.maxAbs);
+                    if (!r.ok) verify::print(r, "flash vs naive");
+                    ok &= r.ok;
+                }
+                verify::Report r = check_sampled(pb, bf16, t.out.data());
+                if (!r.ok) verify::print(r, "flash vs double rows");
+                ok &= r.ok;
+            }
+        }
+    }
+    return ok;
+}
+
+// ================= 6. benchmark =================
+
+struct BenchOptions {
+    std::vector<int> seqs = {512, 1024, 2048, 4096, 8192};
+    int B = 1, H = 8, D = 64;
+    bool causal = false, bf16 = false;
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+};
+
+static void run_benchmark(const BenchOptions& opt) {
+    const Isa isa = simd::best_isa();
+    std::printf("B=%d H=%d D=%d dtype=%s causal=%d threads=%d isa=%s\n", opt.B, opt.H, opt.D,
+                opt.bf16 ? "bf16" : "fp32", opt.causal, opt.threads, simd::isa_name(isa));
+    for (int S : opt.seqs) {
+        const size_t elems = static_cast<size_t>(opt.B) * opt.H * S * opt.D;
+        Tensors t = make_inputs(elems, opt.bf16, 11);
+        Problem pb = make_problem(t, opt.B, opt.H, S, opt.D, opt.causal, opt.bf16);
+        const double flops = attention_flops(pb);
+        // 大 S 时一次就够久，少测几次
+        const int reps = S >= 4096 ? 1 : 3;
+
+        double flashMs = best_ms([&] { flash_attention(pb, opt.bf16, isa, opt.threads); }, reps);
+        verify::Report r = check_sampled(pb, opt.bf16, t.out.data());
+        std::printf("S=%-6d flash: %10.2f ms  %7.1f GFLOP/s  (sampled rows %s, max_abs_err=%.1e)\n", S, flashMs,
+                    flops / (flashMs * 1e6), r.ok ? "OK" : "MISMATCH", r.maxAbs);
+
+        // 朴素版每个线程一个 S×S 的 float 矩阵，另有 S·D 的三份 fp32 拷贝
+        const int naiveThreads = std::min(opt.threads, opt.B * opt.H);
+        const double naiveBytes = naiveThreads * (4.0 * S * S + 12.0 * S * opt.D);
+        if (naiveBytes > 0.5 * available_bytes()) {
+            std::printf("         naive: skipped (S×S scores need %.1f GB)\n", naiveBytes / 1e9);
+            continue;
+        }
+        std::vector<float> ref(elems);
+        Problem rp = pb;
+        rp.o = ref.data();
+        double naiveMs = best_ms(
+            [&] {
+                if (opt.bf16) naive_attention<uint16_t>(rp, opt.threads);
+                else naive_attention<float>(rp, opt.threads);
+            },
+            reps);
+        verify::Report rn = verify::compare(t.out.data(), ref.data(), elems, kTol);
+        std::printf("         naive: %10.2f ms  %7.1f GFLOP/s  -> flash speedup %.2fx (full compare %s)\n", naiveMs,
+                    flops / (naiveMs * 1e6), naiveMs / flashMs, rn.ok ? "OK" : "MISMATCH");
+    }
+}
+
+static std::vector<int> parse_list(const char* s) {
+    std::vector<int> out;
+    for (const char* p = s; *p;) {
+        out.push_back(std::atoi(p));
+        const char* comma = std::strchr(p, ',');
+        if (!comma) break;
+        p = comma + 1;
+    }
+    return out;
+}
+
+// ================= 主函数 =================
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && std::strcmp(argv[1], "bench") == 0) {
+        BenchOptions opt;
+        for (int i = 2; i < argc; ++i) {
+            std::string a = argv[i];
+            auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+            if (a == "--seq") opt.seqs = parse_list(next());
+            else if (a == "--batch") opt.B = std::atoi(next());
+            else if (a == "--heads") opt.H = std::atoi(next());
+            else if (a == "--dim") opt.D = std::atoi(next());
+            else if (a == "--threads") opt.threads = std::max(1, std::atoi(next()));
+            else if (a == "--causal") opt.causal = true;
+            else if (a == "--dtype") opt.bf16 = std::strcmp(next(), "bf16") == 0;
+            else {
+                std::fprintf(stderr,
+                             "Usage: %s bench [--seq 512,4096,32768] [--batch B] [--heads H] [--dim 64|128] "
+                             "[--dtype fp32|bf16] [--causal] [--threads T]\n",
+                             argv[0]);
+                return 1;
+            }
+        }
+        if (opt.D != 64 && opt.D != 128) {
+            std::fprintf(stderr, "--dim must be 64 or 128\n");
+            return 1;
+        }
+        run_benchmark(opt);
+        return 0;
+    }
+    return run_demo() ? 0 : 1;
+}
@@ -0,0 +1,323 @@
+#pragma once
+
+// CPU kernel 的自动调优（header-only）：把 day1_vector_add.cu 里手写的 blockDim 128/256/512 扫描
+// 推广成“给出参数空间 + 一个计时函数，自动找最快的配置，并按 (kernel, N, CPU 型号, 参数空间) 缓存到文件”。
+//
+// 搜索策略：坐标下降。从默认配置出发，每次只改一个参数、其余固定，取最快的值；
+// 所有参数轮一遍算一轮，某一轮没有任何改进就停（最多 maxRounds 轮）。
+// 参数之间耦合不强时（tile / unroll / 线程数 / 预取距离基本如此），它和穷举的结果接近，
+// 但测量次数是 Σ|取值| 而不是 Π|取值|。需要穷举时用 Tuner::exhaustive = true。
+//
+// 缓存文件：一行一条，制表符分隔
+//   kernel  N  cpu_model  space  name=value,name=value  ms
+// space 是参数空间的签名（"tile:0|16384;threads:1|2|4"）。参数空间也是键的一部分：
+// 同一个 N 先用 max_threads=4 调过、再用 max_threads=2 跑，不能读出 threads=4 的配置；
+// 读到的配置里有当前空间之外的取值（手改过缓存之类）同样当作没命中，重新调。
+// 路径取环境变量 AUTOTUNE_CACHE，默认当前目录的 autotune_cache.tsv。写入时先写临时文件再 rename，
+// 几个进程同时写也不会得到半截文件（后写的覆盖先写的）。
+//
+// 用法：
+//   autotune::Space space = {{"tile", {4096, 65536}}, {"unroll", {1, 2, 4}}};
+//   autotune::Tuner tuner("vec_add_avx2", n, space);
+//   autotune::Config best = tuner.loadOrTune(defaultCfg, [&](const autotune::Config& c) { return run_ms(c); });
+//   int unroll = best.get("unroll");
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+namespace autotune {
+
+struct Param {
+    std::string name;
+    std::vector<int> values;
+};
+
+using Space = std::vector<Param>;
+
+// "tile:0|16384;unroll:1|2"，缓存键里用这个区分参数空间
+inline std::string spaceKey(const Space& space) {
+    std::string s;
+    for (const Param& p : space) {
+        if (!s.empty()) s += ';';
+        s += p.name + ':';
+        for (size_t i = 0; i < p.values.size(); ++i) s += (i ? "|" : "") + std::to_string(p.values[i]);
+    }
+    return s.empty() ? "-" : s;
+}
+
+// 配置恰好给出空间里的每个参数各一次，取值都在候选列表里。缺参数的行（手改过的缓存、旧版本写的）
+// 不算命中：否则 cfg.get 到调用方才抛 out_of_range
+inline bool inSpace(const std::vector<std::pair<std::string, int>>& kv, const Space& space) {
+    if (kv.size() != space.size()) return false;
+    for (const Param& p : space) {
+        int hits = 0;
+        bool valid = false;
+        for (const auto& [k, v] : kv) {
+            if (k != p.name) continue;
+            ++hits;
+            valid = std::find(p.values.begin(), p.values.end(), v) != p.values.end();
+        }
+        if (hits != 1 || !valid) return false;
+    }
+    return true;
+}
+
+// 参数名 -> 取值，保持参数空间里的顺序
+class Config {
+public:
+    Config() = default;
+    Config(std::initializer_list<std::pair<std::string, int>> kv) : kv_(kv) {}
+
+    int get(const std::string& name) const {
+        for (const auto& [k, v] : kv_)
+            if (k == name) return v;
+        throw std::out_of_range("autotune::Config: no parameter '" + name + "'");
+    }
+
+    void set(const std::string& name, int value) {
+        for (auto& [k, v] : kv_) {
+            if (k == name) {
+                v = value;
+                return;
+            }
+        }
+        kv_.emplace_back(name, value);
+    }
+
+    // "tile=65536,unroll=4"，缓存文件和打印都用这个格式
+    std::string str() const {
+        std::string s;
+        for (const auto& [k, v] : kv_) {
+            if (!s.empty()) s += ',';
+            s += k + "=" + std::to_string(v);
+        }
+        return s;
+    }
+
+    static bool parse(const std::string& s, Config& out) {
+        Config c;
+        std::stringstream ss(s);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            size_t eq = item.find('=');
+            if (eq == std::string::npos) return false;
+            c.set(item.substr(0, eq), std::atoi(item.c_str() + eq + 1));
+        }
+        out = std::move(c);
+        return true;
+    }
+
+    bool operator==(const Config& o) const { return kv_ == o.kv_; }
+
+    const std::vector<std::pair<std::string, int>>& items() const { return kv_; }
+
+private:
+    std::vector<std::pair<std::string, int>> kv_;
+};
+
+// /proc/cpuinfo 的 model name；拿不到就是 "unknown"。空白换成下划线，方便放进 TSV
+inline std::string cpuModel() {
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("model name", 0) == 0) {
+            size_t colon = line.find(':');
+            std::string m = colon == std::string::npos ? line : line.substr(colon + 1);
+            size_t b = m.find_first_not_of(" \t");
+            m = b == std::string::npos ? "" : m.substr(b);
+            for (char& ch : m)
+                if (ch == ' ' || ch == '\t') ch = '_';
+            return m.empty() ? "unknown" : m;
+        }
+    }
+    return "unknown";
+}
+
+inline std::string cachePath() {
+    const char* p = std::getenv("AUTOTUNE_CACHE");
+    return p && *p ? p : "autotune_cache.tsv";
+}
+
+// ================= 缓存文件 =================
+
+struct Entry {
+    std::string kernel;
+    long long n = 0;
+    std::string cpu;
+    std::string space;
+    Config config;
+    double ms = 0;
+};
+
+inline std::vector<Entry> loadCache(const std::string& path) {
+    std::vector<Entry> out;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::stringstream ss(line);
+        Entry e;
+        std::string cfg;
+        // 格式不对的行直接跳过：缓存只是加速，坏了就重新调
+        if (!(std::getline(ss, e.kernel, '\t') && ss >> e.n && ss.ignore(1) && std::getline(ss, e.cpu, '\t') &&
+              std::getline(ss, e.space, '\t') && std::getline(ss, cfg, '\t') && ss >> e.ms && Config::parse(cfg, e.config)))
+            continue;
+        out.push_back(std::move(e));
+    }
+    return out;
+}
+
+inline bool saveCache(const std::string& path, const std::vector<Entry>& entries) {
+    std::string tmp = path + ".tmp." + std::to_string(::getpid());
+    {
+        std::ofstream outFile(tmp, std::ios::trunc);
+        if (!outFile) return false;
+        outFile << "# kernel\tN\tcpu_model\tspace\tconfig\tms\n";
+        for (const Entry& e : entries)
+            outFile << e.kernel << '\t' << e.n << '\t' << e.cpu << '\t' << e.space << '\t' << e.config.str() << '\t'
+                    << e.ms << '\n';
+        if (!outFile) return false;
+    }
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+// ================= 调优器 =================
+
+class Tuner {
+public:
+    using Measure = std::function<double(const Config&)>;  // 返回毫秒，越小越好
+
+    Tuner(std::string kernel, long long n, Space space)
+        : kernel_(std::move(kernel)), n_(n), space_(std::move(space)), spaceKey_(spaceKey(space_)), cpu_(cpuModel()),
+          path_(cachePath()) {}
+
+    bool exhaustive = false;
+    int maxRounds = 3;
+    bool verbose = true;
+    // 候选至少快这么多才替换当前最优：单次测量有几个百分点的噪声，避免追着噪声换配置
+    double minGain = 0.02;
+
+    // 缓存里有 (kernel, N, CPU, 参数空间) 这一条、且配置落在当前空间里就直接返回，否则调优并写回缓存
+    Config loadOrTune(const Config& initial, const Measure& measure, bool* fromCache = nullptr) {
+        for (const Entry& e : loadCache(path_)) {
+            if (matches(e) && inSpace(e.config.items(), space_)) {
+                if (fromCache) *fromCache = true;
+                bestMs_ = e.ms;
+                return e.config;
+            }
+        }
+        if (fromCache) *fromCache = false;
+        Config best = tune(initial, measure);
+        store(best, bestMs_);
+        return best;
+    }
+
+    Config tune(const Config& initial, const Measure& measure) {
+        measured_ = 0;
+        history_.clear();
+        Config best = initial;
+        bestMs_ = timed(best, measure);
+        if (exhaustive) {
+            Config cur = initial;
+            searchAll(0, cur, best, measure);
+            return best;
+        }
+        for (int round = 0; round < maxRounds; ++round) {
+            bool improved = false;
+            for (const Param& p : space_) {
+                for (int v : p.values) {
+                    if (v == best.get(p.name)) continue;
+                    Config cand = best;
+                    cand.set(p.name, v);
+                    if (seen(cand)) continue;  // 上一轮已经测过的组合不再测
+                    double ms = timed(cand, measure);
+                    if (ms < bestMs_ * (1.0 - minGain)) {
+                        bestMs_ = ms;
+                        best = cand;
+                        improved = true;
+                    }
+                }
+            }
+            if (!improved) break;
+        }
+        return best;
+    }
+
+    // 覆盖缓存中同一 (kernel, N, CPU, 参数空间) 的旧条目
+    bool store(const Config& cfg, double ms) {
+        std::vector<Entry> entries = loadCache(path_);
+        bool replaced = false;
+        for (Entry& e : entries) {
+            if (matches(e)) {
+                e.config = cfg;
+                e.ms = ms;
+                replaced = true;
+            }
+        }
+        if (!replaced) entries.push_back({kernel_, n_, cpu_, spaceKey_, cfg, ms});
+        return saveCache(path_, entries);
+    }
+
+    double bestMs() const { return bestMs_; }
+    int measured() const { return measured_; }
+    const std::string& cpu() const { return cpu_; }
+    const std::string& path() const { return path_; }
+
+private:
+    bool matches(const Entry& e) const {
+        return e.kernel == kernel_ && e.n == n_ && e.cpu == cpu_ && e.space == spaceKey_;
+    }
+
+    double timed(const Config& c, const Measure& measure) {
+        double ms = measure(c);
+        ++measured_;
+        history_.push_back(c);
+        if (verbose) std::printf("  [autotune] %-48s %.4f ms\n", c.str().c_str(), ms);
+        return ms;
+    }
+
+    bool seen(const Config& c) const {
+        for (const Config& h : history_)
+            if (h == c) return true;
+        return false;
+    }
+
+    void searchAll(size_t k, Config& cur, Config& best, const Measure& measure) {
+        if (k == space_.size()) {
+            if (cur == best) return;
+            double ms = timed(cur, measure);
+            if (ms < bestMs_ * (1.0 - minGain)) {
+                bestMs_ = ms;
+                best = cur;
+            }
+            return;
+        }
+        for (int v : space_[k].values) {
+            cur.set(space_[k].name, v);
+            searchAll(k + 1, cur, best, measure);
+        }
+    }
+
+    std::string kernel_;
+    long long n_;
+    Space space_;
+    std::string spaceKey_;
+    std::string cpu_;
+    std::string path_;
+    double bestMs_ = std::numeric_limits<double>::infinity();
+    int measured_ = 0;
+    std::vector<Config> history_;
+};
+
+}  // namespace autotune
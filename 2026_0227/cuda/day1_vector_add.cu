@@ -5,6 +5,8 @@
 #include <cstdlib>
 #include <vector>
 
+#include "../../common/verify.h"
+
 // Day1 交付：
 // 1) 写：vector add kernel（含边界检查）+ 正确性验证
 // 2) 测：记录 kernel time；对比不同 blockDim（128/256/512）
@@ -36,22 +38,15 @@ static void init_host(std::vector<float>& a, std::vector<float>& b) {
     }
 }
 
+// 多线程 + SIMD 校验（verify.h）：参考值按块现算 a + b，失败时报告第一个不匹配的位置
 static bool check_correct(const std::vector<float>& a, const std::vector<float>& b,
                           const std::vector<float>& c) {
     if (a.size() != b.size() || a.size() != c.size()) return false;
-    double max_abs_err = 0.0;
-    for (size_t i = 0; i < a.size(); ++i) {
-        double ref = static_cast<double>(a[i]) + static_cast<double>(b[i]);
-        double err = std::fabs(static_cast<double>(c[i]) - ref);
-        if (err > max_abs_err) max_abs_err = err;
-        if (err > 1e-5) {
-            std::fprintf(stderr, "Mismatch at i=%zu: got=%f ref=%f err=%g\n", i,
-                         c[i], static_cast<float>(ref), err);
-            return false;
-        }
-    }
-    std::printf("Correctness OK. max_abs_err=%g\n", max_abs_err);
-    return true;
+    verify::Report r = verify::compareFn(
+        c.data(), c.size(), [&](size_t lo, size_t len, float* ref) {
+            for (size_t i = 0; i < len; ++i) ref[i] = a[lo + i] + b[lo + i];
+        });
+    return verify::print(r);
 }
 
 static float time_kernel_ms(int n, int block_dim, const float* d_a,
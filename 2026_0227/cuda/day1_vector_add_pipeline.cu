@@ -0,0 +1,450 @@
+#if defined(__CUDACC__)
+#include <cuda_runtime.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../../common/verify.h"
+
+// Day1 vector add 的端到端版本：不只算 kernel，而是“主机数组进 -> 主机数组出”的整段时间。
+// day1_vector_add.cu 用的是可分页的 std::vector + 同步 cudaMemcpy，16M 元素时拷贝比 kernel 慢一个数量级。
+// 这里把数据切成 chunk，多条 stream 轮流处理：
+//
+//   stream0: [H2D c0][kernel c0][D2H c0]                 [H2D c2]...
+//   stream1:          [H2D c1  ][kernel c1][D2H c1]
+//                      ↑ 拷贝引擎和计算单元同时忙，H2D / kernel / D2H 互相重叠
+//
+// 两种主机内存用法：
+//   - staged：用户数组仍是可分页内存，每个槽位一组页锁定（pinned）中转缓冲区；
+//             CPU 往中转区填下一块 / 把上一块结果搬回用户数组，与 GPU 上的拷贝和计算重叠（双缓冲）
+//   - direct：用户数组本身就是 pinned 内存，DMA 直接读写，没有中转拷贝
+//
+// 没有 GPU（不是 nvcc 编译）时是 CPU 模拟：每条 stream 是一个按顺序执行任务的线程，
+// “设备内存”是另一块普通内存，拷贝是 memcpy。和真 GPU 一样只有一个 H2D 引擎和一个 D2H 引擎
+// （不同 stream 的同向拷贝排队），--link-gbps 可以把拷贝限速成 PCIe 的带宽，看重叠的效果。
+//
+// 编译运行：
+//   nvcc -O3 -std=c++17 day1_vector_add_pipeline.cu -o day1_vector_add_pipeline
+//   g++ -O3 -std=c++17 -pthread -x c++ day1_vector_add_pipeline.cu -o day1_vector_add_pipeline_cpu
+//   ./day1_vector_add_pipeline [n] [chunk_elems] [--link-gbps 12]
+
+// ================= 1. 后端：CUDA 或 CPU 模拟 =================
+
+#if defined(__CUDACC__)
+
+#define CUDA_CHECK(call)                                                    \
+    do {                                                                    \
+        cudaError_t err__ = (call);                                         \
+        if (err__ != cudaSuccess) {                                         \
+            std::fprintf(stderr, "CUDA error %s:%d: %s\n", __FILE__,        \
+                         __LINE__, cudaGetErrorString(err__));              \
+            std::exit(1);                                                   \
+        }                                                                   \
+    } while (0)
+
+__global__ void vec_add(const float* __restrict__ a,
+                        const float* __restrict__ b,
+                        float* __restrict__ c, int n) {
+    int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx < n) {
+        c[idx] = a[idx] + b[idx];
+    }
+}
+
+using Stream = cudaStream_t;
+using Event = cudaEvent_t;
+
+static const char* backend_name() { return "cuda"; }
+
+static float* dev_alloc(size_t n) {
+    float* p = nullptr;
+    CUDA_CHECK(cudaMalloc(&p, n * sizeof(float)));
+    return p;
+}
+static void dev_free(float* p) { CUDA_CHECK(cudaFree(p)); }
+
+static float* pinned_alloc(size_t n) {
+    float* p = nullptr;
+    CUDA_CHECK(cudaMallocHost(&p, n * sizeof(float)));
+    return p;
+}
+static void pinned_free(float* p) { CUDA_CHECK(cudaFreeHost(p)); }
+
+static Stream stream_create() {
+    cudaStream_t s;
+    CUDA_CHECK(cudaStreamCreateWithFlags(&s, cudaStreamNonBlocking));
+    return s;
+}
+static void stream_destroy(Stream s) { CUDA_CHECK(cudaStreamDestroy(s)); }
+
+static void copy_h2d_async(float* dst, const float* src, size_t n, Stream s) {
+    CUDA_CHECK(cudaMemcpyAsync(dst, src, n * sizeof(float), cudaMemcpyHostToDevice, s));
+}
+static void copy_d2h_async(float* dst, const float* src, size_t n, Stream s) {
+    CUDA_CHECK(cudaMemcpyAsync(dst, src, n * sizeof(float), cudaMemcpyDeviceToHost, s));
+}
+static void copy_h2d_sync(float* dst, const float* src, size_t n) {
+    CUDA_CHECK(cudaMemcpy(dst, src, n * sizeof(float), cudaMemcpyHostToDevice));
+}
+static void copy_d2h_sync(float* dst, const float* src, size_t n) {
+    CUDA_CHECK(cudaMemcpy(dst, src, n * sizeof(float), cudaMemcpyDeviceToHost));
+}
+
+static void launch_vec_add(const float* a, const float* b, float* c, size_t n, Stream s) {
+    const int block_dim = 256;
+    int grid = static_cast<int>((n + block_dim - 1) / block_dim);
+    vec_add<<<grid, block_dim, 0, s>>>(a, b, c, static_cast<int>(n));
+    CUDA_CHECK(cudaGetLastError());
+}
+
+static Event event_create() {
+    cudaEvent_t e;
+    CUDA_CHECK(cudaEventCreateWithFlags(&e, cudaEventDisableTiming));
+    return e;
+}
+static void event_destroy(Event e) { CUDA_CHECK(cudaEventDestroy(e)); }
+static void event_record(Event& e, Stream s) { CUDA_CHECK(cudaEventRecord(e, s)); }
+static void event_sync(Event& e) { CUDA_CHECK(cudaEventSynchronize(e)); }
+static void device_sync() { CUDA_CHECK(cudaDeviceSynchronize()); }
+
+#else  // CPU 模拟
+
+// 模拟的链路带宽（GB/s），0 表示不限速（拷贝就是 memcpy 的速度）
+static double g_link_gbps = 0.0;
+
+// 一条 stream = 一个线程 + 一个任务队列，任务严格按提交顺序执行
+class EmuStream {
+public:
+    EmuStream() : worker_([this] { loop(); }) {}
+    ~EmuStream() {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        worker_.join();
+    }
+
+    // 返回这个任务的序号：序号 <= completed() 说明它已经执行完
+    uint64_t enqueue(std::function<void()> fn) {
+        std::lock_guard<std::mutex> lk(mu_);
+        q_.push_back(std::move(fn));
+        cv_.notify_all();
+        return ++submitted_;
+    }
+
+    uint64_t submitted() {
+        std::lock_guard<std::mutex> lk(mu_);
+        return submitted_;
+    }
+
+    void wait_for(uint64_t seq) {
+        std::unique_lock<std::mutex> lk(mu_);
+        done_cv_.wait(lk, [&] { return completed_ >= seq; });
+    }
+
+private:
+    void loop() {
+        std::unique_lock<std::mutex> lk(mu_);
+        for (;;) {
+            cv_.wait(lk, [&] { return stop_ || !q_.empty(); });
+            if (q_.empty()) return;
+            std::function<void()> fn = std::move(q_.front());
+            q_.pop_front();
+            lk.unlock();
+            fn();
+            lk.lock();
+            ++completed_;
+            done_cv_.notify_all();
+        }
+    }
+
+    std::mutex mu_;
+    std::condition_variable cv_, done_cv_;
+    std::deque<std::function<void()>> q_;
+    uint64_t submitted_ = 0, completed_ = 0;
+    bool stop_ = false;
+    std::thread worker_;
+};
+
+using Stream = EmuStream*;
+struct Event {
+    EmuStream* s = nullptr;
+    uint64_t seq = 0;
+};
+
+// 真 GPU 上每个方向只有一个拷贝引擎：不同 stream 的 H2D 互相排队，但 H2D、D2H、kernel 之间可以重叠
+static std::mutex g_h2d_engine, g_d2h_engine;
+
+static const char* backend_name() { return "cpu-emulation"; }
+
+static float* host_alloc(size_t n) {
+    void* p = nullptr;
+    if (posix_memalign(&p, 4096, std::max<size_t>(n, 1) * sizeof(float)) != 0) {
+        std::fprintf(stderr, "allocation of %zu floats failed\n", n);
+        std::exit(1);
+    }
+    return static_cast<float*>(p);
+}
+
+// cudaMalloc / cudaMallocHost 拿到的内存已经驻留；模拟时先写一遍，免得缺页算进计时里
+static float* dev_alloc(size_t n) {
+    float* p = host_alloc(n);
+    std::memset(p, 0, n * sizeof(float));
+    return p;
+}
+static void dev_free(float* p) { std::free(p); }
+static float* pinned_alloc(size_t n) { return dev_alloc(n); }
+static void pinned_free(float* p) { std::free(p); }
+
+static Stream stream_create() { return new EmuStream(); }
+static void stream_destroy(Stream s) { delete s; }
+
+// 按链路带宽补足耗时：memcpy 比 PCIe 快时睡到“应该传完”的时刻
+static void emulated_copy(std::mutex& engine, float* dst, const float* src, size_t n) {
+    std::lock_guard<std::mutex> lk(engine);
+    auto t0 = std::chrono::steady_clock::now();
+    std::memcpy(dst, src, n * sizeof(float));
+    if (g_link_gbps > 0) {
+        auto dur = std::chrono::duration<double>(n * sizeof(float) / (g_link_gbps * 1e9));
+        std::this_thread::sleep_until(t0 + std::chrono::duration_cast<std::chrono::steady_clock::duration>(dur));
+    }
+}
+
+static void copy_h2d_async(float* dst, const float* src, size_t n, Stream s) {
+    s->enqueue([=] { emulated_copy(g_h2d_engine, dst, src, n); });
+}
+static void copy_d2h_async(float* dst, const float* src, size_t n, Stream s) {
+    s->enqueue([=] { emulated_copy(g_d2h_engine, dst, src, n); });
+}
+static void copy_h2d_sync(float* dst, const float* src, size_t n) { emulated_copy(g_h2d_engine, dst, src, n); }
+static void copy_d2h_sync(float* dst, const float* src, size_t n) { emulated_copy(g_d2h_engine, dst, src, n); }
+
+static void vec_add_host(const float* __restrict__ a, const float* __restrict__ b, float* __restrict__ c, size_t n) {
+    for (size_t i = 0; i < n; ++i) c[i] = a[i] + b[i];
+}
+
+static void launch_vec_add(const float* a, const float* b, float* c, size_t n, Stream s) {
+    s->enqueue([=] { vec_add_host(a, b, c, n); });
+}
+
+static Event event_create() { return Event{}; }
+static void event_destroy(Event) {}
+static void event_record(Event& e, Stream s) { e = Event{s, s->submitted()}; }
+static void event_sync(Event& e) {
+    if (e.s) e.s->wait_for(e.seq);
+}
+static void device_sync() {}  // 调用方会对每条 stream 记录事件再等
+
+#endif
+
+// ================= 2. 数据与校验 =================
+
+static void init_host(float* a, float* b, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        // 与 day1_vector_add.cu 相同，便于对照
+        a[i] = static_cast<float>(i % 1024) * 0.001f;
+        b[i] = static_cast<float>((i * 7) % 1024) * 0.001f;
+    }
+}
+
+static bool check_correct(const float* a, const float* b, const float* c, size_t n) {
+    verify::Report r = verify::compareFn(c, n, [&](size_t lo, size_t len, float* ref) {
+        for (size_t i = 0; i < len; ++i) ref[i] = a[lo + i] + b[lo + i];
+    });
+    return verify::print(r);
+}
+
+// ================= 3. 三种跑法 =================
+
+// 基线：day1 的做法，整块同步拷进去、算、整块拷回来，三段完全串行
+static double run_baseline_ms(const float* a, const float* b, float* c, size_t n) {
+    float* d_a = dev_alloc(n);
+    float* d_b = dev_alloc(n);
+    float* d_c = dev_alloc(n);
+    Stream s = stream_create();
+    Event done = event_create();
+
+    auto t0 = std::chrono::steady_clock::now();
+    copy_h2d_sync(d_a, a, n);
+    copy_h2d_sync(d_b, b, n);
+    launch_vec_add(d_a, d_b, d_c, n, s);
+    event_record(done, s);
+    event_sync(done);
+    copy_d2h_sync(c, d_c, n);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    event_destroy(done);
+    stream_destroy(s);
+    dev_free(d_a);
+    dev_free(d_b);
+    dev_free(d_c);
+    return ms;
+}
+
+// 流水线。槽位数 = 2 × stream 数，第 k 块用槽位 k % slots、stream k % streams：
+// 同一槽位的前后两次使用落在同一条 stream 上，设备缓冲区的复用由 stream 顺序保证；
+// staged 模式下主机中转区的复用则要等该槽位上一次的 D2H 完成（事件），顺便把结果搬回用户数组。
+static double run_pipeline_ms(const float* a, const float* b, float* c, size_t n, size_t chunk, int streams,
+                              bool staged) {
+    const int slots = 2 * streams;
+    struct Slot {
+        float *d_a, *d_b, *d_c;
+        float *h_a = nullptr, *h_b = nullptr, *h_c = nullptr;  // staged 模式的 pinned 中转区
+        Event done;
+        long long chunk = -1;  // 当前占用它的块号，-1 表示空闲
+    };
+    std::vector<Stream> ss;
+    for (int i = 0; i < streams; ++i) ss.push_back(stream_create());
+    std::vector<Slot> slot(slots);
+    for (Slot& sl : slot) {
+        sl.d_a = dev_alloc(chunk);
+        sl.d_b = dev_alloc(chunk);
+        sl.d_c = dev_alloc(chunk);
+        if (staged) {
+            sl.h_a = pinned_alloc(chunk);
+            sl.h_b = pinned_alloc(chunk);
+            sl.h_c = pinned_alloc(chunk);
+        }
+        sl.done = event_create();
+    }
+
+    // 等槽位空出来；staged 模式下把它上一块的结果搬回用户数组
+    auto drain = [&](Slot& sl) {
+        if (sl.chunk < 0) return;
+        event_sync(sl.done);
+        if (staged) {
+            size_t lo = static_cast<size_t>(sl.chunk) * chunk;
+            size_t len = std::min(chunk, n - lo);
+            std::memcpy(c + lo, sl.h_c, len * sizeof(float));
+        }
+        sl.chunk = -1;
+    };
+
+    const size_t nchunks = (n + chunk - 1) / chunk;
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t k = 0; k < nchunks; ++k) {
+        Slot& sl = slot[k % slots];
+        Stream s = ss[k % streams];
+        size_t lo = k * chunk;
+        size_t len = std::min(chunk, n - lo);
+        const float* src_a = a + lo;
+        const float* src_b = b + lo;
+        float* dst_c = c + lo;
+        if (staged) {
+            drain(sl);
+            std::memcpy(sl.h_a, a + lo, len * sizeof(float));
+            std::memcpy(sl.h_b, b + lo, len * sizeof(float));
+            src_a = sl.h_a;
+            src_b = sl.h_b;
+            dst_c = sl.h_c;
+        }
+        copy_h2d_async(sl.d_a, src_a, len, s);
+        copy_h2d_async(sl.d_b, src_b, len, s);
+        launch_vec_add(sl.d_a, sl.d_b, sl.d_c, len, s);
+        copy_d2h_async(dst_c, sl.d_c, len, s);
+        event_record(sl.done, s);
+        sl.chunk = static_cast<long long>(k);
+    }
+    for (Slot& sl : slot) drain(sl);
+    device_sync();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    for (Slot& sl : slot) {
+        dev_free(sl.d_a);
+        dev_free(sl.d_b);
+        dev_free(sl.d_c);
+        if (staged) {
+            pinned_free(sl.h_a);
+            pinned_free(sl.h_b);
+            pinned_free(sl.h_c);
+        }
+        event_destroy(sl.done);
+    }
+    for (Stream s : ss) stream_destroy(s);
+    return ms;
+}
+
+// 端到端带宽：用户视角的字节数（读 a+b、写 c），时间包含全部拷贝
+static void report(const char* what, size_t n, double ms) {
+    double gbps = 3.0 * n * sizeof(float) / (ms * 1e-3) / 1e9;
+    std::printf("%-28s: time=%9.3f ms, end_to_end_bw=%.2f GB/s\n", what, ms, gbps);
+}
+
+// ================= 主函数 =================
+
+int main(int argc, char** argv) {
+    size_t n = 1 << 24;  // 默认 ~16M 元素，与 day1_vector_add.cu 相同
+    size_t chunk = 1 << 20;
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--link-gbps") == 0 && i + 1 < argc) {
+#if !defined(__CUDACC__)
+            g_link_gbps = std::atof(argv[i + 1]);
+#endif
+            ++i;
+        } else if (positional == 0) {
+            n = static_cast<size_t>(std::atoll(argv[i]));
+            ++positional;
+        } else {
+            chunk = static_cast<size_t>(std::atoll(argv[i]));
+            ++positional;
+        }
+    }
+    if (n == 0 || chunk == 0) {
+        std::fprintf(stderr, "Usage: %s [n] [chunk_elems] [--link-gbps X]\n", argv[0]);
+        return 1;
+    }
+    chunk = std::min(chunk, n);
+    std::printf("backend=%s N=%zu chunk=%zu", backend_name(), n, chunk);
+#if !defined(__CUDACC__)
+    if (g_link_gbps > 0) std::printf(" link=%.1f GB/s (emulated)", g_link_gbps);
+#endif
+    std::printf("\n");
+
+    // 用户数据：可分页内存（与 day1 的 std::vector 相同）和一份 pinned 副本（direct 模式用）
+    std::vector<float> h_a(n), h_b(n), h_c(n);
+    init_host(h_a.data(), h_b.data(), n);
+    float* p_a = pinned_alloc(n);
+    float* p_b = pinned_alloc(n);
+    float* p_c = pinned_alloc(n);
+    std::memcpy(p_a, h_a.data(), n * sizeof(float));
+    std::memcpy(p_b, h_b.data(), n * sizeof(float));
+
+    bool ok = true;
+    // 先跑一遍不计时的预热（CUDA 上下文初始化、页面首次访问）
+    run_pipeline_ms(p_a, p_b, p_c, n, chunk, 2, false);
+
+    std::fill(h_c.begin(), h_c.end(), 0.0f);
+    report("baseline (sync, pageable)", n, run_baseline_ms(h_a.data(), h_b.data(), h_c.data(), n));
+    ok &= check_correct(h_a.data(), h_b.data(), h_c.data(), n);
+
+    for (int streams : {1, 2, 4}) {
+        char name[64];
+        std::fill(h_c.begin(), h_c.end(), 0.0f);
+        std::snprintf(name, sizeof(name), "staged  streams=%d", streams);
+        report(name, n, run_pipeline_ms(h_a.data(), h_b.data(), h_c.data(), n, chunk, streams, true));
+        ok &= check_correct(h_a.data(), h_b.data(), h_c.data(), n);
+
+        std::fill(p_c, p_c + n, 0.0f);
+        std::snprintf(name, sizeof(name), "direct  streams=%d", streams);
+        report(name, n, run_pipeline_ms(p_a, p_b, p_c, n, chunk, streams, false));
+        ok &= check_correct(p_a, p_b, p_c, n);
+    }
+
+    pinned_free(p_a);
+    pinned_free(p_b);
+    pinned_free(p_c);
+    return ok ? 0 : 2;
+}
@@ -0,0 +1,328 @@
+#pragma once
+
+// 逐元素 kernel 的表达式模板（header-only）：把 day1 的 vec_add、trtion_code/fuse.py 的 x*y+z
+// 这类手写 kernel 变成一行 C++：
+//
+//   ew::Array x(n), y(n), z(n), out(n);
+//   out = x * y + z;            // 一个循环、一次遍历、没有临时数组
+//
+// `x * y + z` 不会立即计算，而是构造出类型 Binary<Add, Binary<Mul, Leaf, Leaf>, Leaf> 的小对象
+// （里面只有指针），赋值时才在一个循环里对每个下标求整棵树。于是：
+//   - 融合：中间结果 x*y 只活在寄存器里，内存流量 = 读 3 个输入 + 写 1 个输出
+//   - 向量化：每个节点除了标量 at(i) 还有 load(i)，一次求 8 个 float（GCC 向量扩展）；
+//             主循环有 AVX2+FMA 版和通用版，运行时按 CPU 选择
+//   - 多线程：按 64 字节对齐切块，每个线程一段连续下标（对应 CUDA 的一个 block）
+//
+// CUDA 后端（可选）：用 nvcc 编译时多出 ew::cuda::assign，同一棵表达式树按值传进 __global__ kernel，
+// 每个 CUDA 线程求一个下标的 at(i)。设备内存用 ew::view(d_ptr, n) 包成叶子。
+//
+// 支持：+ - * /、一元负号、与 float 标量混合（标量广播）。只处理 float。
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__CUDACC__)
+#include <cuda_runtime.h>
+#define EW_HD __host__ __device__
+#else
+#define EW_HD
+#endif
+
+// Packet 一律通过引用传递、从不按值作参数或返回值：按值传 32 字节向量时，不开 AVX 编译的调用方
+// 和开了 AVX 的函数 ABI 不同，GCC 会在每个这样的函数上给出 -Wpsabi 提示（内联也照样提示）。
+// 这些小函数强制内联进下面的 AVX2 / 通用入口，按入口的指令集生成代码
+#define EW_INLINE __attribute__((always_inline)) inline
+
+namespace ew {
+
+// 8 个 float 的 GCC 向量类型：在 AVX2 的函数里是一个 ymm 寄存器，在通用函数里编译器拆成两个 xmm
+typedef float Packet __attribute__((vector_size(32)));
+constexpr size_t kPacket = sizeof(Packet) / sizeof(float);
+
+EW_INLINE void loadPacket(const float* p, Packet& v) {
+    std::memcpy(&v, p, sizeof(v));  // 不要求对齐，编译成一条 vmovups
+}
+
+EW_INLINE void storePacket(float* p, const Packet& v) { std::memcpy(p, &v, sizeof(v)); }
+
+// ================= 1. 表达式节点 =================
+
+// 所有节点都继承它，用来识别“这是表达式”（operator 重载只对表达式生效）
+struct ExprBase {};
+
+// 叶子：一段 float 数组（主机或设备指针）。n 用于赋值时检查长度：树里每个叶子都必须和输出一样长
+struct Leaf : ExprBase {
+    const float* p;
+    size_t n;
+    EW_HD float at(size_t i) const { return p[i]; }
+    EW_INLINE void load(size_t i, Packet& v) const { loadPacket(p + i, v); }
+    bool fits(size_t len) const { return n == len; }
+};
+
+// 标量：广播到每个下标，任意长度都匹配
+struct Scalar : ExprBase {
+    float v;
+    EW_HD float at(size_t) const { return v; }
+    EW_INLINE void load(size_t, Packet& out) const { out = Packet{} + v; }
+    bool fits(size_t) const { return true; }
+};
+
+struct Add {
+    template <class T>
+    EW_HD EW_INLINE static void apply(T& a, const T& b) { a = a + b; }
+};
+struct Sub {
+    template <class T>
+    EW_HD EW_INLINE static void apply(T& a, const T& b) { a = a - b; }
+};
+struct Mul {
+    template <class T>
+    EW_HD EW_INLINE static void apply(T& a, const T& b) { a = a * b; }
+};
+struct Div {
+    template <class T>
+    EW_HD EW_INLINE static void apply(T& a, const T& b) { a = a / b; }
+};
+
+// 子节点按值保存：整棵树只是几个指针和标量，可以整体按值传给 CUDA kernel
+template <class Op, class L, class R>
+struct Binary : ExprBase {
+    L l;
+    R r;
+    EW_HD float at(size_t i) const {
+        float a = l.at(i);
+        Op::apply(a, r.at(i));
+        return a;
+    }
+    EW_INLINE void load(size_t i, Packet& out) const {
+        Packet b;
+        l.load(i, out);
+        r.load(i, b);
+        Op::apply(out, b);
+    }
+    // 逐个叶子检查，而不是只看最长的那个：x(16) + y(1M) 必须拒绝，否则会读出 x 的末尾
+    bool fits(size_t len) const { return l.fits(len) && r.fits(len); }
+};
+
+template <class E>
+struct Negate : ExprBase {
+    E e;
+    EW_HD float at(size_t i) const { return -e.at(i); }
+    EW_INLINE void load(size_t i, Packet& out) const {
+        e.load(i, out);
+        out = -out;
+    }
+    bool fits(size_t len) const { return e.fits(len); }
+};
+
+// ================= 2. 拥有内存的数组 =================
+
+template <class E>
+void assign(float* out, size_t n, const E& e, int threads = 0);
+
+class Array {
+public:
+    explicit Array(size_t n) : n_(n) {
+        void* p = nullptr;
+        if (posix_memalign(&p, 64, std::max<size_t>(n, 1) * sizeof(float)) != 0) throw std::bad_alloc();
+        p_ = static_cast<float*>(p);
+    }
+    ~Array() { std::free(p_); }
+    Array(const Array&) = delete;
+    Array& operator=(const Array&) = delete;
+    Array(Array&& o) noexcept : p_(std::exchange(o.p_, nullptr)), n_(std::exchange(o.n_, 0)) {}
+
+    // 赋值即求值：整棵表达式树在一个（多线程、向量化的）循环里算完
+    template <class E, class = std::enable_if_t<std::is_base_of<ExprBase, E>::value>>
+    Array& operator=(const E& e) {
+        assign(p_, n_, e);
+        return *this;
+    }
+    // 标量广播：和表达式走同一个多线程循环，大数组的首次写入（first touch）也分摊到各线程
+    Array& operator=(float v) {
+        assign(p_, n_, Scalar{{}, v});
+        return *this;
+    }
+
+    float* data() { return p_; }
+    const float* data() const { return p_; }
+    size_t size() const { return n_; }
+    float& operator[](size_t i) { return p_[i]; }
+    float operator[](size_t i) const { return p_[i]; }
+    Leaf leaf() const { return Leaf{{}, p_, n_}; }
+
+private:
+    float* p_ = nullptr;
+    size_t n_ = 0;
+};
+
+// 把外部内存（包括 cudaMalloc 得到的设备指针）包成叶子
+inline Leaf view(const float* p, size_t n) { return Leaf{{}, p, n}; }
+
+// ================= 3. 运算符 =================
+
+namespace detail {
+
+inline Leaf asExpr(const Array& a) { return a.leaf(); }
+inline Scalar asExpr(float v) { return Scalar{{}, v}; }
+template <class E, class = std::enable_if_t<std::is_base_of<ExprBase, E>::value>>
+const E& asExpr(const E& e) {
+    return e;
+}
+
+template <class T>
+using Decay = std::remove_cv_t<std::remove_reference_t<T>>;
+
+template <class T>
+constexpr bool isOperand = std::is_base_of<ExprBase, Decay<T>>::value || std::is_same<Decay<T>, Array>::value;
+
+// 至少一侧是数组或表达式，另一侧可以是 float 标量
+template <class L, class R>
+constexpr bool enableBinary =
+    (isOperand<L> && (isOperand<R> || std::is_arithmetic<Decay<R>>::value)) ||
+    (isOperand<R> && std::is_arithmetic<Decay<L>>::value);
+
+// 操作数在树里的节点类型：Array -> Leaf，数字 -> Scalar，表达式 -> 它自己
+template <class T>
+using ExprOf = std::conditional_t<std::is_same<Decay<T>, Array>::value, Leaf,
+                                  std::conditional_t<std::is_arithmetic<Decay<T>>::value, Scalar, Decay<T>>>;
+
+template <class Op, class L, class R>
+Binary<Op, ExprOf<L>, ExprOf<R>> make(const L& l, const R& r) {
+    return {{}, asExpr(static_cast<std::conditional_t<std::is_arithmetic<L>::value, float, const L&>>(l)),
+            asExpr(static_cast<std::conditional_t<std::is_arithmetic<R>::value, float, const R&>>(r))};
+}
+
+}  // namespace detail
+
+#define EW_BINARY_OPERATOR(sym, Op)                                                         \
+    template <class L, class R, class = std::enable_if_t<detail::enableBinary<L, R>>>       \
+    auto operator sym(const L& l, const R& r) {                                             \
+        return detail::make<Op>(l, r);                                                      \
+    }
+
+EW_BINARY_OPERATOR(+, Add)
+EW_BINARY_OPERATOR(-, Sub)
+EW_BINARY_OPERATOR(*, Mul)
+EW_BINARY_OPERATOR(/, Div)
+
+#undef EW_BINARY_OPERATOR
+
+template <class E, class = std::enable_if_t<detail::isOperand<E>>>
+auto operator-(const E& e) {
+    return Negate<detail::ExprOf<E>>{{}, detail::asExpr(e)};
+}
+
+// ================= 4. CPU 后端：向量化 + 多线程 =================
+
+namespace detail {
+
+// 主循环体：每次两个 Packet（16 个 float），尾部逐元素。
+// always_inline 进下面两个入口，才会分别按 AVX2 和通用指令集生成代码
+template <class E>
+__attribute__((always_inline)) inline void evalBody(float* out, const E& e, size_t lo, size_t hi) {
+    size_t i = lo;
+    for (; i + 2 * kPacket <= hi; i += 2 * kPacket) {
+        Packet v0, v1;
+        e.load(i, v0);
+        e.load(i + kPacket, v1);
+        storePacket(out + i, v0);
+        storePacket(out + i + kPacket, v1);
+    }
+    for (; i < hi; ++i) out[i] = e.at(i);
+}
+
+template <class E>
+void evalRangeGeneric(float* out, const E& e, size_t lo, size_t hi) {
+    evalBody(out, e, lo, hi);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// 打开 fma 后，GCC 的 C++ 默认（-ffp-contract=fast）会把 x*y+z 收缩成一条 vfmadd：只舍入一次，
+// 所以结果可能和“先乘后加各舍入一次”的标量写法差最后一位。要逐位一致就加 -ffp-contract=off
+template <class E>
+__attribute__((target("avx2,fma"))) void evalRangeAvx2(float* out, const E& e, size_t lo, size_t hi) {
+    evalBody(out, e, lo, hi);
+}
+
+inline bool hasAvx2() {
+    static const bool ok = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return ok;
+}
+#endif
+
+template <class E>
+void evalRange(float* out, const E& e, size_t lo, size_t hi) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (hasAvx2()) return evalRangeAvx2(out, e, lo, hi);
+#endif
+    evalRangeGeneric(out, e, lo, hi);
+}
+
+// 每个线程至少这么多元素，否则起线程的开销（几十微秒）比算还贵
+constexpr size_t kMinPerThread = 1 << 18;
+
+inline int defaultThreads() { return static_cast<int>(std::max(1u, std::thread::hardware_concurrency())); }
+
+}  // namespace detail
+
+// 求值入口：out[i] = e.at(i)，i ∈ [0, n)。threads=0 表示用全部硬件线程。
+// out 可以是表达式里的某个输入（如 a = a * b + c）：每个下标先读后写，互不影响
+template <class E>
+void assign(float* out, size_t n, const E& e, int threads) {
+    if (!e.fits(n)) throw std::invalid_argument("ew::assign: operand length mismatch");
+    if (threads <= 0) threads = detail::defaultThreads();
+    threads = static_cast<int>(std::min<size_t>(threads, std::max<size_t>(1, n / detail::kMinPerThread)));
+    if (threads == 1) {
+        detail::evalRange(out, e, 0, n);
+        return;
+    }
+    // 切块边界按 16 个 float（64 字节）对齐，两个线程不会写同一条缓存行
+    const size_t align = 16;
+    size_t blocks = (n + align - 1) / align;
+    std::vector<std::thread> team;
+    for (int t = 1; t < threads; ++t) {
+        size_t lo = std::min(n, blocks * t / threads * align);
+        size_t hi = std::min(n, blocks * (t + 1) / threads * align);
+        team.emplace_back([=, &e] { detail::evalRange(out, e, lo, hi); });
+    }
+    detail::evalRange(out, e, 0, std::min(n, blocks / threads * align));
+    for (auto& th : team) th.join();
+}
+
+// ================= 5. CUDA 后端（可选） =================
+
+#if defined(__CUDACC__)
+namespace cuda {
+
+// 表达式树按值传入（里面都是设备指针和标量），grid-stride 循环：grid 不必覆盖全部元素
+template <class E>
+__global__ void assignKernel(float* __restrict__ out, size_t n, E e) {
+    size_t stride = static_cast<size_t>(gridDim.x) * blockDim.x;
+    for (size_t i = static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x; i < n; i += stride) {
+        out[i] = e.at(i);
+    }
+}
+
+// d_out 和表达式里的叶子都必须是设备内存（用 ew::view 包装）；异步，需要时调用方自己同步
+template <class E>
+cudaError_t assign(float* d_out, size_t n, const E& e, int blockDim = 256, cudaStream_t stream = 0) {
+    if (!e.fits(n)) return cudaErrorInvalidValue;
+    size_t blocks = std::min<size_t>((n + blockDim - 1) / blockDim, 65535u * 16);
+    if (blocks == 0) return cudaSuccess;
+    assignKernel<<<static_cast<unsigned>(blocks), blockDim, 0, stream>>>(d_out, n, e);
+    return cudaGetLastError();
+}
+
+}  // namespace cuda
+#endif
+
+}  // namespace ew
@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "elementwise_expr.h"
+#include "../../common/verify.h"
+
+// 表达式模板版的逐元素 kernel（elementwise_expr.h）：
+// 1) 写：day1 的 vec_add 和 trtion_code/fuse.py 的 x*y+z 都变成一行 `out = x * y + z;`
+// 2) 验：和逐元素的标量参考循环对比（AVX2+FMA 路径会把 x*y+z 收缩成 FMA，允许最后一位的差别）
+// 3) 测：融合 vs 不融合
+//    - fused   ：表达式模板，一次遍历，中间结果在寄存器里
+//    - unfused ：同样向量化 + 多线程，但一次只算一个运算、中间结果写回内存（像 torch 的 eager 模式 x*y 再 +z）
+//    - loop    ：手写的单线程 for 循环（编译器自动向量化），作为“没有框架”时的基线
+//
+// 编译运行：
+//   g++ -O3 -std=c++17 -pthread elementwise_fuse.cpp -o elementwise_fuse
+//   ./elementwise_fuse                      # 正确性 demo
+//   ./elementwise_fuse bench                # 16M、64M 元素
+//   ./elementwise_fuse bench 16 256 1024    # 指定规模（单位：百万元素），内存不够的规模会跳过
+// CUDA 后端（需要 nvcc）：
+//   nvcc -O3 -std=c++17 -x cu elementwise_fuse.cpp -o elementwise_fuse_cuda && ./elementwise_fuse_cuda cuda
+
+// ================= 1. 正确性 demo =================
+
+static void init_inputs(ew::Array& x, ew::Array& y, ew::Array& z) {
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = static_cast<float>(i % 1024) * 0.001f;
+        y[i] = static_cast<float>((i * 7) % 1024) * 0.001f;
+        z[i] = static_cast<float>((i * 13) % 1024) * 0.001f - 0.5f;
+    }
+}
+
+// 绝对 + 相对误差各 1e-6：比 float 的一个 ulp（约 6e-8）宽，容得下 FMA 少一次舍入；
+// 结果接近 0 时（x*y 与 z 相互抵消）ULP 距离会很大，所以不用 ULP 判定
+static const verify::Tolerance kTol{1e-6, 1e-6, -1};
+
+template <class Ref>
+static bool check(const char* what, const ew::Array& out, Ref ref) {
+    verify::Report r = verify::compareFn(
+        out.data(), out.size(),
+        [&](size_t lo, size_t len, float* dst) {
+            for (size_t i = 0; i < len; ++i) dst[i] = ref(lo + i);
+        },
+        kTol);
+    std::printf("%s %s (max_ulp=%lld)\n", r.ok ? "✅" : "❌", what, static_cast<long long>(r.maxUlp));
+    return r.ok || verify::print(r, what);
+}
+
+static bool runDemo() {
+    // 故意取一个不是 16 的倍数的长度，覆盖尾部和线程切块边界
+    const size_t n = (1 << 20) + 37;
+    ew::Array x(n), y(n), z(n), out(n);
+    init_inputs(x, y, z);
+
+    bool ok = true;
+    out = x + y;  // day1 的 vec_add
+    ok &= check("out = x + y", out, [&](size_t i) { return x[i] + y[i]; });
+    out = x * y + z;  // fuse.py 的 fuse_kernel
+    ok &= check("out = x * y + z", out, [&](size_t i) { return x[i] * y[i] + z[i]; });
+    out = 2.0f * x - y / 4.0f + (-z);
+    ok &= check("out = 2 * x - y / 4 + (-z)", out, [&](size_t i) { return 2.0f * x[i] - y[i] / 4.0f + -z[i]; });
+
+    // 输出和输入是同一个数组也没问题：每个下标先读后写
+    ew::Array acc(n);
+    acc = x + 0.0f;
+    acc = acc * y + z;
+    ok &= check("acc = acc * y + z (in place)", acc, [&](size_t i) { return (x[i] + 0.0f) * y[i] + z[i]; });
+
+    // 标量广播赋值只写不读：原来的内容（这里故意放 NaN）不影响结果
+    std::fill(acc.data(), acc.data() + n, std::numeric_limits<float>::quiet_NaN());
+    acc = 1.25f;
+    ok &= check("acc = 1.25 (scalar fill over NaN)", acc, [](size_t) { return 1.25f; });
+
+    // 长度不一致必须抛异常：输出比输入短、较短的操作数藏在子树里、长度为 0 的叶子
+    ew::Array shorter(n - 1), tiny(16), empty(0);
+    auto expectMismatch = [&](const char* what, auto&& run) {
+        try {
+            run();
+            std::printf("❌ length mismatch was not detected: %s\n", what);
+            ok = false;
+        } catch (const std::invalid_argument&) {
+            std::printf("✅ length mismatch throws std::invalid_argument: %s\n", what);
+        }
+    };
+    expectMismatch("shorter = x + y", [&] { shorter = x + y; });
+    expectMismatch("out = tiny + y", [&] { out = tiny + y; });
+    expectMismatch("out = x * (tiny + 1) + z", [&] { out = x * (tiny + 1.0f) + z; });
+    expectMismatch("out = empty + y", [&] { out = empty + y; });
+    return ok;
+}
+
+// ================= 2. 融合 vs 不融合 =================
+
+template <class F>
+static double time_ms(F&& f, int iters) {
+    f();  // 预热：把页面都摸一遍
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iters; ++i) f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / iters;
+}
+
+static double availableBytes() {
+    std::ifstream in("/proc/meminfo");
+    std::string key;
+    double kb = 0;
+    while (in >> key >> kb) {
+        if (key == "MemAvailable:") return kb * 1024.0;
+        in.ignore(256, '\n');
+    }
+    return 1e18;  // 读不到就不做限制
+}
+
+// 手写基线：单线程普通循环，-O3 下会被自动向量化
+static void loopAdd(const float* x, const float* y, float* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = x[i] + y[i];
+}
+static void loopMul(const float* x, const float* y, float* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = x[i] * y[i];
+}
+static void loopFma(const float* x, const float* y, const float* z, float* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = x[i] * y[i] + z[i];
+}
+
+static void report(const char* op, const char* variant, size_t n, double ms, double logicalBytes) {
+    std::printf("  %-4s %-8s time=%9.3f ms  effective_bw=%7.2f GB/s  (%.2f ns/elem)\n", op, variant, ms,
+                logicalBytes / (ms * 1e-3) / 1e9, ms * 1e6 / n);
+}
+
+static void runBenchmark(const std::vector<long>& sizesM) {
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::printf("threads=%d, effective_bw 按逻辑字节数计（读全部输入 + 写输出各一次），"
+                "不融合版本实际流量更大，所以它的 effective_bw 会更低\n",
+                threads);
+    for (long m : sizesM) {
+        const size_t n = static_cast<size_t>(m) * 1000000;
+        // x, y, z, out, tmp 五个数组
+        double need = 5.0 * n * sizeof(float);
+        if (need > 0.8 * availableBytes()) {
+            std::printf("N=%ldM: skipped (needs %.1f GB, only %.1f GB available)\n", m, need / 1e9,
+                        availableBytes() / 1e9);
+            continue;
+        }
+        ew::Array x(n), y(n), z(n), out(n), tmp(n);
+        // 标量赋值是并行的：大数组串行写一遍就要好几秒
+        x = 1.25f;
+        y = x * 0.5f;
+        z = x - 3.0f;
+        out = 0.0f;
+        tmp = 0.0f;
+        const int iters = static_cast<int>(std::clamp<double>(2e9 / (16.0 * n), 3, 50));
+        const double b2 = 3.0 * n * sizeof(float), b3 = 4.0 * n * sizeof(float);
+        std::printf("N=%ldM (iters=%d)\n", m, iters);
+
+        report("add", "loop", n, time_ms([&] { loopAdd(x.data(), y.data(), out.data(), n); }, iters), b2);
+        report("add", "fused", n, time_ms([&] { out = x + y; }, iters), b2);
+
+        report("mul", "loop", n, time_ms([&] { loopMul(x.data(), y.data(), out.data(), n); }, iters), b2);
+        report("mul", "fused", n, time_ms([&] { out = x * y; }, iters), b2);
+
+        report("fma", "loop", n, time_ms([&] { loopFma(x.data(), y.data(), z.data(), out.data(), n); }, iters), b3);
+        report("fma", "unfused", n,
+               time_ms(
+                   [&] {
+                       tmp = x * y;
+                       out = tmp + z;
+                   },
+                   iters),
+               b3);
+        report("fma", "fused", n, time_ms([&] { out = x * y + z; }, iters), b3);
+        // 一致性：融合版可能用了 FMA（少一次舍入），只要求在误差范围内相同
+        out = x * y + z;
+        tmp = x * y;
+        tmp = tmp + z;
+        verify::Report r = verify::compare(out.data(), tmp.data(), n, kTol);
+        std::printf("  fused ≈ unfused: %s (max_ulp=%lld)\n", r.ok ? "✅" : "❌", static_cast<long long>(r.maxUlp));
+    }
+}
+
+// ================= 3. CUDA 后端 =================
+
+#if defined(__CUDACC__)
+static int runCuda() {
+    const size_t n = 1 << 24;
+    ew::Array x(n), y(n), z(n), out(n);
+    init_inputs(x, y, z);
+    float *dx, *dy, *dz, *dout;
+    for (float** p : {&dx, &dy, &dz, &dout}) {
+        if (cudaMalloc(p, n * sizeof(float)) != cudaSuccess) {
+            std::fprintf(stderr, "cudaMalloc failed\n");
+            return 1;
+        }
+    }
+    cudaMemcpy(dx, x.data(), n * sizeof(float), cudaMemcpyHostToDevice);
+    cudaMemcpy(dy, y.data(), n * sizeof(float), cudaMemcpyHostToDevice);
+    cudaMemcpy(dz, z.data(), n * sizeof(float), cudaMemcpyHostToDevice);
+
+    // 同一行表达式，叶子换成设备指针
+    auto e = ew::view(dx, n) * ew::view(dy, n) + ew::view(dz, n);
+    cudaEvent_t start, stop;
+    cudaEventCreate(&start);
+    cudaEventCreate(&stop);
+    for (int i = 0; i < 5; ++i) ew::cuda::assign(dout, n, e);
+    cudaEventRecord(start);
+    const int iters = 200;
+    for (int i = 0; i < iters; ++i) ew::cuda::assign(dout, n, e);
+    cudaEventRecord(stop);
+    cudaEventSynchronize(stop);
+    float ms = 0;
+    cudaEventElapsedTime(&ms, start, stop);
+    ms /= iters;
+    cudaMemcpy(out.data(), dout, n * sizeof(float), cudaMemcpyDeviceToHost);
+
+    bool ok = check("cuda: out = x * y + z", out, [&](size_t i) { return x[i] * y[i] + z[i]; });
+    std::printf("cuda fused x*y+z: time=%.4f ms, effective_bw=%.2f GB/s\n", ms, 4.0 * n * sizeof(float) / (ms * 1e-3) / 1e9);
+    for (float* p : {dx, dy, dz, dout}) cudaFree(p);
+    return ok ? 0 : 1;
+}
+#endif
+
+// ================= 主函数 =================
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && std::strcmp(argv[1], "bench") == 0) {
+        std::vector<long> sizes;
+        for (int i = 2; i < argc; ++i) sizes.push_back(std::atol(argv[i]));
+        if (sizes.empty()) sizes = {16, 64};
+        runBenchmark(sizes);
+        return 0;
+    }
+#if defined(__CUDACC__)
+    if (argc >= 2 && std::strcmp(argv[1], "cuda") == 0) return runCuda();
+#endif
+    return runDemo() ? 0 : 1;
+}
@@ -1,18 +1,316 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <random>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 // Day1 交付：安全 swap（含自交换）+ 使用 move 避免深拷贝
+//
+// 进阶版 my_swap 按类型在编译期选路径（没有运行期分支）：
+//   1) 类型自带的 ADL swap（例如 std::vector 的 swap 重载、用户在类旁边写的 friend swap）
+//   2) 成员函数 a.swap(b)
+//   3) 可“平凡重定位”的类型：按字节交换（memmove 过一个栈上缓冲区）
+//   4) 以上都没有：经典的三次 move
+// 自交换不再需要 if (&a == &b)：三次 move 经过 tmp 中转，a = std::move(a) 作用在已被搬空的对象上，
+// 最后 tmp 再搬回来，结果不变；标准库的 swap 本身也支持自交换；按字节交换用 memmove，源和目标相同也合法。
+//
+// 编译运行：
+//   g++ -O2 -std=c++17 swap_safe.cpp -o swap_safe
+//   ./swap_safe          # 演示
+//   ./swap_safe bench    # 基准
+
+// Day1 版本：保留下来做基准对照
 template <class T>
-void my_swap(T& a, T& b) {
+void my_swap_basic(T& a, T& b) {
     if (&a == &b) return; // 自交换：直接返回
     T tmp = std::move(a);
     a = std::move(b);
     b = std::move(tmp);
 }
 
-int main() {
+// ================= 1. 类型探测 =================
+
+// “平凡重定位”：把对象的字节搬到别处、原处不再析构，等价于 move 构造 + 析构原对象。
+// 平凡可拷贝的类型一定满足；只持有 unique_ptr / 普通指针的类型通常也满足，但编译器无法推断，需要手动特化声明。
+// 注意 libstdc++ 的 std::string（短字符串指向自身内部缓冲区）就不满足，不能特化
+template <class T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+namespace swap_detail {
+
+// 毒丸：让无限定的 swap(a, b) 在这里找不到 std::swap 的通用模板，只剩 ADL 找到的重载。
+// 只能经 ADL 找到通用 std::swap 的类型（例如 std::complex），两个模板同样特化，调用有歧义 → 判定为“没有专门的 swap”
+template <class T>
+void swap(T&, T&) = delete;
+
+template <class T, class = void>
+struct has_adl_swap : std::false_type {};
+template <class T>
+struct has_adl_swap<T, std::void_t<decltype(swap(std::declval<T&>(), std::declval<T&>()))>> : std::true_type {};
+
+template <class T>
+void adl_swap(T& a, T& b) {
+    swap(a, b);
+}
+
+template <class T, class = void>
+struct has_member_swap : std::false_type {};
+template <class T>
+struct has_member_swap<T, std::void_t<decltype(std::declval<T&>().swap(std::declval<T&>()))>> : std::true_type {};
+
+}  // namespace swap_detail
+
+// ================= 2. my_swap =================
+
+template <class T>
+void my_swap(T& a, T& b) {
+    if constexpr (swap_detail::has_adl_swap<T>::value) {
+        swap_detail::adl_swap(a, b);
+    } else if constexpr (swap_detail::has_member_swap<T>::value) {
+        a.swap(b);
+    } else if constexpr (is_trivially_relocatable<T>::value) {
+        alignas(T) unsigned char tmp[sizeof(T)];
+        std::memcpy(tmp, static_cast<void*>(&a), sizeof(T));
+        std::memmove(static_cast<void*>(&a), static_cast<const void*>(&b), sizeof(T));
+        std::memcpy(static_cast<void*>(&b), tmp, sizeof(T));
+    } else {
+        T tmp = std::move(a);
+        a = std::move(b);
+        b = std::move(tmp);
+    }
+}
+
+// ================= 3. my_swap_ranges =================
+
+namespace swap_detail {
+
+inline void swapBytesScalar(unsigned char* a, unsigned char* b, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t x, y;
+        std::memcpy(&x, a + i, 8);
+        std::memcpy(&y, b + i, 8);
+        std::memcpy(a + i, &y, 8);
+        std::memcpy(b + i, &x, 8);
+    }
+    for (; i < n; ++i) std::swap(a[i], b[i]);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// 每轮两边各读 128 字节再交叉写回，读写都是 32 字节向量
+__attribute__((target("avx2"))) inline void swapBytesAvx2(unsigned char* a, unsigned char* b, size_t n) {
+    size_t i = 0;
+    for (; i + 128 <= n; i += 128) {
+        __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 32));
+        __m256i a2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 64));
+        __m256i a3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 96));
+        __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 32));
+        __m256i b2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 64));
+        __m256i b3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 96));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i), b0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i + 32), b1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i + 64), b2);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i + 96), b3);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(b + i), a0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(b + i + 32), a1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(b + i + 64), a2);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(b + i + 96), a3);
+    }
+    swapBytesScalar(a + i, b + i, n - i);
+}
+
+#endif
+
+inline void swapBytes(unsigned char* a, unsigned char* b, size_t n) {
+#if defined(__x86_64__) || defined(__i386__)
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2) {
+        swapBytesAvx2(a, b, n);
+        return;
+    }
+#endif
+    swapBytesScalar(a, b, n);
+}
+
+}  // namespace swap_detail
+
+// 交换 a[0, n) 与 b[0, n)。与 std::swap_ranges 相同，两段不能部分重叠（完全相同可以，结果不变）。
+// 可平凡重定位的元素类型整段按字节交换（向量化）；否则逐个 my_swap
+template <class T>
+void my_swap_ranges(T* a, T* b, size_t n) {
+    if constexpr (is_trivially_relocatable<T>::value) {
+        if (a == b) return;
+        swap_detail::swapBytes(reinterpret_cast<unsigned char*>(a), reinterpret_cast<unsigned char*>(b), n * sizeof(T));
+    } else {
+        for (size_t i = 0; i < n; ++i) my_swap(a[i], b[i]);
+    }
+}
+
+// ================= 4. 演示用的类型 =================
+
+// 老式大对象：声明了拷贝构造/赋值，于是没有隐式 move，三次“move”其实是三次深拷贝；
+// 但它提供了 O(1) 的成员 swap
+class LegacyMatrix {
+public:
+    explicit LegacyMatrix(size_t n = 0) : n_(n), data_(n ? new double[n * n]() : nullptr) {}
+    LegacyMatrix(const LegacyMatrix& o) : n_(o.n_), data_(o.n_ ? new double[o.n_ * o.n_] : nullptr) {
+        std::copy(o.data_, o.data_ + n_ * n_, data_);
+    }
+    LegacyMatrix& operator=(const LegacyMatrix& o) {
+        LegacyMatrix tmp(o);
+        swap(tmp);
+        return *this;
+    }
+    ~LegacyMatrix() { delete[] data_; }
+
+    void swap(LegacyMatrix& o) noexcept {
+        std::swap(n_, o.n_);
+        std::swap(data_, o.data_);
+    }
+    double& at(size_t i, size_t j) { return data_[i * n_ + j]; }
+    size_t size() const { return n_; }
+
+private:
+    size_t n_;
+    double* data_;
+};
+
+// 只持有 unique_ptr 和长度：按字节搬动是安全的，手动声明为可平凡重定位
+struct Blob {
+    std::unique_ptr<int[]> data;
+    size_t size = 0;
+};
+template <>
+struct is_trivially_relocatable<Blob> : std::true_type {};
+
+namespace geo {
+// 用户在类型旁边写的 swap，靠 ADL 被找到
+struct Point {
+    double x, y;
+    int swaps = 0;
+};
+inline void swap(Point& a, Point& b) noexcept {
+    std::swap(a.x, b.x);
+    std::swap(a.y, b.y);
+    ++a.swaps;
+    ++b.swaps;
+}
+}  // namespace geo
+
+// ================= 5. 基准 =================
+
+template <class F>
+static double bestSeconds(F&& f, int reps) {
+    double best = 1e100;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+    }
+    return best;
+}
+
+static int runBenchmark() {
+    std::mt19937 rng(40);
+    bool ok = true;
+
+    // 5.1 单次交换：随机下标对，反复交换数组里的元素
+    const size_t pairs = 2000000;
+    std::vector<std::pair<uint32_t, uint32_t>> idx(pairs);
+    auto perSwapNs = [&](auto& arr, auto&& swapFn) {
+        for (auto& p : idx) p = {static_cast<uint32_t>(rng() % arr.size()), static_cast<uint32_t>(rng() % arr.size())};
+        double t = bestSeconds([&] {
+            for (auto& p : idx) swapFn(arr[p.first], arr[p.second]);
+        }, 3);
+        return t * 1e9 / idx.size();
+    };
+    std::printf("单次交换（%zu 次随机下标对，ns/次）\n", pairs);
+
+    {
+        std::vector<std::vector<int>> vs(1024);
+        for (size_t i = 0; i < vs.size(); ++i) vs[i].assign(i % 64 + 1, static_cast<int>(i));
+        double basic = perSwapNs(vs, [](auto& a, auto& b) { my_swap_basic(a, b); });
+        double fast = perSwapNs(vs, [](auto& a, auto& b) { my_swap(a, b); });
+        std::printf("  %-34s basic %7.2f  my_swap %7.2f\n", "std::vector<int>（ADL swap）", basic, fast);
+    }
+    {
+        std::vector<LegacyMatrix> ms;
+        for (int i = 0; i < 256; ++i) {
+            ms.emplace_back(16);
+            ms.back().at(0, 0) = i;
+        }
+        const size_t saved = pairs;
+        idx.resize(pairs / 100);  // 深拷贝太慢，少做一些
+        double basic = perSwapNs(ms, [](auto& a, auto& b) { my_swap_basic(a, b); });
+        double fast = perSwapNs(ms, [](auto& a, auto& b) { my_swap(a, b); });
+        idx.resize(saved);
+        std::printf("  %-34s basic %7.2f  my_swap %7.2f\n", "LegacyMatrix 16x16（成员 swap）", basic, fast);
+        double sum = 0;
+        for (auto& m : ms) sum += m.at(0, 0);
+        ok &= sum == 255.0 * 256 / 2;
+    }
+    {
+        std::vector<Blob> bs(1024);
+        for (size_t i = 0; i < bs.size(); ++i) {
+            bs[i].size = 1;
+            bs[i].data.reset(new int[1]{static_cast<int>(i)});
+        }
+        double basic = perSwapNs(bs, [](auto& a, auto& b) { my_swap_basic(a, b); });
+        double fast = perSwapNs(bs, [](auto& a, auto& b) { my_swap(a, b); });
+        std::printf("  %-34s basic %7.2f  my_swap %7.2f\n", "Blob（unique_ptr，按字节）", basic, fast);
+        long long sum = 0;
+        for (auto& b : bs) sum += b.data[0];
+        ok &= sum == 1023LL * 1024 / 2;
+    }
+
+    // 5.2 整段交换：两个 64MB 数组
+    const size_t n = (64u << 20) / sizeof(int);
+    std::vector<int> a(n), b(n);
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = static_cast<int>(i);
+        b[i] = -static_cast<int>(i);
+    }
+    auto report = [&](const char* name, double t) {
+        // 两边各读一遍、写一遍
+        std::printf("  %-34s %8.2f ms  %6.2f GB/s\n", name, t * 1e3, 4.0 * n * sizeof(int) / t / 1e9);
+    };
+    std::printf("整段交换（2 × %zu MB int）\n", n * sizeof(int) >> 20);
+    report("逐个 my_swap_basic", bestSeconds([&] {
+               for (size_t i = 0; i < n; ++i) my_swap_basic(a[i], b[i]);
+           }, 3));
+    report("std::swap_ranges", bestSeconds([&] { std::swap_ranges(a.begin(), a.end(), b.begin()); }, 3));
+    report("my_swap_ranges", bestSeconds([&] { my_swap_ranges(a.data(), b.data(), n); }, 3));
+    // 上面一共交换了 9 次（奇数），a 应当变成原来的 b
+    for (size_t i = 0; i < n; i += 4097) ok &= a[i] == -static_cast<int>(i) && b[i] == static_cast<int>(i);
+
+    // 非平凡类型走逐个 my_swap；不同长度覆盖向量循环的零头
+    for (size_t len : {0u, 1u, 7u, 33u, 129u, 1000u}) {
+        std::vector<std::string> x(len, "x"), y(len, "yyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyy");
+        my_swap_ranges(x.data(), y.data(), len);
+        std::vector<char> p(len, 'p'), q(len, 'q');
+        my_swap_ranges(p.data(), q.data(), len);
+        for (size_t i = 0; i < len; ++i) ok &= x[i].size() == 32 && y[i] == "x" && p[i] == 'q' && q[i] == 'p';
+    }
+
+    std::cout << (ok ? "✅ 交换结果正确" : "❌ 交换结果有误") << "\n";
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && std::strcmp(argv[1], "bench") == 0) return runBenchmark();
+
     // 1) 基本类型
     int x = 1, y = 2;
     my_swap(x, y);
@@ -28,6 +326,21 @@ int main() {
     std::string s = "hello";
     my_swap(s, s);
     std::cout << "s=" << s << "\n";
+
+    // 4) 走哪条路径是编译期决定的
+    static_assert(swap_detail::has_adl_swap<std::vector<int>>::value, "vector 有专门的 swap 重载");
+    static_assert(swap_detail::has_adl_swap<geo::Point>::value, "geo::swap 通过 ADL 找到");
+    static_assert(!swap_detail::has_adl_swap<Blob>::value, "Blob 没有自己的 swap");
+    static_assert(swap_detail::has_member_swap<LegacyMatrix>::value, "LegacyMatrix 有成员 swap");
+    static_assert(is_trivially_relocatable<Blob>::value, "Blob 手动声明可平凡重定位");
+    geo::Point p{1, 2}, q{3, 4};
+    my_swap(p, q);
+    std::cout << "p=(" << p.x << "," << p.y << ") 调用了 geo::swap " << p.swaps << " 次\n";
+    Blob b1, b2;
+    b1.data.reset(new int[1]{42});
+    b1.size = 1;
+    my_swap(b1, b2);
+    my_swap(b2, b2);
+    std::cout << "Blob 按字节交换后 b2.data[0]=" << b2.data[0] << " b1.data=" << (b1.data ? "非空" : "空") << "\n";
     return 0;
 }
-
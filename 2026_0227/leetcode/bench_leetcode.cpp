@@ -0,0 +1,326 @@
+// leetcode 各题解法的统一基准：大规模随机输入、预热 + 多次重复、ns/元素 + 95% 置信区间、各实现结果交叉校验。
+//
+// 覆盖：125 isPalindrome、383 canConstruct、88 merge、134 canCompleteCircuit（2025_0921/134.cpp）。
+// 做法：每道题的解法都在自己的头文件里（leetcode_125.h / leetcode_383.h / leetcode_88.h / 2025_0921/134.h），
+// 各自的命名空间 lc125 / lc383 / lc88 / lc134 里，各题的 Solution 同名也不冲突；题目的 .cpp 只剩自己的 main 和基准。
+// 134 的逐步日志用 GAS_STATION_LOG=0 在编译期去掉。
+//
+// 编译运行：
+//   g++ -O3 -std=c++17 -pthread bench_leetcode.cpp -o bench_leetcode
+//   ./bench_leetcode                               # 全部题目，默认 16MB 输入
+//   ./bench_leetcode merge --mb 64 --reps 20 --warmup 3 --threads 4
+//   题目名：palindrome | ransom | merge | gas | all
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "../../common/trace_ring.h"
+#include "../../common/work_stealing_pool.h"
+
+#define GAS_STATION_LOG 0
+#include "../../2025_0921/134.h"
+#include "leetcode_125.h"
+#include "leetcode_383.h"
+#include "leetcode_88.h"
+
+using namespace std;
+
+// ================= 1. 计时与统计 =================
+
+struct Options {
+    size_t mb = 16;
+    int warmup = 2;
+    int reps = 10;
+    unsigned threads = max(1u, thread::hardware_concurrency());
+};
+
+struct Stats {
+    double mean = 0;
+    double ci95 = 0;  // 均值的 95% 置信区间半宽
+    double median = 0;
+    double best = 0;
+};
+
+// 自由度 1..30 的双侧 95% t 分位数，更大时用正态近似
+inline double tQuantile95(int df) {
+    static const double t[] = {0,     12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                               2.201, 2.179,  2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086, 2.080,
+                               2.074, 2.069,  2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    return df >= 1 && df <= 30 ? t[df] : 1.960;
+}
+
+inline Stats summarize(vector<double> samples) {
+    Stats s;
+    const size_t n = samples.size();
+    if (n == 0) return s;
+    sort(samples.begin(), samples.end());
+    s.best = samples.front();
+    s.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    for (double x : samples) s.mean += x;
+    s.mean /= n;
+    if (n >= 2) {
+        double var = 0;
+        for (double x : samples) var += (x - s.mean) * (x - s.mean);
+        var /= n - 1;
+        s.ci95 = tQuantile95(static_cast<int>(n - 1)) * sqrt(var / n);
+    }
+    return s;
+}
+
+static volatile long long g_sink = 0;
+
+// setup() 不计时（例如把被原地修改的输入恢复原样），run() 计时；先跑 warmup 次不记录
+template <class Setup, class Run>
+Stats measure(const Options& opt, size_t elements, Setup&& setup, Run&& run) {
+    vector<double> ns;
+    for (int r = 0; r < opt.warmup + opt.reps; ++r) {
+        setup();
+        auto t0 = chrono::steady_clock::now();
+        g_sink = g_sink + static_cast<long long>(run());
+        auto t1 = chrono::steady_clock::now();
+        if (r >= opt.warmup) ns.push_back(chrono::duration<double, nano>(t1 - t0).count() / elements);
+    }
+    return summarize(ns);
+}
+
+template <class Run>
+Stats measure(const Options& opt, size_t elements, Run&& run) {
+    return measure(opt, elements, [] {}, run);
+}
+
+inline void report(const char* name, const Stats& s) {
+    printf("  %-32s %9.4f ± %.4f ns/元素  (中位数 %.4f, 最好 %.4f)\n", name, s.mean, s.ci95, s.median, s.best);
+}
+
+inline bool reportCheck(const char* what, bool ok) {
+    printf("  %s %s\n", ok ? "✅" : "❌", what);
+    return ok;
+}
+
+// ================= 2. 125 isPalindrome =================
+
+bool benchPalindrome(const Options& opt) {
+    printf("\n=== 125 isPalindrome（%zu MB 带噪声回文）===\n", opt.mb);
+    mt19937 rng(125);
+    bool ok = true;
+    // 随机短串（大多不是回文）+ 随机噪声回文
+    const char alphabet[] = "aAbB01 ,.:";
+    for (int iter = 0; iter < 20000 && ok; ++iter) {
+        string s;
+        if (iter % 2) {
+            s = lc125::makeNoisyPalindrome(rng() % 200, rng());
+            if (iter % 4 == 1 && !s.empty()) s[rng() % s.size()] = 'q';
+        } else {
+            s.resize(rng() % 80);
+            for (auto& c : s) c = alphabet[rng() % (sizeof(alphabet) - 1)];
+        }
+        bool ref = lc125::Solution().isPalindrome(s);
+        ok &= lc125::palindrome::isPalindromeTwoPointer(s.data(), s.size()) == ref;
+        ok &= lc125::palindrome::isPalindromeFast(s) == ref;
+    }
+    ok &= reportCheck("短串交叉校验（Solution / TwoPointer / Fast）", ok);
+
+    string big = lc125::makeNoisyPalindrome(opt.mb << 20, 125);
+    const size_t n = big.size();
+    bool expect = lc125::Solution().isPalindrome(big);
+    ok &= reportCheck("大输入结果一致", expect == lc125::palindrome::isPalindromeTwoPointer(big.data(), n) &&
+                                         expect == lc125::palindrome::isPalindromeFast(big));
+    report("Solution::isPalindrome", measure(opt, n, [&] { return lc125::Solution().isPalindrome(big); }));
+    report("isPalindromeTwoPointer",
+           measure(opt, n, [&] { return lc125::palindrome::isPalindromeTwoPointer(big.data(), n); }));
+    report("isPalindromeFast", measure(opt, n, [&] { return lc125::palindrome::isPalindromeFast(big); }));
+    return ok;
+}
+
+// ================= 3. 383 canConstruct =================
+
+bool benchRansom(const Options& opt) {
+    printf("\n=== 383 canConstruct（magazine %zu MB，note 为其 1/8）===\n", opt.mb);
+    mt19937 rng(383);
+    bool ok = true;
+    for (int iter = 0; iter < 5000 && ok; ++iter) {
+        string m = lc383::randomLetters(rng, rng() % 2000, 3);
+        string note = lc383::randomLetters(rng, rng() % 800, 3);
+        bool ref = lc383::Solution().canConstruct(note, m);
+        ok &= lc383::ransom::canConstructFast(note, m) == ref;
+        ok &= lc383::ransom::canConstructWith(lc383::ransom::histogramBanked, note, m) == ref;
+        ok &= lc383::ransom::canConstructBytes(note, m) == ref;
+        ok &= lc383::ransom::canConstructUtf8(note, m) == ref;
+    }
+    ok &= reportCheck("短串交叉校验（Solution / Fast / Banked / Bytes / Utf8）", ok);
+
+    // note 取 magazine 的一个打乱的片段：一定可以构成，早停版本也要扫到 magazine 的大约 1/8 之后
+    string mag = lc383::randomLetters(rng, opt.mb << 20, 26);
+    string note = mag.substr(0, mag.size() / 8);
+    shuffle(note.begin(), note.end(), rng);
+    const size_t n = mag.size() + note.size();
+    bool expect = lc383::Solution().canConstruct(note, mag);
+    ok &= reportCheck("大输入结果一致", expect && lc383::ransom::canConstructFast(note, mag) &&
+                                         lc383::ransom::canConstructBytes(note, mag) &&
+                                         lc383::ransom::canConstructUtf8(note, mag));
+    report("Solution::canConstruct", measure(opt, n, [&] { return lc383::Solution().canConstruct(note, mag); }));
+    report("canConstructWith(banked)", measure(opt, n, [&] {
+               return lc383::ransom::canConstructWith(lc383::ransom::histogramBanked, note, mag);
+           }));
+    report("canConstructFast", measure(opt, n, [&] { return lc383::ransom::canConstructFast(note, mag); }));
+    report("canConstructBytes（早停）", measure(opt, n, [&] { return lc383::ransom::canConstructBytes(note, mag); }));
+    report("canConstructUtf8（早停）", measure(opt, n, [&] { return lc383::ransom::canConstructUtf8(note, mag); }));
+    return ok;
+}
+
+// ================= 4. 88 merge =================
+
+bool benchMerge(const Options& opt) {
+    printf("\n=== 88 merge（共 %zu MB int，两半各自有序）===\n", opt.mb);
+    mt19937 rng(88);
+    bool ok = reportCheck("短数组交叉校验（Solution / InPlace / Fast / Parallel / std::merge）", lc88::selfCheck(rng));
+
+    const size_t total = (opt.mb << 20) / sizeof(int);
+    const size_t m = total / 2, n = total - m;
+    vector<int> a = lc88::sortedRandom(rng, m, 1 << 30);
+    vector<int> b = lc88::sortedRandom(rng, n, 1 << 30);
+    vector<int> expect(total), nums1(total), out(total);
+    merge(a.begin(), a.end(), b.begin(), b.end(), expect.begin());
+    // 原地版本每轮都要先把 nums1 恢复成“前 m 个有序 + 后 n 个空位”，这一步不计时
+    auto reset = [&] {
+        copy(a.begin(), a.end(), nums1.begin());
+        fill(nums1.begin() + m, nums1.end(), 0);
+    };
+    auto check = [&](const char* name, const vector<int>& got) {
+        if (got != expect) ok = reportCheck(name, false);
+    };
+
+    report("Solution::merge", measure(opt, total, reset, [&] {
+               lc88::Solution().merge(nums1, static_cast<int>(m), b, static_cast<int>(n));
+               return nums1[0];
+           }));
+    check("Solution::merge 结果", nums1);
+    report("std::merge（另开输出）", measure(opt, total, [&] {
+               merge(a.begin(), a.end(), b.begin(), b.end(), out.begin());
+               return out[0];
+           }));
+    check("std::merge 结果", out);
+    report("mergeInPlace", measure(opt, total, reset, [&] {
+               lc88::merging::mergeInPlace(nums1.data(), m, b.data(), n);
+               return nums1[0];
+           }));
+    check("mergeInPlace 结果", nums1);
+    report("mergeInPlaceFast", measure(opt, total, reset, [&] {
+               lc88::merging::mergeInPlaceFast(nums1.data(), m, b.data(), n);
+               return nums1[0];
+           }));
+    check("mergeInPlaceFast 结果", nums1);
+    char name[64];
+    snprintf(name, sizeof(name), "mergeParallel(%u)", opt.threads);
+    fill(out.begin(), out.end(), 0);
+    report(name, measure(opt, total, [&] {
+               lc88::merging::mergeParallel(a.data(), m, b.data(), n, out.data(), opt.threads);
+               return out[0];
+           }));
+    check("mergeParallel 结果", out);
+    if (ok) reportCheck("大输入结果一致", true);
+    return ok;
+}
+
+// ================= 5. 134 canCompleteCircuit =================
+
+bool benchGas(const Options& opt) {
+    // gas + cost 各一个 int，每站 8 字节
+    const size_t n = (opt.mb << 20) / (2 * sizeof(int));
+    printf("\n=== 134 canCompleteCircuit（%zu 个加油站）===\n", n);
+    mt19937 rng(134);
+    ws::WorkStealingPool pool(opt.threads);
+    bool ok = true;
+    for (int iter = 0; iter < 5000 && ok; ++iter) {
+        vector<int> g, c;
+        lc134::makeCircuit(rng, 1 + rng() % 40, rng() % 2, g, c);
+        int expect = lc134::bruteForceStart(g, c);
+        ok &= lc134::Solution().canCompleteCircuit(g, c) == expect;
+        ok &= lc134::gas::canCompleteCircuit(g.data(), c.data(), g.size()) == expect;
+        ok &= lc134::gas::canCompleteCircuitParallel(pool, g.data(), c.data(), g.size(), 1 + rng() % 8) == expect;
+    }
+    ok &= reportCheck("短环路交叉校验（暴力 / Solution / 单遍 / 并行）", ok);
+
+    vector<int> g, c;
+    lc134::makeCircuit(rng, n, true, g, c);
+    int expect = lc134::Solution().canCompleteCircuit(g, c);
+    ok &= reportCheck("大输入结果一致", expect == lc134::gas::canCompleteCircuit(g.data(), c.data(), n) &&
+                                         expect == lc134::gas::canCompleteCircuitParallel(pool, g.data(), c.data(), n));
+    report("Solution（日志已编译掉）", measure(opt, n, [&] { return lc134::Solution().canCompleteCircuit(g, c); }));
+    report("gas::canCompleteCircuit",
+           measure(opt, n, [&] { return lc134::gas::canCompleteCircuit(g.data(), c.data(), n); }));
+    char name[64];
+    snprintf(name, sizeof(name), "canCompleteCircuitParallel(%u)", opt.threads);
+    report(name, measure(opt, n, [&] {
+               return lc134::gas::canCompleteCircuitParallel(pool, g.data(), c.data(), n);
+           }));
+    return ok;
+}
+
+// ================= 主函数 =================
+
+int main(int argc, char** argv) {
+    Options opt;
+    string which = "all";
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "%s 缺少参数\n", arg.c_str());
+                exit(2);
+            }
+            return argv[++i];
+        };
+        if (arg == "--mb") opt.mb = max<size_t>(1, strtoull(next(), nullptr, 10));
+        else if (arg == "--reps") opt.reps = max(2, atoi(next()));
+        else if (arg == "--warmup") opt.warmup = max(0, atoi(next()));
+        else if (arg == "--threads") opt.threads = max(1, atoi(next()));
+        else which = arg;
+    }
+
+    printf("=== 📏 leetcode 基准：输入 %zu MB，预热 %d 次，重复 %d 次，%u 线程 ===\n", opt.mb, opt.warmup, opt.reps,
+           opt.threads);
+    bool ok = true;
+    bool any = false;
+    if (which == "all" || which == "palindrome") ok &= benchPalindrome(opt), any = true;
+    if (which == "all" || which == "ransom") ok &= benchRansom(opt), any = true;
+    if (which == "all" || which == "merge") ok &= benchMerge(opt), any = true;
+    if (which == "all" || which == "gas") ok &= benchGas(opt), any = true;
+    if (!any) {
+        fprintf(stderr, "未知题目: %s（可选 palindrome | ransom | merge | gas | all）\n", which.c_str());
+        return 2;
+    }
+    printf("\n%s\n", ok ? "✅ 所有实现结果一致" : "❌ 存在不一致的实现");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,667 @@
+#include<vector>
+#include<iostream>
+#include<algorithm>
+#include<queue>
+#include<memory>
+#include<string>
+#include<chrono>
+#include<random>
+#include<stdexcept>
+#include<limits>
+#include<type_traits>
+#include<cstring>
+#include<cstdlib>
+#include<cstdio>
+#include<cstdint>
+#include<cmath>
+#include<cerrno>
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include<immintrin.h>
+#endif
+#include "../../common/trace_ring.h"
+
+// 复用 leetcode_88 的两路归并（mergeBackward：尾部优先、无分支）
+#include "leetcode_88.h"
+using namespace std;
+
+// leetcode_88 的推广：把 k 条有序序列（run）归并成一条。
+//   - 输入：内存里的 span，或 mmap 进来的有序二进制文件（每个元素一个原生 int32）
+//   - 败者树（loser tree）：每输出一个元素只沿叶子到根比较 ⌈log2 k⌉ 次，每层只和“上次的败者”比一次；
+//     二叉堆弹出后下沉每层要比两次（左右孩子 + 自己）
+//   - 输出流式写进 sink：内存 sink 直接写数组，文件 sink 攒满 1MB 再一次 write(2)
+// k = 2 且输出是内存数组时直接调用 leetcode_88 的 mergeBackward；两两归并（对照组）每一轮也用它。
+// 两两归并要把全部数据过 ⌈log2 k⌉ 遍，败者树只过一遍。
+//
+// 编译运行：
+//   g++ -O3 -std=c++17 kway_merge.cpp -o kway_merge
+//   ./kway_merge                         # 小例子
+//   ./kway_merge bench [M 元素]          # 吞吐 vs k，对比两两归并与 priority_queue
+//   ./kway_merge filebench [M 元素] [k]  # 有序文件 mmap 输入 + 文件输出
+//   ./kway_merge files out.bin a.bin b.bin ...
+
+namespace kway {
+
+template <class T>
+struct Run {
+    const T* begin;
+    const T* end;
+    size_t size() const { return static_cast<size_t>(end - begin); }
+};
+
+// ================= 1. 文件描述符与只读 mmap 的有序文件 =================
+
+// 独占一个 fd，析构时关闭；写文件要检查 close 的返回值（延迟写回的错误可能在这里才报），用 close()
+class UniqueFd {
+public:
+    UniqueFd(const std::string& path, int flags, mode_t mode = 0644) : fd_(::open(path.c_str(), flags, mode)) {
+        if (fd_ < 0) throw std::runtime_error("打开失败: " + path + ": " + std::strerror(errno));
+    }
+    ~UniqueFd() {
+        if (fd_ >= 0) ::close(fd_);
+    }
+    UniqueFd(const UniqueFd&) = delete;
+    UniqueFd& operator=(const UniqueFd&) = delete;
+
+    int get() const { return fd_; }
+    void close() {
+        int fd = fd_;
+        fd_ = -1;
+        if (fd >= 0 && ::close(fd) != 0) throw std::runtime_error(std::string("close 失败: ") + std::strerror(errno));
+    }
+
+private:
+    int fd_;
+};
+
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        UniqueFd fd(path, O_RDONLY);
+        struct stat st;
+        if (::fstat(fd.get(), &st) != 0) throw std::runtime_error("fstat 失败: " + path);
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            // 映射建立后 fd 就可以关掉了
+            data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+            if (data_ == MAP_FAILED) throw std::runtime_error("mmap 失败: " + path);
+            // 顺序访问：让内核加大预读，读过的页也可以尽早回收
+            ::madvise(data_, size_, MADV_SEQUENTIAL);
+        }
+    }
+    ~MappedFile() {
+        if (data_) ::munmap(data_, size_);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 尾部不足一个元素的零头忽略
+    template <class T>
+    Run<T> run() const {
+        const T* p = static_cast<const T*>(data_);
+        return {p, p + size_ / sizeof(T)};
+    }
+
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// ================= 2. 输出 sink =================
+
+// 写进调用方准备好的数组
+template <class T>
+class ArraySink {
+public:
+    explicit ArraySink(T* out) : out_(out) {}
+    // 预留接下来 n 个输出位置，调用方直接写进去（给两路归并用）
+    T* reserve(size_t n) {
+        T* p = out_;
+        out_ += n;
+        return p;
+    }
+    void push(const T& v) { *out_++ = v; }
+    void append(const T* p, size_t n) {
+        std::memcpy(out_, p, n * sizeof(T));
+        out_ += n;
+    }
+    void flush() {}
+
+private:
+    T* out_;
+};
+
+// 写文件描述符（不持有 fd）：攒满一个大缓冲区才调用一次 write(2)。
+// 写错误由 flush() / close() 抛出；析构只是尽力写出剩余数据，不抛异常（可能正处在栈展开中），
+// 所以正常路径上要显式 close()
+template <class T>
+class FdSink {
+public:
+    explicit FdSink(int fd, size_t bufferBytes = 1 << 20)
+        : fd_(fd), buf_(std::max<size_t>(1, bufferBytes / sizeof(T))) {}
+    ~FdSink() noexcept {
+        if (closed_) return;
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    void close() {
+        closed_ = true;
+        flush();
+    }
+
+    void push(const T& v) {
+        if (used_ == buf_.size()) flush();
+        buf_[used_++] = v;
+    }
+    void append(const T* p, size_t n) {
+        while (n > 0) {
+            if (used_ == buf_.size()) flush();
+            size_t take = std::min(n, buf_.size() - used_);
+            std::memcpy(buf_.data() + used_, p, take * sizeof(T));
+            used_ += take;
+            p += take;
+            n -= take;
+        }
+    }
+    void flush() {
+        const char* p = reinterpret_cast<const char*>(buf_.data());
+        size_t left = used_ * sizeof(T);
+        while (left > 0) {
+            ssize_t w = ::write(fd_, p, left);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error(std::string("write 失败: ") + std::strerror(errno));
+            }
+            p += w;
+            left -= static_cast<size_t>(w);
+        }
+        written_ += used_;
+        used_ = 0;
+    }
+    size_t written() const { return written_ + used_; }
+
+private:
+    int fd_;
+    std::vector<T> buf_;
+    size_t used_ = 0;
+    size_t written_ = 0;
+    bool closed_ = false;
+};
+
+// ================= 3. 败者树 =================
+
+// 树节点 = (队头值 key, 名次 rank)，比较时先比 key、相等再比 rank。
+// rank 的最高位 kExhausted 表示 run 已耗尽：耗尽的节点输给任何未耗尽的节点，和它的 key 无关。
+// 不能靠“key 设成 T 的最大值”来表示耗尽：double 的 run 里可能有 +inf / NaN，它们不小于这个哨兵，会被丢掉或排错。
+// 通用版本存成结构体，先比耗尽位、再比 key、再比 rank；32 位以内的整数把两者打包进一个 uint64
+// （key 映射成无符号放高 32 位，rank 放低 32 位），一次整数比较就决出胜负，重赛循环里没有分支
+constexpr uint32_t kExhausted = 1u << 31;
+
+template <class T, class Enable = void>
+struct NodeCodec {
+    struct Node {
+        T key;
+        uint32_t rank;
+    };
+    static Node make(T key, uint32_t rank) { return {key, rank}; }
+    static T key(const Node& n) { return n.key; }
+    static uint32_t rank(const Node& n) { return n.rank; }
+    // 元素的顺序：浮点数里 NaN 排在最后（在 +inf 之后），各 run 也要按这个顺序有序
+    static bool keyLess(T a, T b) {
+        if constexpr (std::is_floating_point<T>::value) {
+            return !std::isnan(a) && (std::isnan(b) || a < b);
+        } else {
+            return a < b;
+        }
+    }
+    static bool less(const Node& a, const Node& b) {
+        if ((a.rank ^ b.rank) & kExhausted) return b.rank & kExhausted;
+        if (keyLess(a.key, b.key)) return true;
+        if (keyLess(b.key, a.key)) return false;
+        return a.rank < b.rank;
+    }
+};
+
+template <class T>
+struct NodeCodec<T, std::enable_if_t<std::is_integral<T>::value && sizeof(T) <= 4>> {
+    using Node = uint64_t;
+    // 有符号数翻转符号位后按无符号比较，顺序不变
+    static constexpr uint32_t kFlip = std::is_signed<T>::value ? (1u << (8 * sizeof(T) - 1)) : 0;
+    static Node make(T key, uint32_t rank) {
+        return uint64_t{static_cast<uint32_t>(static_cast<uint32_t>(key) ^ kFlip)} << 32 | rank;
+    }
+    static T key(Node n) { return static_cast<T>(static_cast<uint32_t>(n >> 32) ^ kFlip); }
+    static uint32_t rank(Node n) { return static_cast<uint32_t>(n); }
+    static bool keyLess(T a, T b) { return a < b; }
+    // 耗尽的节点 key 是 T 的最大值、rank 带最高位：和队头恰好也是最大值的 run 相比仍然更大
+    static bool less(Node a, Node b) { return a < b; }
+};
+
+// 叶子 i 对应 run i，内部节点 node_[1..k) 存“这场比赛的败者”，node_[0] 存总冠军。
+// 节点里直接存败者的队头值和名次，重赛时只读这一条路径上的节点，不用再去各个 run 里取值。
+// rank = run 编号；run 耗尽后 rank 置上 kExhausted 位，于是它输给任何未耗尽的 run
+// （包括队头是最大值、+inf 或 NaN 的）。相等时 rank 小的胜出，所以归并是稳定的
+template <class T>
+class LoserTree {
+    static_assert(std::is_arithmetic<T>::value, "LoserTree 需要算术类型作为元素");
+    using Codec = NodeCodec<T>;
+    using Node = typename Codec::Node;
+
+public:
+    explicit LoserTree(const std::vector<Run<T>>& runs)
+        : k_(static_cast<uint32_t>(runs.size())), cur_(k_), end_(k_), node_(std::max<uint32_t>(k_, 1)) {
+        if (runs.size() >= kExhausted) throw std::length_error("LoserTree: too many runs");
+        for (uint32_t i = 0; i < k_; ++i) {
+            cur_[i] = runs[i].begin;
+            end_[i] = runs[i].end;
+        }
+        if (k_ == 0) {
+            node_[0] = Codec::make(kDone, kExhausted);
+            return;
+        }
+        // 自底向上建树：winner[n] 是以 n 为根的子树的冠军，叶子 i 在位置 k + i
+        std::vector<Node> winner(2 * k_);
+        for (uint32_t i = 0; i < k_; ++i) winner[k_ + i] = head(i);
+        for (uint32_t n = k_ - 1; n > 0; --n) {
+            const Node& a = winner[2 * n];
+            const Node& b = winner[2 * n + 1];
+            bool aWins = Codec::less(a, b);
+            winner[n] = aWins ? a : b;
+            node_[n] = aWins ? b : a;
+        }
+        node_[0] = winner[k_ > 1 ? 1 : k_];
+    }
+
+    bool empty() const { return Codec::rank(node_[0]) & kExhausted; }
+
+    // 逐个弹出，直到所有 run 耗尽。
+    // 同一个 run 连续胜出 kStreak 次时，多半后面还有一段都比别人小（例如按时间切分的日志），
+    // 这时才花 log k 次比较找出亚军，把冠军 run 里不超过亚军的一整段直接 append。
+    // 随机交错的输入几乎触发不了这条路径，不增加逐元素的开销
+    template <class Sink>
+    void drainTo(Sink& sink) {
+        constexpr uint32_t kStreak = 4;
+        uint32_t last = kNoRun;
+        uint32_t streak = 0;
+        while (!empty()) {
+            uint32_t w = Codec::rank(node_[0]);
+            streak = w == last ? streak + 1 : 1;
+            if (streak >= kStreak) {
+                const T* p = cur_[w];
+                const T* e = end_[w];
+                const Node second = runnerUp(w);
+                const uint32_t secondRank = Codec::rank(second);
+                const T secondKey = Codec::key(second);
+                const T* q = p + 1;
+                if (secondRank & kExhausted) {
+                    q = e;
+                } else if (w < secondRank) {
+                    while (q < e && !Codec::keyLess(secondKey, *q)) ++q;
+                } else {
+                    while (q < e && Codec::keyLess(*q, secondKey)) ++q;
+                }
+                TRACE_EVENT("kway.block", w, q - p);
+                sink.append(p, static_cast<size_t>(q - p));
+                cur_[w] = q;
+            } else {
+                sink.push(*cur_[w]++);
+                // k 很大时硬件预取器跟不住这么多条流，手动预取冠军 run 后面一点
+                __builtin_prefetch(cur_[w] + 16);
+            }
+            last = w;
+            replay(w);
+        }
+        sink.flush();
+    }
+
+private:
+    static constexpr T kDone = std::numeric_limits<T>::max();
+    static constexpr uint32_t kNoRun = static_cast<uint32_t>(-1);
+
+    Node head(uint32_t i) const {
+        return cur_[i] != end_[i] ? Codec::make(*cur_[i], i) : Codec::make(kDone, kExhausted | i);
+    }
+
+    // run w 的队头变了：从它的叶子往上重赛，每层一次比较，交换用条件传送而不是分支
+    void replay(uint32_t w) {
+        Node cand = head(w);
+        for (uint32_t n = (w + k_) >> 1; n > 0; n >>= 1) {
+            Node o = node_[n];
+            bool swap = Codec::less(o, cand);
+            node_[n] = swap ? cand : o;
+            cand = swap ? o : cand;
+        }
+        node_[0] = cand;
+    }
+
+    // 冠军 w 一路上遇到的败者里最小的那个就是亚军
+    Node runnerUp(uint32_t w) const {
+        Node best = Codec::make(kDone, ~0u);
+        for (uint32_t n = (w + k_) >> 1; n > 0; n >>= 1) {
+            if (Codec::less(node_[n], best)) best = node_[n];
+        }
+        return best;
+    }
+
+    uint32_t k_;
+    std::vector<const T*> cur_;
+    std::vector<const T*> end_;
+    std::vector<Node> node_;
+};
+
+template <class Sink, class = void>
+struct HasReserve : std::false_type {};
+template <class Sink>
+struct HasReserve<Sink, std::void_t<decltype(std::declval<Sink&>().reserve(size_t{}))>> : std::true_type {};
+
+// 两条 int run：leetcode_88 的 mergeBackward，相等时 x 在前（与败者树的稳定性一致）
+template <class T>
+void mergeTwo(const Run<T>& x, const Run<T>& y, T* out) {
+    if constexpr (std::is_same<T, int>::value) {
+        lc88::merging::mergeBackward(out, x.begin, x.size(), y.begin, y.size());
+    } else {
+        std::merge(x.begin, x.end, y.begin, y.end, out);
+    }
+}
+
+template <class T, class Sink>
+void mergeRuns(const std::vector<Run<T>>& runs, Sink& sink) {
+    if constexpr (HasReserve<Sink>::value) {
+        if (runs.size() == 2) {
+            mergeTwo(runs[0], runs[1], sink.reserve(runs[0].size() + runs[1].size()));
+            sink.flush();
+            return;
+        }
+    }
+    LoserTree<T> tree(runs);
+    tree.drainTo(sink);
+}
+
+// ================= 4. 对照组 =================
+
+// 两两归并：每一轮把相邻两条 run 用 mergeTwo（leetcode_88 的两路归并）合成一条，直到只剩一条
+template <class T, class Sink>
+void mergeRunsPairwise(const std::vector<Run<T>>& runs, Sink& sink) {
+    size_t total = 0;
+    for (const auto& r : runs) total += r.size();
+    if (runs.size() <= 1) {
+        if (!runs.empty()) sink.append(runs[0].begin, runs[0].size());
+        sink.flush();
+        return;
+    }
+    std::vector<T> bufA(total), bufB(total);
+    std::vector<Run<T>> cur = runs;
+    std::vector<T>* dst = &bufA;
+    while (cur.size() > 1) {
+        std::vector<Run<T>> next;
+        T* out = dst->data();
+        for (size_t i = 0; i < cur.size(); i += 2) {
+            T* start = out;
+            if (i + 1 < cur.size()) {
+                mergeTwo(cur[i], cur[i + 1], out);
+                out += cur[i].size() + cur[i + 1].size();
+            } else {
+                out = std::copy(cur[i].begin, cur[i].end, out);
+            }
+            next.push_back({start, out});
+        }
+        cur.swap(next);
+        dst = dst == &bufA ? &bufB : &bufA;
+    }
+    sink.append(cur[0].begin, cur[0].size());
+    sink.flush();
+}
+
+// 二叉堆：std::priority_queue<(值, run 编号)>
+template <class T, class Sink>
+void mergeRunsHeap(const std::vector<Run<T>>& runs, Sink& sink) {
+    using Item = std::pair<T, size_t>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> heap;
+    std::vector<const T*> cur(runs.size());
+    for (size_t i = 0; i < runs.size(); ++i) {
+        cur[i] = runs[i].begin;
+        if (cur[i] != runs[i].end) heap.push({*cur[i]++, i});
+    }
+    while (!heap.empty()) {
+        auto [v, i] = heap.top();
+        heap.pop();
+        sink.push(v);
+        if (cur[i] != runs[i].end) heap.push({*cur[i]++, i});
+    }
+    sink.flush();
+}
+
+}  // namespace kway
+
+// ================= 基准：./kway_merge bench [M 元素] =================
+
+using Clock = std::chrono::steady_clock;
+
+// 总共 total 个元素随机分到 k 条 run 里，每条各自排序（值高度交错，最难的情形）
+static std::vector<std::vector<int32_t>> makeRuns(std::mt19937& rng, size_t total, size_t k) {
+    std::vector<std::vector<int32_t>> runs(k);
+    for (size_t i = 0; i < total; ++i) runs[rng() % k].push_back(static_cast<int32_t>(rng() >> 1));
+    for (auto& r : runs) std::sort(r.begin(), r.end());
+    return runs;
+}
+
+static std::vector<kway::Run<int32_t>> spansOf(const std::vector<std::vector<int32_t>>& runs) {
+    std::vector<kway::Run<int32_t>> spans;
+    for (const auto& r : runs) spans.push_back({r.data(), r.data() + r.size()});
+    return spans;
+}
+
+template <class F>
+static double bestSeconds(F&& f, int reps) {
+    double best = 1e100;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = Clock::now();
+        f();
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - t0).count());
+    }
+    return best;
+}
+
+static int runBenchmark(size_t millions) {
+    const size_t total = millions * 1000000;
+    std::mt19937 rng(36);
+    bool ok = true;
+
+    // 正确性：小数据、大量重复值、含空 run，结果必须与整体排序一致
+    for (int iter = 0; iter < 300 && ok; ++iter) {
+        size_t k = 1 + rng() % 40;
+        std::vector<std::vector<int32_t>> runs(k);
+        for (auto& r : runs) {
+            r.resize(rng() % 60);
+            for (auto& x : r) x = static_cast<int32_t>(rng() % 20);
+            std::sort(r.begin(), r.end());
+        }
+        std::vector<int32_t> expect;
+        for (auto& r : runs) expect.insert(expect.end(), r.begin(), r.end());
+        std::sort(expect.begin(), expect.end());
+        std::vector<int32_t> a(expect.size()), b(expect.size()), c(expect.size());
+        kway::ArraySink<int32_t> sa(a.data()), sb(b.data()), sc(c.data());
+        kway::mergeRuns(spansOf(runs), sa);
+        kway::mergeRunsPairwise(spansOf(runs), sb);
+        kway::mergeRunsHeap(spansOf(runs), sc);
+        // 非 32 位整数走通用的结构体节点
+        std::vector<std::vector<double>> druns;
+        for (auto& r : runs) druns.emplace_back(r.begin(), r.end());
+        std::vector<kway::Run<double>> dspans;
+        for (auto& r : druns) dspans.push_back({r.data(), r.data() + r.size()});
+        std::vector<double> d(expect.size());
+        kway::ArraySink<double> sd(d.data());
+        kway::mergeRuns(dspans, sd);
+        ok = a == expect && b == expect && c == expect && std::equal(d.begin(), d.end(), expect.begin());
+    }
+
+    // double 的 run 里有 ±inf 和 NaN（NaN 排在最后）：一个都不能丢，顺序与整体排序一致
+    auto nanLast = [](double a, double b) { return kway::NodeCodec<double>::keyLess(a, b); };
+    auto sameValue = [](double a, double b) { return a == b || (std::isnan(a) && std::isnan(b)); };
+    const double inf = std::numeric_limits<double>::infinity(), nan = std::numeric_limits<double>::quiet_NaN();
+    const double specials[] = {inf, -inf, nan, std::numeric_limits<double>::max()};
+    for (int iter = 0; iter < 300 && ok; ++iter) {
+        std::vector<std::vector<double>> druns;
+        if (iter == 0) {
+            druns = {{1, inf}, {2}, {3}, {-inf, 0, nan}, {nan, nan}};
+        } else {
+            druns.resize(1 + rng() % 12);
+            for (auto& r : druns) {
+                r.resize(rng() % 20);
+                for (auto& x : r) x = rng() % 4 == 0 ? specials[rng() % 4] : static_cast<double>(rng() % 10);
+                std::sort(r.begin(), r.end(), nanLast);
+            }
+        }
+        std::vector<double> expect;
+        for (auto& r : druns) expect.insert(expect.end(), r.begin(), r.end());
+        std::stable_sort(expect.begin(), expect.end(), nanLast);
+        std::vector<kway::Run<double>> dspans;
+        for (auto& r : druns) dspans.push_back({r.data(), r.data() + r.size()});
+        std::vector<double> d(expect.size() + 1, -1.0);  // 多一个哨兵位：多写、少写都能发现
+        kway::ArraySink<double> sd(d.data());
+        kway::LoserTree<double>(dspans).drainTo(sd);
+        ok = std::equal(expect.begin(), expect.end(), d.begin(), sameValue) && d.back() == -1.0;
+        if (!ok) {
+            std::printf("含 inf / NaN 的 double 归并出错（第 %d 组）:", iter);
+            for (size_t i = 0; i + 1 < d.size(); ++i) std::printf(" %g", d[i]);
+            std::printf("\n");
+        }
+    }
+    std::cout << (ok ? "正确性校验通过（含 ±inf / NaN 的 double run）" : "正确性校验失败") << std::endl;
+
+    std::printf("共 %zu M 个 int32，单位：M 元素/秒\n", millions);
+    std::printf("%6s %12s %12s %12s\n", "k", "败者树", "两两归并", "二叉堆");
+    std::vector<int32_t> out(total);
+    std::string slower;
+    for (size_t k : {2, 4, 16, 64, 256, 1024}) {
+        auto runs = makeRuns(rng, total, k);
+        auto spans = spansOf(runs);
+        auto time = [&](auto&& merge) {
+            double t = bestSeconds([&] {
+                kway::ArraySink<int32_t> sink(out.data());
+                merge(spans, sink);
+            }, 3);
+            ok &= std::is_sorted(out.begin(), out.end());
+            return total / t / 1e6;
+        };
+        double lt = time([](auto& s, auto& sink) { kway::mergeRuns(s, sink); });
+        double pw = time([](auto& s, auto& sink) { kway::mergeRunsPairwise(s, sink); });
+        double hp = time([](auto& s, auto& sink) { kway::mergeRunsHeap(s, sink); });
+        std::printf("%6zu %12.1f %12.1f %12.1f%s\n", k, lt, pw, hp, k == 2 ? "   （k=2 走 mergeBackward）" : "");
+        if (lt < pw) slower += " " + std::to_string(k);
+    }
+
+    // 不交错的 run（第 i 条的值都比第 i+1 条小）：drainTo 整段拷贝
+    {
+        const size_t k = 256;
+        std::vector<std::vector<int32_t>> runs(k);
+        for (size_t i = 0; i < total; ++i) runs[i * k / total].push_back(static_cast<int32_t>(i));
+        auto spans = spansOf(runs);
+        double t = bestSeconds([&] {
+            kway::ArraySink<int32_t> sink(out.data());
+            kway::mergeRuns(spans, sink);
+        }, 3);
+        ok &= std::is_sorted(out.begin(), out.end());
+        std::printf("k=%zu 且各 run 值域不重叠: 败者树 %.1f M 元素/秒\n", k, total / t / 1e6);
+    }
+    if (slower.empty()) {
+        std::printf("败者树在以上所有 k 上都不慢于两两归并\n");
+    } else {
+        std::printf("败者树慢于两两归并的 k:%s\n", slower.c_str());
+    }
+    std::printf("两两归并额外占用 %zu MB 临时内存、遍历数据 ⌈log2 k⌉ 遍；败者树只占 O(k)、只遍历一遍\n",
+                2 * total * sizeof(int32_t) >> 20);
+    std::cout << (ok ? "✅ 输出均有序" : "❌ 输出有误") << std::endl;
+    return ok ? 0 : 1;
+}
+
+// ================= 文件模式 =================
+
+static void writeFile(const std::string& path, const int32_t* p, size_t n) {
+    kway::UniqueFd fd(path, O_WRONLY | O_CREAT | O_TRUNC);
+    kway::FdSink<int32_t> sink(fd.get());
+    sink.append(p, n);
+    sink.close();
+    fd.close();
+}
+
+// 把 inputs 里的有序文件 mmap 进来归并到 outPath，返回输出元素数
+static size_t mergeFiles(const std::string& outPath, const std::vector<std::string>& inputs) {
+    std::vector<std::unique_ptr<kway::MappedFile>> files;
+    std::vector<kway::Run<int32_t>> runs;
+    for (const auto& path : inputs) {
+        files.push_back(std::make_unique<kway::MappedFile>(path));
+        runs.push_back(files.back()->run<int32_t>());
+    }
+    kway::UniqueFd fd(outPath, O_WRONLY | O_CREAT | O_TRUNC);
+    kway::FdSink<int32_t> sink(fd.get());
+    kway::mergeRuns(runs, sink);
+    sink.close();
+    fd.close();
+    return sink.written();
+}
+
+static int runFileBenchmark(size_t millions, size_t k) {
+    const size_t total = millions * 1000000;
+    std::mt19937 rng(360);
+    auto runs = makeRuns(rng, total, k);
+    std::vector<std::string> inputs;
+    for (size_t i = 0; i < k; ++i) {
+        inputs.push_back("/tmp/kway_run_" + std::to_string(i) + ".bin");
+        writeFile(inputs.back(), runs[i].data(), runs[i].size());
+    }
+    const std::string outPath = "/tmp/kway_out.bin";
+
+    auto t0 = Clock::now();
+    size_t n = mergeFiles(outPath, inputs);
+    double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    kway::MappedFile check(outPath);
+    auto r = check.run<int32_t>();
+    bool ok = n == total && r.size() == total && std::is_sorted(r.begin, r.end);
+    std::printf("%zu 个文件共 %zu MB → %s: %.1f ms, %.2f GB/s（读 + 写，含页缓存）\n", k,
+                total * sizeof(int32_t) >> 20, outPath.c_str(), sec * 1e3, total * sizeof(int32_t) * 2 / sec / 1e9);
+    std::cout << (ok ? "✅ 输出文件有序且长度正确" : "❌ 输出文件有误") << std::endl;
+
+    for (const auto& p : inputs) ::unlink(p.c_str());
+    ::unlink(outPath.c_str());
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    try {
+        if (argc >= 2 && std::strcmp(argv[1], "bench") == 0) {
+            size_t m = argc >= 3 ? std::strtoull(argv[2], nullptr, 10) : 16;
+            return runBenchmark(m ? m : 1);
+        }
+        if (argc >= 2 && std::strcmp(argv[1], "filebench") == 0) {
+            size_t m = argc >= 3 ? std::strtoull(argv[2], nullptr, 10) : 16;
+            size_t k = argc >= 4 ? std::strtoull(argv[3], nullptr, 10) : 256;
+            return runFileBenchmark(m ? m : 1, k ? k : 1);
+        }
+        if (argc >= 4 && std::strcmp(argv[1], "files") == 0) {
+            std::vector<std::string> inputs(argv + 3, argv + argc);
+            size_t n = mergeFiles(argv[2], inputs);
+            std::printf("已归并 %zu 个文件，共 %zu 个元素 → %s\n", inputs.size(), n, argv[2]);
+            return 0;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "❌ " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::vector<std::vector<int32_t>> runs = {{1, 4, 7}, {2, 5, 8}, {0, 3, 6, 9}};
+    std::vector<int32_t> out(10);
+    kway::ArraySink<int32_t> sink(out.data());
+    kway::mergeRuns(spansOf(runs), sink);
+    for (int32_t x : out) std::cout << x << " ";
+    std::cout << std::endl;
+    return 0;
+}
@@ -1,35 +1,209 @@
 #include<iostream>
 #include<string>
 #include<cctype>
+#include<cstring>
+#include<cstdint>
+#include<cstdlib>
+#include<cstdio>
+#include<algorithm>
+#include<chrono>
+#include<random>
+#include<vector>
+#include<deque>
+#include<thread>
+#include<mutex>
+#include<condition_variable>
+#include<atomic>
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/stat.h>
+#include<sys/resource.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include<immintrin.h>
+#endif
+#include "../../common/trace_ring.h"
+#include "leetcode_125.h"
 using namespace std;
+using namespace lc125;
 
-class Solution {
-    public:
-        bool isPalindrome(string s) {
-            std::string sgood;
-            for(auto& c : s) {
-                if(isalnum(c)) {
-                    sgood += tolower(c);
-                }
-            }
-            int n = sgood.size();
-            int left = 0;
-            int right = n - 1;
-            while( left <= right) {
-                if(sgood[left] != sgood[right]) {
-                    return false;
-                }
-                ++left;
-                --right;
+// ================= 基准：./leetcode_125 bench [MB] =================
+
+template <class F>
+static double bestSeconds(F&& f, int reps) {
+    double best = 1e100;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+    }
+    return best;
+}
+
+static int runBenchmark(size_t mb) {
+    std::string s = makeNoisyPalindrome(mb << 20, 125);
+    std::string bad = s;
+    bad[bad.size() / 3] = bad[bad.size() / 3] == 'x' ? 'y' : 'x';  // 大概率破坏回文
+
+    Solution solution;
+    bool ok = true;
+    for (const std::string* str : {&s, &bad}) {
+        bool ref = solution.isPalindrome(*str);
+        ok &= palindrome::isPalindromeTwoPointer(str->data(), str->size()) == ref;
+        ok &= palindrome::isPalindromeFast(*str) == ref;
+    }
+    // 小规模随机串交叉校验（覆盖收尾逻辑）
+    std::mt19937 rng(7);
+    for (int iter = 0; iter < 20000 && ok; ++iter) {
+        std::string t = makeNoisyPalindrome(rng() % 300, rng());
+        if (rng() % 2 && !t.empty()) t[rng() % t.size()] = static_cast<char>('a' + rng() % 26);
+        ok &= palindrome::isPalindromeFast(t) == solution.isPalindrome(t);
+    }
+    std::cout << (ok ? "正确性校验通过" : "正确性校验失败") << std::endl;
+
+    const double gb = s.size() / 1e9;
+    volatile bool sink = false;
+    double tBase = bestSeconds([&] { sink = solution.isPalindrome(s); }, 3);
+    double tTwo = bestSeconds([&] { sink = palindrome::isPalindromeTwoPointer(s.data(), s.size()); }, 5);
+    double tFast = bestSeconds([&] { sink = palindrome::isPalindromeFast(s); }, 5);
+    (void)sink;
+
+    std::printf("输入 %zu MB\n", mb);
+    std::printf("isPalindrome（提交版）   : %8.2f ms  %6.2f GB/s\n", tBase * 1e3, gb / tBase);
+    std::printf("isPalindromeTwoPointer   : %8.2f ms  %6.2f GB/s\n", tTwo * 1e3, gb / tTwo);
+    std::printf("isPalindromeFast(AVX2)   : %8.2f ms  %6.2f GB/s\n", tFast * 1e3, gb / tFast);
+    return ok ? 0 : 1;
+}
+
+// ================= 文件模式基准：./leetcode_125 filebench [MB] [path] =================
+
+// 流式生成一个“带噪声的回文”文件：前半段分块随机生成，后半段分块倒着读前半段做镜像
+static bool writeNoisyPalindromeFile(const char* path, uint64_t bytes) {
+    int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    const size_t chunk = 4u << 20;
+    const uint64_t half = bytes / 2;
+    const char noise[] = " ,.:;!?-_'\"\t";
+    std::mt19937 rng(383);
+    std::vector<char> buf(chunk);
+    for (uint64_t off = 0; off < half; off += chunk) {
+        size_t len = static_cast<size_t>(std::min<uint64_t>(chunk, half - off));
+        for (size_t i = 0; i < len; ++i) {
+            uint32_t r = rng();
+            if (r % 4 == 0) buf[i] = noise[r % (sizeof(noise) - 1)];
+            else if (r % 4 == 1) buf[i] = static_cast<char>('0' + r % 10);
+            else buf[i] = static_cast<char>('a' + r % 26);
+        }
+        if (::pwrite(fd, buf.data(), len, static_cast<off_t>(off)) != static_cast<ssize_t>(len)) return false;
+    }
+    std::vector<char> mirror(chunk);
+    for (uint64_t end = half, out = half; end > 0;) {
+        size_t len = static_cast<size_t>(std::min<uint64_t>(chunk, end));
+        if (::pread(fd, buf.data(), len, static_cast<off_t>(end - len)) != static_cast<ssize_t>(len)) return false;
+        for (size_t i = 0; i < len; ++i) {
+            char c = buf[len - 1 - i];
+            uint32_t r = rng();
+            if (std::isalpha(static_cast<unsigned char>(c)) && (r & 1)) c = static_cast<char>(std::toupper(c));
+            else if (!std::isalnum(static_cast<unsigned char>(c))) c = noise[r % (sizeof(noise) - 1)];
+            mirror[i] = c;
+        }
+        if (::pwrite(fd, mirror.data(), len, static_cast<off_t>(out)) != static_cast<ssize_t>(len)) return false;
+        end -= len;
+        out += len;
+    }
+    // 落盘后把页缓存丢掉，下面测到的是冷读吞吐
+    ::fdatasync(fd);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+    return true;
+}
+
+static long peakRssKb() {
+    struct rusage ru;
+    ::getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss;  // Linux 上单位是 KB
+}
+
+static bool fileModeSelfCheck() {
+    const char* path = "/tmp/leetcode_125_selfcheck.txt";
+    Solution solution;
+    std::mt19937 rng(32);
+    bool ok = true;
+    for (int iter = 0; iter < 400 && ok; ++iter) {
+        std::string t = makeNoisyPalindrome(rng() % 5000, rng());
+        if (rng() % 2 && !t.empty()) t[rng() % t.size()] = static_cast<char>('a' + rng() % 26);
+        FILE* f = std::fopen(path, "wb");
+        std::fwrite(t.data(), 1, t.size(), f);
+        std::fclose(f);
+        bool ref = solution.isPalindrome(t);
+        for (size_t chunk : {1, 7, 64, 1000}) {
+            for (bool ra : {false, true}) {
+                palindrome::FileCheckOptions opt;
+                opt.chunkBytes = chunk;
+                opt.readAhead = ra;
+                auto r = palindrome::isPalindromeFile(path, opt);
+                ok &= r.ok && r.palindrome == ref;
             }
-            return true;
         }
-    };
+    }
+    std::remove(path);
+    return ok;
+}
 
-int main() {
+static int runFileBenchmark(size_t mb, const char* path) {
+    std::cout << (fileModeSelfCheck() ? "文件模式正确性校验通过" : "文件模式正确性校验失败") << std::endl;
+    long rssBefore = peakRssKb();
+    if (!writeNoisyPalindromeFile(path, static_cast<uint64_t>(mb) << 20)) {
+        std::fprintf(stderr, "写入 %s 失败\n", path);
+        return 1;
+    }
+
+    bool ok = true;
+    for (bool ra : {false, true}) {
+        // 每轮前丢掉页缓存，两种模式都从磁盘冷读
+        int fd = ::open(path, O_RDONLY);
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+
+        palindrome::FileCheckOptions opt;
+        opt.readAhead = ra;
+        auto t0 = std::chrono::steady_clock::now();
+        auto r = palindrome::isPalindromeFile(path, opt);
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        ok &= r.ok && r.palindrome;
+        std::printf("%-12s: %zu MB, %8.2f ms, %6.2f GB/s, 结果=%d, 峰值 RSS=%ld KB\n",
+                    ra ? "双端预读" : "同步 pread", mb, sec * 1e3, r.bytes / sec / 1e9, r.palindrome,
+                    peakRssKb());
+    }
+    std::printf("生成文件前峰值 RSS=%ld KB（块大小 4MB，RSS 不随文件大小增长）\n", rssBefore);
+    std::remove(path);
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && std::strcmp(argv[1], "bench") == 0) {
+        size_t mb = argc >= 3 ? std::strtoull(argv[2], nullptr, 10) : 64;
+        return runBenchmark(mb ? mb : 1);
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "filebench") == 0) {
+        size_t mb = argc >= 3 ? std::strtoull(argv[2], nullptr, 10) : 1024;
+        const char* path = argc >= 4 ? argv[3] : "/tmp/leetcode_125_palindrome.txt";
+        return runFileBenchmark(mb ? mb : 1, path);
+    }
+    if (argc >= 3 && std::strcmp(argv[1], "file") == 0) {
+        palindrome::FileCheckOptions opt;
+        opt.readAhead = argc >= 4 && std::strcmp(argv[3], "--readahead") == 0;
+        auto r = palindrome::isPalindromeFile(argv[2], opt);
+        if (!r.ok) {
+            std::fprintf(stderr, "无法读取 %s\n", argv[2]);
+            return 1;
+        }
+        std::cout << r.palindrome << std::endl;
+        return 0;
+    }
     Solution solution;
     std::string s = "A man, a plan, a canal: Panama";
     bool result = solution.isPalindrome(s);
     std::cout << result << std::endl;
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,501 @@
+#pragma once
+
+// LeetCode 125（验证回文串）的各个解法，leetcode_125.cpp 和 bench_leetcode.cpp 共用：
+//   lc125::Solution                        提交版
+//   lc125::palindrome::isPalindrome*       零分配双指针 / AVX2 / 比内存还大的文件
+//   lc125::makeNoisyPalindrome             带标点、大小写混杂的回文输入
+
+#include<iostream>
+#include<string>
+#include<cctype>
+#include<cstring>
+#include<cstdint>
+#include<cstdlib>
+#include<cstdio>
+#include<algorithm>
+#include<chrono>
+#include<random>
+#include<vector>
+#include<deque>
+#include<thread>
+#include<mutex>
+#include<condition_variable>
+#include<atomic>
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/stat.h>
+#include<sys/resource.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include<immintrin.h>
+#endif
+#include "../../common/trace_ring.h"
+
+namespace lc125 {
+
+class Solution {
+    public:
+        bool isPalindrome(std::string s) {
+            std::string sgood;
+            for(auto& c : s) {
+                if(isalnum(c)) {
+                    sgood += tolower(c);
+                }
+            }
+            int n = sgood.size();
+            int left = 0;
+            int right = n - 1;
+            while( left <= right) {
+                if(sgood[left] != sgood[right]) {
+                    return false;
+                }
+                ++left;
+                --right;
+            }
+            return true;
+        }
+    };
+
+// ================= 大输入版本（零分配） =================
+// 上面的 isPalindrome 是提交版：按值传参拷一次、sgood 逐字节 += 又可能多次扩容，且每个字节都有分支。
+// 下面两个版本都不分配堆内存，只读原串：
+//   1) isPalindromeTwoPointer：双指针 + 256 项查表（替代 isalnum/tolower 的函数调用）
+//   2) isPalindromeAvx2：两端各取 32 字节，向量化判断字母数字并转小写，
+//      用 pshufb 查表把字母数字“压紧”到栈上的小缓冲区，再两端对比
+// 过滤规则与提交版一致（C locale）：只保留 [0-9A-Za-z]，字母转小写；>=0x80 的字节一律丢弃。
+
+namespace palindrome {
+
+// 字节 -> 规范化字符；0 表示丢弃
+struct NormTable {
+    unsigned char v[256];
+    constexpr NormTable() : v() {
+        for (int c = 0; c < 256; ++c) {
+            if (c >= '0' && c <= '9') v[c] = static_cast<unsigned char>(c);
+            else if (c >= 'a' && c <= 'z') v[c] = static_cast<unsigned char>(c);
+            else if (c >= 'A' && c <= 'Z') v[c] = static_cast<unsigned char>(c + ('a' - 'A'));
+            else v[c] = 0;
+        }
+    }
+};
+inline constexpr NormTable kNorm{};
+
+inline bool isPalindromeTwoPointer(const char* s, size_t n) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(s);
+    size_t i = 0, j = n;
+    while (true) {
+        while (i < j && kNorm.v[p[i]] == 0) ++i;
+        while (i < j && kNorm.v[p[j - 1]] == 0) --j;
+        if (j - i <= 1) return true;
+        if (kNorm.v[p[i]] != kNorm.v[p[j - 1]]) {
+            TRACE_EVENT("palindrome.mismatch", i, j - 1);
+            return false;
+        }
+        ++i;
+        --j;
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// 8 位掩码 -> pshufb 索引：把掩码为 1 的字节依次挪到低位
+struct CompactTable {
+    alignas(16) uint8_t idx[256][8];
+    constexpr CompactTable() : idx() {
+        for (int m = 0; m < 256; ++m) {
+            int k = 0;
+            for (int b = 0; b < 8; ++b) {
+                if (m & (1 << b)) idx[m][k++] = static_cast<uint8_t>(b);
+            }
+            for (; k < 8; ++k) idx[m][k] = 0x80;  // 0x80：pshufb 输出 0
+        }
+    }
+};
+inline constexpr CompactTable kCompact{};
+
+// 对 32 字节做：判定字母数字 -> 转小写 -> 压紧写到 out，返回写入个数（out 需要额外 8 字节余量）
+__attribute__((target("avx2"))) inline size_t compact32(__m256i v, uint8_t* out) {
+    // 有符号比较：>=0x80 的字节是负数，自然落在所有区间外
+    const __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));  // 'A'..'Z' -> 'a'..'z'
+    __m256i isDigit = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)),
+                                       _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+    __m256i isAlpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                       _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+    __m256i norm = _mm256_blendv_epi8(v, lower, isAlpha);
+    uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(isDigit, isAlpha)));
+
+    alignas(32) uint8_t bytes[32];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(bytes), norm);
+    size_t written = 0;
+    for (int g = 0; g < 4; ++g) {
+        uint32_t m = (mask >> (8 * g)) & 0xFF;
+        __m128i src = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(bytes + 8 * g));
+        __m128i shuf = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(kCompact.idx[m]));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + written), _mm_shuffle_epi8(src, shuf));
+        written += __builtin_popcount(m);
+    }
+    return written;
+}
+
+__attribute__((target("avx2"))) inline __m256i reverse32(__m256i v) {
+    const __m256i rev = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                         15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    v = _mm256_shuffle_epi8(v, rev);                // 128 位通道内逆序
+    return _mm256_permute2x128_si256(v, v, 0x01);  // 交换两个通道
+}
+
+__attribute__((target("avx2"))) inline bool isPalindromeAvx2(const char* s, size_t n) {
+    // 左缓冲区：正序存放左侧已过滤字符；右缓冲区：逆序存放右侧已过滤字符（rbuf[0] 是串尾那个）
+    // 每轮对比后剩余部分不超过 32 字节，所以 64 + 8 余量足够
+    alignas(32) uint8_t lbuf[72];
+    alignas(32) uint8_t rbuf[72];
+    size_t llen = 0, rlen = 0;
+    size_t lo = 0, hi = n;  // 原串中尚未读入的区间 [lo, hi)
+
+    while (hi - lo >= 32) {
+        // 哪边缓冲少就读哪边，保持两边进度接近
+        if (llen <= rlen) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + lo));
+            llen += compact32(v, lbuf + llen);
+            lo += 32;
+        } else {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + hi - 32));
+            rlen += compact32(reverse32(v), rbuf + rlen);
+            hi -= 32;
+        }
+        size_t k = llen < rlen ? llen : rlen;
+        if (k) {
+            if (memcmp(lbuf, rbuf, k) != 0) return false;
+            memmove(lbuf, lbuf + k, llen - k);
+            memmove(rbuf, rbuf + k, rlen - k);
+            llen -= k;
+            rlen -= k;
+        }
+    }
+
+    // 收尾：剩余序列 = lbuf + filter(中间未读部分) + reverse(rbuf)，长度 < 32 + 32 + 32
+    uint8_t tail[128];
+    size_t t = 0;
+    memcpy(tail, lbuf, llen);
+    t += llen;
+    for (size_t i = lo; i < hi; ++i) {
+        unsigned char c = kNorm.v[static_cast<unsigned char>(s[i])];
+        if (c) tail[t++] = c;
+    }
+    for (size_t i = rlen; i > 0; --i) tail[t++] = rbuf[i - 1];
+    for (size_t i = 0, j = t; i + 1 < j; ++i, --j) {
+        if (tail[i] != tail[j - 1]) return false;
+    }
+    return true;
+}
+
+#endif
+
+// 运行时选择：CPU 支持 AVX2 走向量版本，否则走查表双指针
+inline bool isPalindromeFast(const char* s, size_t n) {
+#if defined(__x86_64__) || defined(__i386__)
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2) return isPalindromeAvx2(s, n);
+#endif
+    return isPalindromeTwoPointer(s, n);
+}
+
+inline bool isPalindromeFast(const std::string& s) { return isPalindromeFast(s.data(), s.size()); }
+
+}  // namespace palindrome
+
+// ================= 文件模式：比内存还大的输入 =================
+// isPalindrome(std::string s) 需要整串在内存里（按值传参甚至还要再拷一份）。
+// isPalindromeFile 直接对文件做“两端向中间”的分块校验，内存占用与文件大小无关：
+//   - 左、右两个读端用 pread 各自从文件头/文件尾按块（默认 4MB）读取，原始区间 [lo, hi) 由两端共享、
+//     每次领取一块后收缩，两端读到的数据不会重叠
+//   - 每块按同样的规则过滤（字母数字 + 转小写）：左块正序、右块逆序追加到各自缓冲区
+//   - 两个缓冲区从头比较公共长度部分，比完就丢掉；哪边缓冲少就先读哪边
+//   - 某一端再也领不到块时，另一端剩下的（有界的）过滤结果自身必须是回文
+//   - 可选预读：每端一个后台线程提前读 kReadAheadDepth 块，主线程只做过滤后的比较
+// 选 pread 而不是 mmap：mmap 的页会计入进程 RSS，读完整个文件后 RSS 接近文件大小，
+// pread 进自有缓冲区则 RSS 恒定，也更容易控制预读深度。
+
+namespace palindrome {
+
+#if defined(__x86_64__) || defined(__i386__)
+// 向量部分：只处理 32 字节整块，返回写入个数；零头交给标量循环
+__attribute__((target("avx2"))) inline size_t filterBlocksForwardAvx2(const char* raw, size_t n, uint8_t* out) {
+    size_t w = 0;
+    for (size_t i = 0; i + 32 <= n; i += 32) {
+        w += compact32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(raw + i)), out + w);
+    }
+    return w;
+}
+
+// 从末尾往前处理整块，剩下开头 n % 32 字节
+__attribute__((target("avx2"))) inline size_t filterBlocksBackwardAvx2(const char* raw, size_t n, uint8_t* out) {
+    size_t w = 0;
+    for (size_t end = n; end >= 32 && end - 32 >= n % 32; end -= 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(raw + end - 32));
+        w += compact32(reverse32(v), out + w);
+    }
+    return w;
+}
+#endif
+
+// 过滤 raw[0, n) 追加到 out，正序
+inline void filterForward(const char* raw, size_t n, std::vector<uint8_t>& out) {
+    size_t base = out.size();
+    out.resize(base + n + 8);  // +8：compact32 的写余量
+    size_t w = base;
+    size_t i = 0;
+#if defined(__x86_64__) || defined(__i386__)
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2) {
+        w += filterBlocksForwardAvx2(raw, n, out.data() + w);
+        i = n - n % 32;
+    }
+#endif
+    for (; i < n; ++i) {
+        unsigned char c = kNorm.v[static_cast<unsigned char>(raw[i])];
+        if (c) out[w++] = c;
+    }
+    out.resize(w);
+}
+
+// 过滤 raw[0, n) 追加到 out，逆序（从 raw 末尾往前）
+inline void filterBackward(const char* raw, size_t n, std::vector<uint8_t>& out) {
+    size_t base = out.size();
+    out.resize(base + n + 8);
+    size_t w = base;
+    size_t end = n;
+#if defined(__x86_64__) || defined(__i386__)
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2) {
+        w += filterBlocksBackwardAvx2(raw, n, out.data() + w);
+        end = n % 32;
+    }
+#endif
+    for (; end > 0; --end) {
+        unsigned char c = kNorm.v[static_cast<unsigned char>(raw[end - 1])];
+        if (c) out[w++] = c;
+    }
+    out.resize(w);
+}
+
+struct FileCheckOptions {
+    size_t chunkBytes = 4u << 20;
+    bool readAhead = false;
+};
+
+struct FileCheckResult {
+    bool ok = false;           // 文件能否打开/读取成功
+    bool palindrome = false;
+    uint64_t bytes = 0;
+};
+
+class FilePalindromeChecker {
+public:
+    static constexpr size_t kReadAheadDepth = 2;
+
+    FilePalindromeChecker(int fd, uint64_t size, const FileCheckOptions& opt)
+        : fd_(fd), opt_(opt), lo_(0), hi_(size) {}
+
+    FileCheckResult run() {
+        FileCheckResult res;
+        Side left{true}, right{false};
+        if (opt_.readAhead) {
+            left.worker = std::thread([&] { produce(left); });
+            right.worker = std::thread([&] { produce(right); });
+        }
+
+        bool same = compareStreams(left, right);
+
+        if (opt_.readAhead) {
+            // 提前结束（发现不匹配）时让后台线程尽快退出。
+            // 在各端的锁内置位：否则生产者可能刚检查完谓词、还没睡下，通知就丢了，join 会卡住
+            for (Side* s : {&left, &right}) {
+                std::lock_guard<std::mutex> lk(s->m);
+                stop_.store(true);
+                s->cv.notify_all();
+            }
+            left.worker.join();
+            right.worker.join();
+        }
+        res.ok = !ioError_.load();
+        res.palindrome = res.ok && same;
+        return res;
+    }
+
+private:
+    struct Chunk {
+        std::vector<uint8_t> filtered;
+    };
+
+    struct Side {
+        explicit Side(bool l) : isLeft(l) {}
+        bool isLeft;
+        // 已过滤、尚未比较的字符：[head, buf.size())
+        std::vector<uint8_t> buf;
+        size_t head = 0;
+        // 预读模式下的队列
+        std::thread worker;
+        std::mutex m;
+        std::condition_variable cv;
+        std::deque<Chunk> queue;
+        bool finished = false;
+        size_t avail() const { return buf.size() - head; }
+    };
+
+    // 从共享原始区间领取下一块：左端取 [lo, lo+len)，右端取 [hi-len, hi)
+    bool claim(bool isLeft, uint64_t& off, size_t& len) {
+        std::lock_guard<std::mutex> lk(rangeMutex_);
+        if (lo_ >= hi_) return false;
+        len = static_cast<size_t>(std::min<uint64_t>(opt_.chunkBytes, hi_ - lo_));
+        if (isLeft) {
+            off = lo_;
+            lo_ += len;
+        } else {
+            off = hi_ - len;
+            hi_ -= len;
+        }
+        return true;
+    }
+
+    bool readChunk(bool isLeft, std::vector<char>& raw, Chunk& out) {
+        uint64_t off;
+        size_t len;
+        if (!claim(isLeft, off, len)) return false;
+        raw.resize(len);
+        size_t got = 0;
+        while (got < len) {
+            ssize_t r = ::pread(fd_, raw.data() + got, len - got, static_cast<off_t>(off + got));
+            if (r <= 0) {
+                ioError_.store(true);
+                return false;
+            }
+            got += static_cast<size_t>(r);
+        }
+        out.filtered.clear();
+        if (isLeft) filterForward(raw.data(), len, out.filtered);
+        else filterBackward(raw.data(), len, out.filtered);
+        return true;
+    }
+
+    // 预读线程：队列未满就继续读
+    void produce(Side& s) {
+        std::vector<char> raw;
+        while (!stop_.load()) {
+            Chunk c;
+            if (!readChunk(s.isLeft, raw, c)) break;
+            std::unique_lock<std::mutex> lk(s.m);
+            s.cv.wait(lk, [&] { return stop_.load() || s.queue.size() < kReadAheadDepth; });
+            s.queue.push_back(std::move(c));
+            s.cv.notify_all();
+        }
+        std::lock_guard<std::mutex> lk(s.m);
+        s.finished = true;
+        s.cv.notify_all();
+    }
+
+    // 取下一块追加到该端缓冲区；没有更多数据时返回 false
+    bool pull(Side& s) {
+        Chunk c;
+        if (opt_.readAhead) {
+            std::unique_lock<std::mutex> lk(s.m);
+            s.cv.wait(lk, [&] { return !s.queue.empty() || s.finished; });
+            if (s.queue.empty()) return false;
+            c = std::move(s.queue.front());
+            s.queue.pop_front();
+            s.cv.notify_all();
+        } else {
+            if (!readChunk(s.isLeft, syncRaw_, c)) return false;
+        }
+        // 已比较部分超过一半时整体前移，缓冲区容量保持在两三块以内
+        if (s.head > s.buf.size() / 2) {
+            s.buf.erase(s.buf.begin(), s.buf.begin() + static_cast<std::ptrdiff_t>(s.head));
+            s.head = 0;
+        }
+        s.buf.insert(s.buf.end(), c.filtered.begin(), c.filtered.end());
+        return true;
+    }
+
+    static bool matchCommon(Side& l, Side& r) {
+        size_t k = std::min(l.avail(), r.avail());
+        if (k && std::memcmp(l.buf.data() + l.head, r.buf.data() + r.head, k) != 0) return false;
+        l.head += k;
+        r.head += k;
+        return true;
+    }
+
+    bool compareStreams(Side& left, Side& right) {
+        while (true) {
+            Side& need = left.avail() <= right.avail() ? left : right;
+            Side& other = &need == &left ? right : left;
+            if (!pull(need)) {
+                // need 端没有更多数据：原始区间已分完，other 端只剩已领取（有界）的块
+                while (pull(other)) {
+                    if (!matchCommon(left, right)) return false;
+                }
+                if (!matchCommon(left, right)) return false;
+                // 剩余部分位于整个过滤序列的正中间，自身必须是回文（逆序存放不影响判断）
+                Side& rest = left.avail() ? left : right;
+                const uint8_t* p = rest.buf.data() + rest.head;
+                size_t n = rest.avail();
+                for (size_t i = 0; i < n / 2; ++i) {
+                    if (p[i] != p[n - 1 - i]) return false;
+                }
+                return true;
+            }
+            if (!matchCommon(left, right)) return false;
+        }
+    }
+
+    int fd_;
+    FileCheckOptions opt_;
+    std::mutex rangeMutex_;
+    uint64_t lo_, hi_;
+    std::vector<char> syncRaw_;
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> ioError_{false};
+};
+
+inline FileCheckResult isPalindromeFile(const char* path, const FileCheckOptions& opt = {}) {
+    FileCheckResult res;
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return res;
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return res;
+    }
+    FilePalindromeChecker checker(fd, static_cast<uint64_t>(st.st_size), opt);
+    res = checker.run();
+    res.bytes = static_cast<uint64_t>(st.st_size);
+    ::close(fd);
+    return res;
+}
+
+}  // namespace palindrome
+
+// ================= 测试输入 =================
+
+inline std::string makeNoisyPalindrome(size_t bytes, unsigned seed) {
+    std::mt19937 rng(seed);
+    const char noise[] = " ,.:;!?-_'\"\t";
+    std::string half;
+    half.reserve(bytes / 2);
+    while (half.size() < bytes / 2) {
+        uint32_t r = rng();
+        if (r % 4 == 0) half += noise[r % (sizeof(noise) - 1)];
+        else if (r % 4 == 1) half += static_cast<char>('0' + r % 10);
+        else half += static_cast<char>('a' + r % 26);
+    }
+    std::string s = half;
+    // 后半段是前半段的镜像，字母随机翻成大写、标点随机替换，过滤后仍是回文
+    for (size_t i = half.size(); i > 0; --i) {
+        char c = half[i - 1];
+        uint32_t r = rng();
+        if (std::isalpha(static_cast<unsigned char>(c)) && (r & 1)) c = static_cast<char>(std::toupper(c));
+        else if (!std::isalnum(static_cast<unsigned char>(c))) c = noise[r % (sizeof(noise) - 1)];
+        s += c;
+    }
+    return s;
+}
+
+}  // namespace lc125
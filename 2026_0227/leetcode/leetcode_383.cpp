@@ -1,31 +1,212 @@
 #include<iostream>
 #include<vector>
+#include<string>
+#include<string_view>
+#include<unordered_map>
+#include<cstring>
+#include<cstdint>
+#include<cstdlib>
+#include<cstdio>
+#include<algorithm>
+#include<chrono>
+#include<random>
+#if defined(__x86_64__) || defined(__i386__)
+#include<immintrin.h>
+#endif
+#include "../../common/trace_ring.h"
+#include "leetcode_383.h"
 using namespace std;
-class Solution {
-    public:
-        bool canConstruct(string ransomNote, string magazine) {
-            if (ransomNote.size() > magazine.size()) {
-                return false;
-            }
-            std::vector<int> cnt(26);
-            for(auto& c : magazine) {
-                cnt[c - 'a']++;
-            }
-            for(auto& c: ransomNote) {
-                cnt[c - 'a']--;
-                if (cnt[c - 'a'] < 0) {
-                    return false;
-                }
-            }
-            return true;
-        }
+using namespace lc383;
+
+// ================= 基准：./leetcode_383 bench [pairs] [magazineLen] =================
+
+template <class F>
+static double bestSeconds(F&& f, int reps) {
+    double best = 1e100;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+    }
+    return best;
+}
+
+static int runBenchmark(size_t pairCount, size_t magazineLen, int alphabet) {
+    std::mt19937 rng(383);
+    std::vector<std::string> notes, mags;
+    for (size_t i = 0; i < pairCount; ++i) {
+        mags.push_back(randomLetters(rng, magazineLen, alphabet));
+        notes.push_back(randomLetters(rng, magazineLen / 8 + rng() % 4, alphabet));
+    }
+    std::vector<std::pair<string_view, string_view>> pairs;
+    for (size_t i = 0; i < pairCount; ++i) pairs.emplace_back(notes[i], mags[i]);
+
+    Solution solution;
+    bool ok = true;
+    for (size_t i = 0; i < pairCount && i < 2000; ++i) {
+        bool ref = solution.canConstruct(notes[i], mags[i]);
+        ok &= ransom::canConstructWith(ransom::histogramScalar, notes[i], mags[i]) == ref;
+        ok &= ransom::canConstructWith(ransom::histogramBanked, notes[i], mags[i]) == ref;
+        ok &= ransom::canConstructFast(notes[i], mags[i]) == ref;
+    }
+    for (int iter = 0; iter < 2000 && ok; ++iter) {
+        // 小字母表 + 随机长度，覆盖 true/false 两种结果和各种零头长度
+        std::string m = randomLetters(rng, rng() % 3000, 3);
+        std::string n = randomLetters(rng, rng() % 1200, 3);
+        ok &= ransom::canConstructFast(n, m) == solution.canConstruct(n, m);
+        // 全字母表：自动选择的内核（含 AVX2 的 7+7+7+5 分组）与单表逐项一致
+        std::string full = randomLetters(rng, rng() % 3000, 26);
+        ransom::Hist want = {}, got = {};
+        ransom::histogramScalar(full.data(), full.size(), want);
+        ransom::histogram(full.data(), full.size(), got);
+        ok &= std::equal(want, want + 32, got);
+    }
+    std::cout << (ok ? "正确性校验通过" : "正确性校验失败") << std::endl;
+
+    const double bytes = static_cast<double>(pairCount) * (magazineLen + magazineLen / 8);
+    std::vector<uint8_t> out;
+    // volatile：结果必须在第二次取时间之前写出去，否则编译器会把整段计算挪到计时之外
+    volatile size_t trueCount = 0;
+    auto runWith = [&](auto&& fn) {
+        return bestSeconds([&] {
+            size_t count = 0;
+            for (size_t i = 0; i < pairCount; ++i) count += fn(i);
+            trueCount = count;
+        }, 3);
+    };
+    double tBase = runWith([&](size_t i) { return solution.canConstruct(notes[i], mags[i]); });
+    double tScalar = runWith([&](size_t i) {
+        return ransom::canConstructWith(ransom::histogramScalar, pairs[i].first, pairs[i].second);
+    });
+    double tBanked = runWith([&](size_t i) {
+        return ransom::canConstructWith(ransom::histogramBanked, pairs[i].first, pairs[i].second);
+    });
+    double tFast = runWith([&](size_t i) { return ransom::canConstructFast(pairs[i].first, pairs[i].second); });
+    double tBatch = bestSeconds([&] { ransom::canConstructBatch(pairs, out); }, 3);
+
+    std::printf("%zu 对，magazine 长 %zu，字母表大小 %d，可构造 %zu 对\n", pairCount, magazineLen, alphabet,
+                static_cast<size_t>(trueCount));
+    auto report = [&](const char* name, double t) {
+        std::printf("%-28s: %8.2f ms  %6.2f GB/s  %7.1f ns/对  加速 %.2fx\n", name, t * 1e3,
+                    bytes / t / 1e9, t * 1e9 / pairCount, tBase / t);
+    };
+    report("canConstruct（提交版）", tBase);
+    report("单表栈上直方图", tScalar);
+    report("4 bank 直方图", tBanked);
+    report("自动选择（单表/AVX2）", tFast);
+    report("canConstructBatch", tBatch);
+    return ok ? 0 : 1;
+}
+
+// ================= 基准：./leetcode_383 bench-early [MB] =================
+
+// 参考实现：完整统计两边的 256 桶直方图，用于校验
+static bool canConstructBytesRef(string_view note, string_view magazine) {
+    std::vector<long> cnt(256);
+    for (char c : magazine) cnt[static_cast<unsigned char>(c)]++;
+    for (char c : note) {
+        if (--cnt[static_cast<unsigned char>(c)] < 0) return false;
+    }
+    return true;
+}
+
+static bool canConstructUtf8Ref(string_view note, string_view magazine) {
+    std::unordered_map<char32_t, long> cnt;
+    auto each = [](string_view s, auto&& fn) {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data());
+        for (size_t i = 0, len; i < s.size(); i += len) fn(ransom::decodeUtf8(p + i, s.size() - i, len));
+    };
+    each(magazine, [&](char32_t cp) { cnt[cp]++; });
+    bool ok = true;
+    each(note, [&](char32_t cp) { ok &= --cnt[cp] >= 0; });
+    return ok;
+}
+
+static int runEarlyExitBenchmark(size_t mb) {
+    std::mt19937 rng(34);
+    bool ok = true;
+    // 1) 任意字节（含 0x80 以上）和随机 UTF-8 片段的交叉校验
+    const char* pieces[] = {"a", "b", "Z", "中", "文", "🙂", "\xff", "\xe4\xb8", "é"};
+    auto randomMixed = [&](size_t count) {
+        std::string s;
+        for (size_t k = 0; k < count; ++k) s += pieces[rng() % (sizeof(pieces) / sizeof(pieces[0]))];
+        return s;
     };
+    for (int iter = 0; iter < 20000 && ok; ++iter) {
+        std::string m = randomMixed(rng() % 200);
+        std::string n = randomMixed(rng() % 40);
+        ok &= ransom::canConstructBytes(n, m) == canConstructBytesRef(n, m);
+        ok &= ransom::canConstructUtf8(n, m) == canConstructUtf8Ref(n, m);
+    }
+    // 2) 纯小写输入上与提交版一致
+    Solution solution;
+    for (int iter = 0; iter < 2000 && ok; ++iter) {
+        std::string m = randomLetters(rng, rng() % 10000, 4);
+        std::string n = randomLetters(rng, rng() % 3000, 4);
+        bool ref = solution.canConstruct(n, m);
+        ok &= ransom::canConstructBytes(n, m) == ref && ransom::canConstructUtf8(n, m) == ref;
+    }
+    std::cout << (ok ? "正确性校验通过" : "正确性校验失败") << std::endl;
+
+    // 场景 A：note 是 64 个常见字母，magazine 开头几 KB 就能凑齐
+    // 场景 B：note 里有 3 个 'z'，而 magazine 里 'z' 每 1MB 才出现一次（触发 memchr 收尾）
+    // 场景 C：UTF-8 中文 magazine，note 是 32 个汉字
+    const size_t bytes = mb << 20;
+    std::string magA = randomLetters(rng, bytes, 25);  // 'a'..'y'
+    std::string noteA = randomLetters(rng, 64, 25);
+    std::string magB = magA;
+    for (size_t pos = (1u << 20) - 1; pos < magB.size(); pos += 1u << 20) magB[pos] = 'z';
+    std::string noteB = noteA + "zzz";
+    const char* hanzi[] = {"的", "一", "是", "在", "不", "了", "有", "和", "人", "这"};
+    std::string magC;
+    magC.reserve(bytes);
+    while (magC.size() + 4 < bytes) magC += (rng() % 4) ? hanzi[rng() % 10] : " ";
+    std::string noteC;
+    for (int k = 0; k < 32; ++k) noteC += hanzi[rng() % 10];
+
+    volatile bool sink = false;
+    auto report = [&](const char* name, const std::string& mag, double t) {
+        std::printf("  %-26s: %10.3f ms  (全量扫描等价 %.2f GB/s)\n", name, t * 1e3, mag.size() / t / 1e9);
+    };
+    std::printf("magazine %zu MB\n", mb);
+
+    std::printf("场景 A：note 很快被满足\n");
+    report("canConstruct（提交版）", magA, bestSeconds([&] { sink = solution.canConstruct(noteA, magA); }, 3));
+    report("canConstructFast（全量）", magA, bestSeconds([&] { sink = ransom::canConstructFast(noteA, magA); }, 3));
+    report("canConstructBytes", magA, bestSeconds([&] { sink = ransom::canConstructBytes(noteA, magA); }, 3));
+    report("canConstructUtf8", magA, bestSeconds([&] { sink = ransom::canConstructUtf8(noteA, magA); }, 3));
+
+    std::printf("场景 B：最后只差稀有字母 'z'\n");
+    report("canConstructFast（全量）", magB, bestSeconds([&] { sink = ransom::canConstructFast(noteB, magB); }, 3));
+    report("canConstructBytes", magB, bestSeconds([&] { sink = ransom::canConstructBytes(noteB, magB); }, 3));
+
+    std::printf("场景 C：UTF-8 中文\n");
+    report("canConstructBytes（按字节）", magC, bestSeconds([&] { sink = ransom::canConstructBytes(noteC, magC); }, 3));
+    report("canConstructUtf8", magC, bestSeconds([&] { sink = ransom::canConstructUtf8(noteC, magC); }, 3));
+    (void)sink;
+
+    ok &= ransom::canConstructBytes(noteB, magB) == canConstructBytesRef(noteB, magB);
+    ok &= ransom::canConstructUtf8(noteC, magC) == canConstructUtf8Ref(noteC, magC);
+    return ok ? 0 : 1;
+}
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc >= 2 && std::strcmp(argv[1], "bench") == 0) {
+        size_t pairs = argc >= 3 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+        size_t len = argc >= 4 ? std::strtoull(argv[3], nullptr, 10) : 100;
+        // 均匀的 26 个字母；再测只有 2 个字母的偏斜输入：同一计数器被连续自增，存储转发停顿最明显
+        int rc = runBenchmark(pairs ? pairs : 1, len ? len : 1, 26);
+        return rc | runBenchmark(pairs ? pairs : 1, len ? len : 1, 2);
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "bench-early") == 0) {
+        size_t mb = argc >= 3 ? std::strtoull(argv[2], nullptr, 10) : 64;
+        return runEarlyExitBenchmark(mb ? mb : 1);
+    }
     Solution solution;
     std::string ransomNote = "aa";
     std::string magazine = "baa";
     bool result = solution.canConstruct(ransomNote, magazine);
     std::cout << result << std::endl;
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,323 @@
+#pragma once
+
+// LeetCode 383（赎金信）的各个解法，leetcode_383.cpp 和 bench_leetcode.cpp 共用：
+//   lc383::Solution                  提交版
+//   lc383::ransom::*                 多 bank 直方图 / AVX2 / 任意字节与 UTF-8 + 提前结束
+//   lc383::randomLetters             随机小写字母输入
+
+#include<iostream>
+#include<vector>
+#include<string>
+#include<string_view>
+#include<unordered_map>
+#include<cstring>
+#include<cstdint>
+#include<cstdlib>
+#include<cstdio>
+#include<algorithm>
+#include<chrono>
+#include<random>
+#if defined(__x86_64__) || defined(__i386__)
+#include<immintrin.h>
+#endif
+#include "../../common/trace_ring.h"
+
+namespace lc383 {
+
+class Solution {
+    public:
+        bool canConstruct(std::string ransomNote, std::string magazine) {
+            if (ransomNote.size() > magazine.size()) {
+                return false;
+            }
+            std::vector<int> cnt(26);
+            for(auto& c : magazine) {
+                cnt[c - 'a']++;
+            }
+            for(auto& c: ransomNote) {
+                cnt[c - 'a']--;
+                if (cnt[c - 'a'] < 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+// ================= 大规模版本：栈上多 bank 直方图 + AVX2 =================
+// 提交版每次调用：两次按值拷贝 string + 一次堆分配 vector<int>(26)，统计时逐字节 cnt[c-'a']++。
+// 逐字节自增的瓶颈是“存储转发”：相邻两个相同字母会对同一个计数器做 读-改-写，
+// 后一次读必须等前一次写完成，形成依赖链。这里：
+//   1) histogramBanked：4 张交错的计数表（第 i 个字节写第 i%4 张表），相同字母连续出现时
+//      落在不同表上，依赖链断开；最后把 4 张表加起来。表都在栈上，没有堆分配
+//   2) histogramAvx2：每 32 字节与 26 个字母分别做向量比较，用字节累加器计数（每 255 块归并一次）
+//   3) canConstructFast：按 magazine 长度选内核统计，note 在同一张表上扣减，缺字母立即返回
+//   4) canConstructBatch：一次处理很多 (ransomNote, magazine) 对，结果写进一个字节数组
+// 前提与提交版相同：输入只含 'a'..'z'。下标统一做 & 31，越界字符不会写坏内存（结果未定义）。
+
+namespace ransom {
+
+using Hist = uint32_t[32];  // 只用前 26 项，凑 32 便于 & 31
+
+inline void histogramScalar(const char* s, size_t n, Hist out) {
+    for (size_t i = 0; i < n; ++i) out[(static_cast<unsigned char>(s[i]) - 'a') & 31]++;
+}
+
+inline void histogramBanked(const char* s, size_t n, Hist out) {
+    constexpr int kBanks = 4;
+    uint32_t bank[kBanks][32] = {};
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(s);
+    size_t i = 0;
+    for (; i + kBanks <= n; i += kBanks) {
+        bank[0][(p[i] - 'a') & 31]++;
+        bank[1][(p[i + 1] - 'a') & 31]++;
+        bank[2][(p[i + 2] - 'a') & 31]++;
+        bank[3][(p[i + 3] - 'a') & 31]++;
+    }
+    for (; i < n; ++i) bank[0][(p[i] - 'a') & 31]++;
+    for (int c = 0; c < 32; ++c) out[c] += bank[0][c] + bank[1][c] + bank[2][c] + bank[3][c];
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// 一次处理 kGroup 个字母：kGroup 个累加器 + kGroup 个字母常量 + 1 个数据寄存器。
+// 原来一组 13 个字母要 27 个寄存器，ymm 只有 16 个：字母常量变成内存操作数，
+// 累加器也被挤到栈上，每块都要 load/store 一遍。改成 7 个一组（15 个寄存器）：g++ 12 -O3 下
+// 累加器全在寄存器里，只有几个字母常量作为 vpcmpeqb 的内存操作数（只读，不写回）。
+// 26 个字母要扫 4 遍数据（7+7+7+5），但实测 1MB 输入仍比 13 个一组快约 20%。
+template <int kGroup>
+__attribute__((target("avx2"))) inline void countLettersAvx2(const __m256i* blocks, size_t nblocks,
+                                                           int firstLetter, Hist out) {
+    size_t b = 0;
+    while (b < nblocks) {
+        // 字节累加器最多加 255 次就要归并，否则溢出
+        size_t end = std::min(nblocks, b + 255);
+        __m256i acc[kGroup];
+        __m256i letter[kGroup];
+#pragma GCC unroll 8
+        for (int k = 0; k < kGroup; ++k) {
+            acc[k] = _mm256_setzero_si256();
+            letter[k] = _mm256_set1_epi8(static_cast<char>('a' + firstLetter + k));
+        }
+        for (; b < end; ++b) {
+            __m256i v = _mm256_loadu_si256(blocks + b);
+#pragma GCC unroll 8
+            for (int k = 0; k < kGroup; ++k) {
+                // 相等时 cmpeq 得到 0xFF（即 -1），减去它相当于 +1
+                acc[k] = _mm256_sub_epi8(acc[k], _mm256_cmpeq_epi8(v, letter[k]));
+            }
+        }
+        for (int k = 0; k < kGroup; ++k) {
+            __m256i sums = _mm256_sad_epu8(acc[k], _mm256_setzero_si256());  // 4 个 64 位部分和
+            out[firstLetter + k] += static_cast<uint32_t>(
+                _mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1) +
+                _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3));
+        }
+    }
+}
+
+__attribute__((target("avx2"))) inline void histogramAvx2(const char* s, size_t n, Hist out) {
+    const size_t nblocks = n / 32;
+    const __m256i* blocks = reinterpret_cast<const __m256i*>(s);
+    countLettersAvx2<7>(blocks, nblocks, 0, out);
+    countLettersAvx2<7>(blocks, nblocks, 7, out);
+    countLettersAvx2<7>(blocks, nblocks, 14, out);
+    countLettersAvx2<5>(blocks, nblocks, 21, out);
+    histogramBanked(s + nblocks * 32, n - nblocks * 32, out);
+}
+
+#endif
+
+using HistFn = void (*)(const char*, size_t, Hist);
+
+// 按长度选内核（本机 g++ 12 -O3，随机小写字母，单次统计 ns）：
+//   长度      32    128    192    256    512   1024
+//   scalar    66    123    161    208    361    669
+//   banked    93    141    173    205    320    593
+//   avx2     137    157    170    181    241    348
+// 256 字节以下单表最快（多 bank 的清零/合并、AVX2 的 4 遍扫描都是固定开销）；
+// 256 起 AVX2 最快。多 bank 只在没有 AVX2 时使用，它也是从 256 左右才追上单表。
+inline void histogram(const char* s, size_t n, Hist out) {
+    if (n < 256) {
+        histogramScalar(s, n, out);
+        return;
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2) {
+        histogramAvx2(s, n, out);
+        return;
+    }
+#endif
+    histogramBanked(s, n, out);
+}
+
+// 两张直方图逐项比较：用于对比各个内核
+inline bool canConstructWith(HistFn hist, std::string_view note, std::string_view magazine) {
+    if (note.size() > magazine.size()) return false;
+    Hist have = {};
+    Hist need = {};
+    hist(magazine.data(), magazine.size(), have);
+    hist(note.data(), note.size(), need);
+    bool ok = true;
+    for (int c = 0; c < 26; ++c) ok &= need[c] <= have[c];  // 无分支汇总
+    return ok;
+}
+
+inline bool canConstructFast(std::string_view note, std::string_view magazine) {
+    if (note.size() > magazine.size()) return false;
+    Hist have = {};
+    histogram(magazine.data(), magazine.size(), have);
+    // note 通常远短于 magazine：直接在同一张表上扣减，缺字母立即返回
+    for (char ch : note) {
+        uint32_t& h = have[(static_cast<unsigned char>(ch) - 'a') & 31];
+        if (h == 0) {
+            TRACE_EVENT("ransom.missing", static_cast<unsigned char>(ch), magazine.size());
+            return false;
+        }
+        --h;
+    }
+    return true;
+}
+
+// 批量接口：out[i] = canConstruct(pairs[i])
+inline void canConstructBatch(const std::vector<std::pair<std::string_view, std::string_view>>& pairs,
+                              std::vector<uint8_t>& out) {
+    out.resize(pairs.size());
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        out[i] = canConstructFast(pairs[i].first, pairs[i].second);
+    }
+}
+
+}  // namespace ransom
+
+// ================= 任意字节 / UTF-8 + 提前结束 =================
+// 提交版只支持 'a'..'z'，cnt[c - 'a'] 对其它字节直接越界。生产数据是任意字节或 UTF-8 文本，这里补两种模式：
+//   1) canConstructBytes：256 桶，按字节计数
+//   2) canConstructUtf8：按码点计数。ASCII 走 128 项数组，非 ASCII 码点走哈希表；
+//      非法 UTF-8 字节按单字节处理，映射到 0x110000 + byte，不会与合法码点混淆
+// 两种模式都换了一个方向：先统计 note 的需求，再扫 magazine 扣减需求，需求清零立刻返回 true，
+// 不必把很长的 magazine 扫完。另外只剩一种字母没凑齐时（通常是 note 里最稀有的那个），
+// 改用 memchr（glibc 内部是向量化的）直接跳到它的下一次出现，中间的字节不再逐个处理。
+
+namespace ransom {
+
+inline bool canConstructBytes(std::string_view note, std::string_view magazine) {
+    if (note.size() > magazine.size()) return false;
+    if (note.empty()) return true;
+
+    int32_t need[256] = {};
+    int unmetKinds = 0;  // 还没凑齐的不同字节数
+    for (char ch : note) {
+        if (need[static_cast<unsigned char>(ch)]++ == 0) ++unmetKinds;
+    }
+    size_t deficit = note.size();
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(magazine.data());
+    const size_t n = magazine.size();
+    constexpr size_t kBlock = 4096;  // 每块检查一次能否结束，块内无分支
+    size_t i = 0;
+    while (i < n) {
+        size_t end = std::min(n, i + kBlock);
+        for (; i < end; ++i) {
+            int32_t& d = need[p[i]];
+            int32_t take = d > 0;
+            d -= take;
+            deficit -= static_cast<size_t>(take);
+            unmetKinds -= take & (d == 0);
+        }
+        if (deficit == 0) return true;
+        if (unmetKinds == 1) {
+            int last = 0;
+            while (need[last] == 0) ++last;
+            TRACE_EVENT("ransom.memchr_tail", last, need[last]);
+            while (i < n) {
+                const void* hit = std::memchr(p + i, last, n - i);
+                if (!hit) return false;
+                i = static_cast<size_t>(static_cast<const unsigned char*>(hit) - p) + 1;
+                if (--need[last] == 0) return true;
+            }
+            return false;
+        }
+    }
+    return false;
+}
+
+// 解码 p[0, n) 开头的一个码点，len 返回消耗的字节数。非法序列只消耗 1 字节
+inline char32_t decodeUtf8(const unsigned char* p, size_t n, size_t& len) {
+    const char32_t invalid = 0x110000 + p[0];
+    unsigned char b0 = p[0];
+    len = 1;
+    if (b0 < 0x80) return b0;
+    int extra;
+    char32_t cp, minCp;
+    if ((b0 & 0xE0) == 0xC0) { extra = 1; cp = b0 & 0x1F; minCp = 0x80; }
+    else if ((b0 & 0xF0) == 0xE0) { extra = 2; cp = b0 & 0x0F; minCp = 0x800; }
+    else if ((b0 & 0xF8) == 0xF0) { extra = 3; cp = b0 & 0x07; minCp = 0x10000; }
+    else return invalid;
+    if (n < static_cast<size_t>(extra) + 1) return invalid;
+    for (int k = 1; k <= extra; ++k) {
+        if ((p[k] & 0xC0) != 0x80) return invalid;
+        cp = (cp << 6) | (p[k] & 0x3F);
+    }
+    // 过长编码、代理区、超出 Unicode 范围都算非法
+    if (cp < minCp || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return invalid;
+    len = static_cast<size_t>(extra) + 1;
+    return cp;
+}
+
+inline bool canConstructUtf8(std::string_view note, std::string_view magazine) {
+    // 合法 UTF-8 的编码是唯一的，每个码点在两边占用相同字节数，所以字节长度比较仍然成立
+    if (note.size() > magazine.size()) return false;
+
+    int32_t ascii[128] = {};
+    std::unordered_map<char32_t, int32_t> other;
+    size_t deficit = 0;
+    const unsigned char* q = reinterpret_cast<const unsigned char*>(note.data());
+    for (size_t i = 0, len; i < note.size(); i += len) {
+        char32_t cp = decodeUtf8(q + i, note.size() - i, len);
+        if (cp < 128) ascii[cp]++;
+        else other[cp]++;
+        ++deficit;
+    }
+    if (deficit == 0) return true;
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(magazine.data());
+    const size_t n = magazine.size();
+    size_t i = 0;
+    while (i < n) {
+        if (p[i] < 0x80) {
+            // ASCII 快速路径：不解码、不查哈希表
+            int32_t& d = ascii[p[i]];
+            int32_t take = d > 0;
+            d -= take;
+            deficit -= static_cast<size_t>(take);
+            ++i;
+            // 每 64 字节检查一次能否结束
+            if ((i & 63) == 0 && deficit == 0) return true;
+            continue;
+        }
+        size_t len;
+        char32_t cp = decodeUtf8(p + i, n - i, len);
+        i += len;
+        if (other.empty()) continue;
+        auto it = other.find(cp);
+        if (it != other.end() && it->second > 0) {
+            --it->second;
+            if (--deficit == 0) return true;
+        }
+    }
+    return deficit == 0;
+}
+
+}  // namespace ransom
+
+// ================= 测试输入 =================
+
+inline std::string randomLetters(std::mt19937& rng, size_t n, int alphabet) {
+    std::string s(n, 'a');
+    for (auto& c : s) c = static_cast<char>('a' + rng() % alphabet);
+    return s;
+}
+
+}  // namespace lc383
@@ -1,36 +1,85 @@
 #include<vector>
 #include<iostream>
+#include<algorithm>
+#include<thread>
+#include<chrono>
+#include<random>
+#include<cstring>
+#include<cstdlib>
+#include<cstdio>
+#include<cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include<immintrin.h>
+#endif
+#include "../../common/trace_ring.h"
+#include "leetcode_88.h"
 using namespace std;
+using namespace lc88;
 
-class Solution {
-    public:
-    void merge(vector<int>& nums1, int m, vector<int>& nums2, int n) {
-        std::vector<int> vec = nums1;
-        int i = 0;
-        int j = 0;
-        while(i < m && j < n) {
-            if (vec[i] < nums2[j]) {
-                nums1[i + j] = vec[i];
-                i++; 
-            } else {
-                nums1[i + j] = nums2[j];
-                j++;
-            }
-        }
-        if (i < m) {
-            for (int k = i; k < m; k++) {
-                nums1[k + j] = vec[k];
-            }
-        }
-        if (j < n) {
-            for (int k = j; k < n; k++) {
-                nums1[i + k] = nums2[k];
-            }
+// ================= 基准：./leetcode_88 bench [MB] [threads] =================
+
+static int runBenchmark(size_t mb, unsigned threads) {
+    std::mt19937 rng(88);
+    bool ok = selfCheck(rng);
+    std::cout << (ok ? "正确性校验通过" : "正确性校验失败") << std::endl;
+
+    // nums1、nums2 各占一半；值随机均匀，两侧高度交错，分支版本几乎每步都可能预测失败
+    const size_t total = (mb << 20) / sizeof(int);
+    const size_t m = total / 2, n = total - m;
+    std::vector<int> a = sortedRandom(rng, m, 1 << 30);
+    std::vector<int> b = sortedRandom(rng, n, 1 << 30);
+    std::vector<int> expect(total);
+    std::merge(a.begin(), a.end(), b.begin(), b.end(), expect.begin());
+
+    std::vector<int> nums1(total), out(total);
+    auto reset = [&] {
+        std::copy(a.begin(), a.end(), nums1.begin());
+        std::fill(nums1.begin() + m, nums1.end(), 0);
+    };
+    // 每轮先恢复 nums1（不计时），再只计归并本身
+    auto best = [&](auto&& run, std::vector<int>& result) {
+        double t = 1e100;
+        for (int r = 0; r < 5; ++r) {
+            reset();
+            auto t0 = std::chrono::steady_clock::now();
+            run();
+            auto t1 = std::chrono::steady_clock::now();
+            t = std::min(t, std::chrono::duration<double>(t1 - t0).count());
         }
+        ok &= result == expect;
+        return t;
+    };
+    auto report = [&](const char* name, double t) {
+        std::printf("  %-28s: %8.2f ms  %6.2f G 元素/秒  %6.2f GB/s\n", name, t * 1e3, total / t / 1e9,
+                    total * sizeof(int) * 2 / t / 1e9);  // 读一遍 + 写一遍
+    };
+
+    Solution solution;
+    std::printf("m = n = %zu 个 int（共 %zu MB），%u 线程\n", m, mb, threads);
+    report("Solution::merge（提交版）",
+           best([&] { solution.merge(nums1, static_cast<int>(m), b, static_cast<int>(n)); }, nums1));
+    report("std::merge（另开输出）",
+           best([&] { std::merge(a.begin(), a.end(), b.begin(), b.end(), out.begin()); }, out));
+    report("mergeInPlace（无分支）", best([&] { merging::mergeInPlace(nums1.data(), m, b.data(), n); }, nums1));
+    report("mergeInPlaceFast（AVX2）", best([&] { merging::mergeInPlaceFast(nums1.data(), m, b.data(), n); }, nums1));
+    // 1, 2, 4, ...，最后一档是 threads 本身
+    for (unsigned t = 1;; t = std::min(t * 2, threads)) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "mergeParallel（%u 线程）", t);
+        std::fill(out.begin(), out.end(), 0);
+        report(name, best([&] { merging::mergeParallel(a.data(), m, b.data(), n, out.data(), t); }, out));
+        if (t == threads) break;
     }
-};
+    std::cout << (ok ? "✅ 所有版本结果一致" : "❌ 结果不一致") << std::endl;
+    return ok ? 0 : 1;
+}
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc >= 2 && std::strcmp(argv[1], "bench") == 0) {
+        size_t mb = argc >= 3 ? std::strtoull(argv[2], nullptr, 10) : 64;
+        unsigned threads = argc >= 4 ? std::strtoul(argv[3], nullptr, 10) : std::thread::hardware_concurrency();
+        return runBenchmark(mb ? mb : 1, threads ? threads : 1);
+    }
     std::vector<int> nums1 = {1, 2, 3, 0, 0, 0};
     std::vector<int> nums2 = {2, 5, 6};
     Solution().merge(nums1, 3, nums2, 3);
@@ -38,4 +87,4 @@ int main() {
         std::cout << nums1[i] << " ";
     }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+// LeetCode 88（合并两个有序数组）的各个解法，leetcode_88.cpp、bench_leetcode.cpp、kway_merge.cpp 共用：
+//   lc88::Solution                 提交版
+//   lc88::merging::*               原地尾部归并 / AVX2 双调归并网络 / 并行 merge path
+//   lc88::sortedRandom, selfCheck  随机有序输入；所有版本对照 std::merge 校验
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include "../../common/trace_ring.h"
+
+namespace lc88 {
+
+class Solution {
+    public:
+    void merge(std::vector<int>& nums1, int m, std::vector<int>& nums2, int n) {
+        std::vector<int> vec = nums1;
+        int i = 0;
+        int j = 0;
+        while(i < m && j < n) {
+            if (vec[i] < nums2[j]) {
+                nums1[i + j] = vec[i];
+                i++; 
+            } else {
+                nums1[i + j] = nums2[j];
+                j++;
+            }
+        }
+        if (i < m) {
+            for (int k = i; k < m; k++) {
+                nums1[k + j] = vec[k];
+            }
+        }
+        if (j < n) {
+            for (int k = j; k < n; k++) {
+                nums1[i + k] = nums2[k];
+            }
+        }
+    }
+};
+
+// ================= 大规模版本：原地尾部归并 + 双调归并网络 + 并行 merge path =================
+// 提交版先把 nums1 整个拷贝进 vec 再从头归并，额外 O(m+n) 内存和一次完整拷贝。
+// nums1 尾部本来就空着 n 个位置，从尾部往前归并就不会覆盖还没读到的元素：
+//   1) mergeInPlace：尾部优先 + 无分支选择（比较结果直接算出下标增量），随机交错的输入不再分支预测失败
+//   2) mergeInPlaceAvx2：8 路 int32 双调归并网络，每次比较一整块 8 个数；仍然是尾部优先、原地
+//   3) mergeParallel：merge path 把输出按对角线均分给多个线程，每段二分查找自己的起点后独立归并。
+//      原地归并时各段的读写区间会交叉，所以并行版写到调用方给的输出数组（与 std::merge 同一约定）
+
+namespace merging {
+
+// 从尾部往前把 x[0, xn) 和 y[0, yn) 归并到 out[0, xn + yn)。
+// out 可以就是 x（原地，x 的剩余部分本来就在位置上），但不能与 y 重叠。相等时 x 的元素排在前面
+inline void mergeBackward(int* out, const int* x, size_t xn, const int* y, size_t yn) {
+    size_t k = xn + yn;
+    while (xn > 0 && yn > 0) {
+        int vx = x[xn - 1];
+        int vy = y[yn - 1];
+        bool fromX = vx > vy;
+        out[--k] = fromX ? vx : vy;
+        xn -= fromX;
+        yn -= !fromX;
+    }
+    if (yn > 0) std::memcpy(out, y, yn * sizeof(int));
+    if (xn > 0 && out != x) std::memcpy(out, x, xn * sizeof(int));
+}
+
+inline void mergeInPlace(int* nums1, size_t m, const int* nums2, size_t n) {
+    mergeBackward(nums1, nums1, m, nums2, n);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// 对一个双调序列（8 个 int32）做 4/2/1 三级比较交换，结果升序
+__attribute__((target("avx2"))) inline __m256i bitonicSort8(__m256i v) {
+    __m256i p = _mm256_permute2x128_si256(v, v, 1);
+    v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xF0);
+    p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xCC);
+    p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+    v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xAA);
+    return v;
+}
+
+// 两个升序的 8 元向量 → lo 是 16 个里最小的 8 个（升序），hi 是最大的 8 个（升序）。
+// 把 b 反转后与 a 拼成双调序列，第一级 min/max 就把它分成上下两半
+__attribute__((target("avx2"))) inline void bitonicMerge8x2(__m256i a, __m256i b, __m256i& lo, __m256i& hi) {
+    const __m256i rev = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    b = _mm256_permutevar8x32_epi32(b, rev);
+    lo = bitonicSort8(_mm256_min_epi32(a, b));
+    hi = bitonicSort8(_mm256_max_epi32(a, b));
+}
+
+// 尾部优先的向量归并：寄存器里保留当前 8 个候选，每轮从“末尾元素更大”的一侧再取 8 个，
+// 归并网络的高 8 个一定是剩余元素里最大的，直接写到输出尾部。
+// 写入位置 = 未读的 nums1 个数 + 未读的 nums2 个数 + 8，永远不会踩到还没读的 nums1
+__attribute__((target("avx2"))) inline void mergeInPlaceAvx2(int* nums1, size_t m, const int* nums2, size_t n) {
+    if (m < 8 || n < 8) {
+        mergeInPlace(nums1, m, nums2, n);
+        return;
+    }
+    size_t i = m - 8;
+    size_t j = n - 8;
+    size_t k = m + n;
+    __m256i keep, hi;
+    bitonicMerge8x2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(nums1 + i)),
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(nums2 + j)), keep, hi);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(nums1 + k - 8), hi);
+    k -= 8;
+    while (i >= 8 && j >= 8) {
+        __m256i v;
+        // 相等时先取 nums2：nums2 的元素排在后面，与标量版的稳定性一致
+        if (nums1[i - 1] > nums2[j - 1]) {
+            i -= 8;
+            v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(nums1 + i));
+        } else {
+            j -= 8;
+            v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(nums2 + j));
+        }
+        bitonicMerge8x2(v, keep, keep, hi);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(nums1 + k - 8), hi);
+        k -= 8;
+    }
+    // 收尾：寄存器里的 8 个和不足 8 个的那一侧先在栈上归并成一小段（≤ 15 个），
+    // 再与另一侧剩下的长段做一次标量尾部归并
+    TRACE_EVENT("merge.avx2_tail", i, j);
+    alignas(32) int buf[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(buf), keep);
+    int small[16];
+    if (i < 8) {
+        int left[8];
+        std::memcpy(left, nums1, i * sizeof(int));
+        mergeBackward(small, left, i, buf, 8);
+        mergeBackward(nums1, small, i + 8, nums2, j);
+    } else {
+        mergeBackward(small, buf, 8, nums2, j);
+        mergeBackward(nums1, nums1, i, small, j + 8);
+    }
+}
+
+#endif
+
+inline void mergeInPlaceFast(int* nums1, size_t m, const int* nums2, size_t n) {
+#if defined(__x86_64__) || defined(__i386__)
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2) {
+        mergeInPlaceAvx2(nums1, m, nums2, n);
+        return;
+    }
+#endif
+    mergeInPlace(nums1, m, nums2, n);
+}
+
+// merge path：输出的前 d 个元素由 a 的前 i 个和 b 的前 d-i 个组成，二分找这个 i。
+// 相等时 a 在前（与 std::merge 一致）
+inline size_t mergePathSplit(const int* a, size_t m, const int* b, size_t n, size_t d) {
+    size_t lo = d > n ? d - n : 0;
+    size_t hi = std::min(d, m);
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (a[mid] <= b[d - mid - 1]) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+inline void mergeParallel(const int* a, size_t m, const int* b, size_t n, int* out, unsigned threads) {
+    const size_t total = m + n;
+    // 每段至少 64K 个元素，否则线程创建开销比归并本身还大
+    size_t parts = std::max<size_t>(1, std::min<size_t>(threads, total >> 16));
+    if (parts == 1) {
+        mergeBackward(out, a, m, b, n);
+        return;
+    }
+    auto segment = [&](size_t p) {
+        size_t d0 = total * p / parts;
+        size_t d1 = total * (p + 1) / parts;
+        size_t i0 = mergePathSplit(a, m, b, n, d0);
+        size_t i1 = mergePathSplit(a, m, b, n, d1);
+        mergeBackward(out + d0, a + i0, i1 - i0, b + (d0 - i0), (d1 - i1) - (d0 - i0));
+    };
+    std::vector<std::thread> ts;
+    for (size_t p = 1; p < parts; ++p) ts.emplace_back(segment, p);
+    segment(0);
+    for (auto& t : ts) t.join();
+}
+
+}  // namespace merging
+
+// ================= 校验：随机有序输入，对照 std::merge =================
+
+inline std::vector<int> sortedRandom(std::mt19937& rng, size_t n, int range) {
+    std::vector<int> v(n);
+    std::uniform_int_distribution<int> dist(0, range);
+    for (auto& x : v) x = dist(rng);
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+inline bool selfCheck(std::mt19937& rng) {
+    Solution solution;
+    for (int iter = 0; iter < 3000; ++iter) {
+        // 值域很小以制造大量重复；长度覆盖 0、不足 8、整块和零头
+        size_t m = rng() % 90;
+        size_t n = rng() % 90;
+        int range = iter % 3 == 0 ? 5 : 1000;
+        std::vector<int> a = sortedRandom(rng, m, range);
+        std::vector<int> b = sortedRandom(rng, n, range);
+        std::vector<int> expect(m + n);
+        std::merge(a.begin(), a.end(), b.begin(), b.end(), expect.begin());
+
+        std::vector<int> nums1 = a;
+        nums1.resize(m + n);
+        std::vector<int> orig = nums1, scalar = nums1, simd = nums1;
+        solution.merge(orig, static_cast<int>(m), b, static_cast<int>(n));
+        merging::mergeInPlace(scalar.data(), m, b.data(), n);
+        merging::mergeInPlaceFast(simd.data(), m, b.data(), n);
+        std::vector<int> par(m + n);
+        merging::mergeParallel(a.data(), m, b.data(), n, par.data(), 4);
+        if (orig != expect || scalar != expect || simd != expect || par != expect) return false;
+    }
+    // 并行版只有总长 ≥ 64K × 段数时才真的分段，单独用大数组校验切分点
+    std::vector<int> a = sortedRandom(rng, 300001, 50), b = sortedRandom(rng, 200003, 50);
+    std::vector<int> expect(a.size() + b.size()), par(a.size() + b.size());
+    std::merge(a.begin(), a.end(), b.begin(), b.end(), expect.begin());
+    merging::mergeParallel(a.data(), a.size(), b.data(), b.size(), par.data(), 7);
+    return par == expect;
+}
+
+}  // namespace lc88
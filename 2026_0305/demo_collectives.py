@@ -1,4 +1,5 @@
 import argparse
+import time
 
 import torch
 import torch.distributed as dist
@@ -25,14 +26,81 @@ def reduce_scatter_sum_fallback(big: torch.Tensor, world: int) -> torch.Tensor:
     return shard
 
 
+def print_row(op: str, algo: str, nbytes: int, ms: float, world: int):
+    """与 shm_collectives.cpp 相同的输出格式（nccl-tests 口径的 algbw / busbw），方便逐行对比。"""
+    algbw = nbytes / (ms * 1e-3) / 1e9
+    factor = 2.0 * (world - 1) / world if op == "all_reduce" else (world - 1) / world
+    print(
+        f"{op:<14} {algo:<8} size={nbytes / 1024:10.0f} KB  time={ms:9.3f} ms  "
+        f"algbw={algbw:7.2f} GB/s  busbw={algbw * factor:7.2f} GB/s",
+        flush=True,
+    )
+
+
+def bench(sizes_kb, device):
+    """
+    测 bus bandwidth：size 对三种操作都指总数据量（AllReduce 的缓冲、AllGather 的输出、ReduceScatter 的输入）。
+    对照：g++ -O3 -std=c++17 shm_collectives.cpp -o shm_collectives && ./shm_collectives bench 4
+    """
+    rank, world = dist.get_rank(), dist.get_world_size()
+    for kb in sizes_kb:
+        total = max(world, int(kb * 1024) // 4 // world * world)
+        shard = total // world
+        nbytes = total * 4
+        iters = int(min(200, max(5, 2e8 / nbytes)))
+        big = torch.ones(total, device=device) * (rank + 1)
+        part = torch.ones(shard, device=device) * (rank + 1)
+        gather_list = [torch.empty_like(part) for _ in range(world)]
+        out = torch.empty(shard, device=device)
+
+        def reduce_scatter_once():
+            dist.reduce_scatter(out, list(big.chunk(world)), op=dist.ReduceOp.SUM)
+
+        # gloo 不支持 reduce_scatter 时退回 all_reduce + 切片，并在 algo 列标出 fallback
+        rs_algo = "native"
+        try:
+            reduce_scatter_once()
+        except RuntimeError:
+            rs_algo = "fallback"
+
+            def reduce_scatter_once():
+                out.copy_(reduce_scatter_sum_fallback(big.clone(), world))
+
+        cases = [
+            ("all_reduce", "native", lambda: dist.all_reduce(big, op=dist.ReduceOp.SUM)),
+            ("all_gather", "native", lambda: dist.all_gather(gather_list, part)),
+            ("reduce_scatter", rs_algo, reduce_scatter_once),
+        ]
+        for op, algo, fn in cases:
+            fn()  # 预热
+            dist.barrier()
+            t0 = time.perf_counter()
+            for _ in range(iters):
+                fn()
+            dist.barrier()
+            ms = (time.perf_counter() - t0) * 1e3 / iters
+            if rank == 0:
+                print_row(op, algo, nbytes, ms, world)
+
+
 def main():
     parser = argparse.ArgumentParser()
     parser.add_argument("--backend", default="gloo", choices=["gloo", "nccl"])
+    parser.add_argument("--bench", action="store_true", help="测 busbw，与 shm_collectives.cpp 对比")
+    parser.add_argument("--sizes-kb", type=float, nargs="+", default=[4, 64, 1024, 16384, 65536])
     args = parser.parse_args()
 
     rank, world = init(args.backend)
     device = torch.device("cuda", rank) if args.backend == "nccl" else torch.device("cpu")
 
+    if args.bench:
+        if rank == 0:
+            print(f"world={world} processes, backend={args.backend}")
+        bench(args.sizes_kb, device)
+        dist.barrier()
+        dist.destroy_process_group()
+        return
+
     # 每个 rank 放一个不同的张量，便于观察
     x = torch.ones(4, device=device) * (rank + 1)
 
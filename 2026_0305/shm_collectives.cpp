@@ -0,0 +1,257 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../common/verify.h"
+#include "shm_collectives.h"
+
+// shm_collectives.h 的正确性检查与 bus bandwidth 测试：fork 出 world 个进程，每个进程一个 rank。
+// 和 demo_collectives.py（torch.distributed + gloo）做同样的三件事，输出格式相同，方便对比：
+//   torchrun --standalone --nproc_per_node=4 demo_collectives.py --bench
+//
+// bus bandwidth 按 nccl-tests 的口径（与进程数无关，可以直接和“单链路带宽”比较）：
+//   algbw = 数据量 / 时间，数据量取 AllReduce 的缓冲、AllGather 的输出、ReduceScatter 的输入
+//   busbw = algbw × 2(P-1)/P（AllReduce），× (P-1)/P（AllGather / ReduceScatter）
+//
+// 编译运行：
+//   g++ -O3 -std=c++17 -pthread shm_collectives.cpp -o shm_collectives
+//   ./shm_collectives [world]                     # 正确性：各操作 × 算法 × 不整除的长度 + rank 出错时不挂住，默认 world=4
+//   ./shm_collectives bench [world] [KB ...]      # 默认 4 进程，消息 4KB ~ 64MB
+
+// ================= 1. 多进程运行 =================
+
+using RankFn = std::function<bool(shmcoll::Communicator&)>;
+
+// 抛异常的 rank 置 aborted 标志，别的 rank 在等它时随之抛异常，而不是永远等下去
+static bool run_one(shmcoll::Communicator& comm, const RankFn& fn) {
+    try {
+        return fn(comm);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "rank %d: %s\n", comm.rank(), e.what());
+        comm.abort();
+        return false;
+    }
+}
+
+// 父进程当 rank 0，其余 rank fork 出来；任何一个 rank 返回 false 或异常退出都算失败
+static bool run_ranks(int world, size_t capacityFloats, const RankFn& fn) {
+    shmcoll::Communicator comm = shmcoll::Communicator::create(world, capacityFloats);
+    std::vector<pid_t> children;
+    for (int r = 1; r < world; ++r) {
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            std::perror("fork");
+            std::exit(1);
+        }
+        if (pid == 0) {
+            comm.setRank(r);
+            bool ok = run_one(comm, fn);
+            std::fflush(stdout);
+            ::_exit(ok ? 0 : 1);
+        }
+        children.push_back(pid);
+    }
+    comm.setRank(0);
+    bool ok = run_one(comm, fn);
+    for (pid_t pid : children) {
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+        ok &= WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    return ok;
+}
+
+// rank r 的第 i 个输入：都是 0.25 的整数倍且不大，P 个相加在 float 里是精确的
+static float input_value(int rank, size_t i) { return static_cast<float>(rank + 1) + static_cast<float>(i % 13) * 0.25f; }
+
+static float allreduce_expect(int world, size_t i) {
+    return static_cast<float>(world * (world + 1) / 2) + world * static_cast<float>(i % 13) * 0.25f;
+}
+
+static std::vector<shmcoll::Algo> algos_for(int world) {
+    std::vector<shmcoll::Algo> a = {shmcoll::Algo::Ring};
+    if ((world & (world - 1)) == 0) a.push_back(shmcoll::Algo::HalvingDoubling);
+    return a;
+}
+
+// ================= 2. 正确性 =================
+
+static const verify::Tolerance kExact{0, 0, 0};
+
+static bool check(shmcoll::Communicator& comm, const char* what, const std::vector<float>& got,
+                  const std::vector<float>& want) {
+    verify::Report r = verify::compare(got.data(), want.data(), got.size(), kExact, {1, true});
+    if (!r.ok) {
+        std::printf("rank %d: ", comm.rank());
+        verify::print(r, what);
+    }
+    return r.ok;
+}
+
+static bool run_demo(int world) {
+    // 1 和 7 比 world 还小（有空块），1000003 不整除
+    const std::vector<size_t> sizes = {1, 7, 4096, 1000003};
+    const size_t maxN = *std::max_element(sizes.begin(), sizes.end());
+    std::printf("world=%d, simd=%s\n", world, shmcoll::detail::addIsa());
+    bool ok = run_ranks(world, maxN * world, [&](shmcoll::Communicator& comm) {
+        bool good = true;
+        const int P = comm.world(), r = comm.rank();
+        for (shmcoll::Algo algo : algos_for(P)) {
+            for (size_t n : sizes) {
+                char what[96];
+                // AllReduce
+                std::vector<float> data(n), want(n);
+                for (size_t i = 0; i < n; ++i) {
+                    data[i] = input_value(r, i);
+                    want[i] = allreduce_expect(P, i);
+                }
+                comm.allReduce(data.data(), n, algo);
+                std::snprintf(what, sizeof(what), "allreduce %s n=%zu", shmcoll::algoName(algo), n);
+                bool a = check(comm, what, data, want);
+
+                // AllGather：第 q 段应该是 rank q 的输入
+                std::vector<float> in(n), out(n * P), wantAll(n * P);
+                for (size_t i = 0; i < n; ++i) in[i] = input_value(r, i);
+                for (int q = 0; q < P; ++q)
+                    for (size_t i = 0; i < n; ++i) wantAll[q * n + i] = input_value(q, i);
+                comm.allGather(in.data(), out.data(), n, algo);
+                std::snprintf(what, sizeof(what), "allgather %s n=%zu", shmcoll::algoName(algo), n);
+                bool g = check(comm, what, out, wantAll);
+
+                // ReduceScatter：输入 P*n，拿到第 r 段的和
+                std::vector<float> big(n * P), shard(n), wantShard(n);
+                for (size_t i = 0; i < n * P; ++i) big[i] = input_value(r, i);
+                for (size_t i = 0; i < n; ++i) wantShard[i] = allreduce_expect(P, r * n + i);
+                comm.reduceScatter(big.data(), shard.data(), n, algo);
+                std::snprintf(what, sizeof(what), "reduce_scatter %s n=%zu", shmcoll::algoName(algo), n);
+                bool s = check(comm, what, shard, wantShard);
+
+                // 每个 rank 的结论汇总到 rank 0 不方便，这里 rank 0 只报告自己的，其余 rank 出错时自己打印
+                if (r == 0)
+                    std::printf("%s %-7s n=%-8zu allreduce %s  allgather %s  reduce_scatter %s\n",
+                                a && g && s ? "✅" : "❌", shmcoll::algoName(algo), n, a ? "ok" : "BAD",
+                                g ? "ok" : "BAD", s ? "ok" : "BAD");
+                good &= a && g && s;
+            }
+        }
+        return good;
+    });
+    std::printf(ok ? "✅ all ranks OK\n" : "❌ some rank failed\n");
+    return ok;
+}
+
+// 最后一个 rank 在第二次 allReduce 之前出事，其余 rank 应该报错退出，run_ranks 返回 false 而不是挂住：
+//   throw：它自己 abort()，别人立刻看到 aborted 标志
+//   _exit：没人置标志，靠等待超时（这里设 300 ms）
+static bool run_fault_demo(int world) {
+    if (world < 2) return true;
+    bool allOk = true;
+    for (bool crash : {false, true}) {
+        auto t0 = std::chrono::steady_clock::now();
+        bool ok = run_ranks(world, 1024, [&](shmcoll::Communicator& comm) {
+            comm.setTimeout(std::chrono::milliseconds(300));
+            std::vector<float> data(1024, 1.0f);
+            comm.allReduce(data.data(), data.size(), shmcoll::Algo::Ring);
+            if (comm.rank() == comm.world() - 1) {
+                if (crash) ::_exit(3);
+                throw std::runtime_error("injected failure");
+            }
+            comm.allReduce(data.data(), data.size(), shmcoll::Algo::Ring);
+            return true;
+        });
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        // 期望失败：ok == false 才对
+        std::printf("%s rank %d %s: run_ranks %s after %.0f ms\n", ok ? "❌" : "✅", world - 1,
+                    crash ? "_exit()s" : "throws", ok ? "reported success" : "failed cleanly", ms);
+        allOk &= !ok;
+    }
+    return allOk;
+}
+
+// ================= 3. bus bandwidth =================
+
+enum class Op { AllReduce, AllGather, ReduceScatter };
+
+static const char* op_name(Op op) {
+    return op == Op::AllReduce ? "all_reduce" : op == Op::AllGather ? "all_gather" : "reduce_scatter";
+}
+
+static void print_row(Op op, const char* algo, double bytes, double ms, int world) {
+    const double algbw = bytes / (ms * 1e-3) / 1e9;
+    const double factor = op == Op::AllReduce ? 2.0 * (world - 1) / world : static_cast<double>(world - 1) / world;
+    std::printf("%-14s %-8s size=%10.0f KB  time=%9.3f ms  algbw=%7.2f GB/s  busbw=%7.2f GB/s\n", op_name(op), algo,
+                bytes / 1024.0, ms, algbw, algbw * factor);
+}
+
+static void run_benchmark(int world, const std::vector<double>& sizesKB) {
+    // 每个 rank 的工作缓冲要放得下最大一次 AllGather 的输出 / ReduceScatter 的输入
+    double maxKB = *std::max_element(sizesKB.begin(), sizesKB.end());
+    const size_t maxTotal = static_cast<size_t>(maxKB * 1024 / sizeof(float));
+    std::printf("world=%d processes, simd=%s, shm %.1f MB\n", world, shmcoll::detail::addIsa(),
+                maxTotal * sizeof(float) * world / 1e6);
+    run_ranks(world, maxTotal, [&](shmcoll::Communicator& comm) {
+        const int P = comm.world();
+        std::vector<float> a(maxTotal), b(maxTotal);
+        for (size_t i = 0; i < maxTotal; ++i) a[i] = input_value(comm.rank(), i);
+        for (double kb : sizesKB) {
+            // “size” 对三种操作都指总数据量（nccl-tests 口径），AllGather / ReduceScatter 每个 rank 贡献 1/P
+            const size_t total = std::max<size_t>(P, static_cast<size_t>(kb * 1024 / sizeof(float)) / P * P);
+            const size_t shard = total / P;
+            const double bytes = total * sizeof(float);
+            const int iters = static_cast<int>(std::clamp(2e8 / bytes, 5.0, 200.0));
+            for (Op op : {Op::AllReduce, Op::AllGather, Op::ReduceScatter}) {
+                for (shmcoll::Algo algo : algos_for(P)) {
+                    auto once = [&] {
+                        if (op == Op::AllReduce) comm.allReduce(b.data(), total, algo);
+                        else if (op == Op::AllGather) comm.allGather(a.data(), b.data(), shard, algo);
+                        else comm.reduceScatter(a.data(), b.data(), shard, algo);
+                    };
+                    std::copy_n(a.begin(), total, b.begin());
+                    once();  // 预热：把共享内存的页摸一遍
+                    comm.barrier();
+                    auto t0 = std::chrono::steady_clock::now();
+                    for (int i = 0; i < iters; ++i) once();
+                    comm.barrier();
+                    double ms =
+                        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / iters;
+                    if (comm.rank() == 0) print_row(op, shmcoll::algoName(algo), bytes, ms, P);
+                }
+            }
+        }
+        return true;
+    });
+}
+
+// ================= 主函数 =================
+
+int main(int argc, char** argv) {
+    const bool bench = argc >= 2 && std::strcmp(argv[1], "bench") == 0;
+    const int argWorld = bench ? 2 : 1;
+    const int world = argc > argWorld ? std::atoi(argv[argWorld]) : 4;
+    if (world < 1 || world > shmcoll::kMaxWorld) {
+        std::fprintf(stderr, "world must be in [1, %d]\n", shmcoll::kMaxWorld);
+        return 1;
+    }
+    // 子进程从 fork 时继承未刷出的 stdout 缓冲，先关掉缓冲避免重复输出
+    std::setvbuf(stdout, nullptr, _IONBF, 0);
+    if (bench) {
+        std::vector<double> sizesKB;
+        for (int i = 3; i < argc; ++i) sizesKB.push_back(std::atof(argv[i]));
+        if (sizesKB.empty()) sizesKB = {4, 64, 1024, 16384, 65536};
+        run_benchmark(world, sizesKB);
+        return 0;
+    }
+    bool ok = run_demo(world);
+    ok &= run_fault_demo(world);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,418 @@
+#pragma once
+
+// 单机多进程的集合通信（header-only）：POSIX 共享内存上的 AllReduce / AllGather / ReduceScatter。
+// 对应 demo_collectives.py 里 torch.distributed + gloo 做的三件事，但 ReduceScatter 是真的 reduce-scatter，
+// 不是 all_reduce 再切片。
+//
+// 内存布局（shm_open + mmap，创建后立即 shm_unlink，fork 出来的子进程继承映射）：
+//   [Control：aborted 标志 + barrier 计数 + 每个 rank 一个步数计数器（各占一条 cache line）]
+//   [rank 0 的工作缓冲][rank 1 的工作缓冲]...  每个 capacity 个 float
+// 每个 rank 先把输入拷进自己的工作缓冲，之后所有算法都是“直接读对端的缓冲、写自己的缓冲”（单边读），
+// 每完成一步就把自己的计数器推进一格；读对端某一块之前，等它的计数器到达“上一步已完成”。
+// 每次集合操作开头有一次 barrier：保证上一次操作里别人已经读完了我的缓冲，才能覆盖它。
+//
+// 算法（数据切成 P 块）：
+//   Ring             ：reduce-scatter 走 P-1 步，每步把左邻居的一块加到自己这块上；
+//                      all-gather 再走 P-1 步，每步从左邻居拷一块。每步只搬 1/P，带宽最优，步数 O(P)
+//   HalvingDoubling  ：reduce-scatter 用递归减半（距离 P/2, P/4, ..., 1 的伙伴交换一半，各保留一半并相加），
+//                      all-gather 用递归加倍。步数 O(log P)，小消息更快；要求 P 是 2 的幂
+// AllReduce = ReduceScatter + AllGather（Rabenseifner / ring allreduce）。
+// 加法是 SIMD 的（AVX-512 / AVX2 运行时分派）。
+//
+// 用法：
+//   auto comm = shmcoll::Communicator::create(world, capacityFloats);   // fork 之前
+//   fork() ... 每个进程 comm.setRank(r);
+//   comm.allReduce(data, n, shmcoll::Algo::Ring);
+//   comm.allGather(in, out, n, shmcoll::Algo::HalvingDoubling);          // out 有 world*n 个
+//   comm.reduceScatter(in, out, n, shmcoll::Algo::Ring);                 // in 有 world*n 个，out 拿到第 rank 块的和
+// 所有 rank 必须以相同的顺序、相同的参数调用同样的集合操作。
+//
+// 故障：某个 rank 抛异常时应调用 comm.abort()，控制区里的 aborted 标志让其余 rank 在下一次等待时
+// 抛 std::runtime_error；rank 直接死掉（信号、_exit）没人置标志，由等待超时兜底（默认 30 s，setTimeout 可改），
+// 超时的 rank 同样置 aborted，别的 rank 不用各自再等满一个超时。
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SHMCOLL_X86 1
+#endif
+
+namespace shmcoll {
+
+enum class Algo { Ring, HalvingDoubling };
+
+inline const char* algoName(Algo a) { return a == Algo::Ring ? "ring" : "halving"; }
+
+constexpr int kMaxWorld = 64;
+
+// ================= SIMD 归约：dst += src =================
+
+namespace detail {
+
+inline void addScalar(float* dst, const float* src, size_t n) {
+    for (size_t i = 0; i < n; ++i) dst[i] += src[i];
+}
+
+#if defined(SHMCOLL_X86)
+__attribute__((target("avx2"))) inline void addAvx2(float* dst, const float* src, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 a0 = _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_loadu_ps(src + i));
+        __m256 a1 = _mm256_add_ps(_mm256_loadu_ps(dst + i + 8), _mm256_loadu_ps(src + i + 8));
+        _mm256_storeu_ps(dst + i, a0);
+        _mm256_storeu_ps(dst + i + 8, a1);
+    }
+    for (; i < n; ++i) dst[i] += src[i];
+}
+
+__attribute__((target("avx512f"))) inline void addAvx512(float* dst, const float* src, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512 a0 = _mm512_add_ps(_mm512_loadu_ps(dst + i), _mm512_loadu_ps(src + i));
+        __m512 a1 = _mm512_add_ps(_mm512_loadu_ps(dst + i + 16), _mm512_loadu_ps(src + i + 16));
+        _mm512_storeu_ps(dst + i, a0);
+        _mm512_storeu_ps(dst + i + 16, a1);
+    }
+    if (i < n) {
+        // 尾部用掩码一次做完
+        size_t rest = n - i;
+        if (rest >= 16) {
+            _mm512_storeu_ps(dst + i, _mm512_add_ps(_mm512_loadu_ps(dst + i), _mm512_loadu_ps(src + i)));
+            i += 16;
+            rest -= 16;
+        }
+        if (rest) {
+            __mmask16 m = static_cast<__mmask16>((1u << rest) - 1);
+            __m512 a = _mm512_add_ps(_mm512_maskz_loadu_ps(m, dst + i), _mm512_maskz_loadu_ps(m, src + i));
+            _mm512_mask_storeu_ps(dst + i, m, a);
+        }
+    }
+}
+#endif
+
+using AddFn = void (*)(float*, const float*, size_t);
+
+inline AddFn pickAdd() {
+#if defined(SHMCOLL_X86)
+    if (__builtin_cpu_supports("avx512f")) return addAvx512;
+    if (__builtin_cpu_supports("avx2")) return addAvx2;
+#endif
+    return addScalar;
+}
+
+inline const char* addIsa() {
+#if defined(SHMCOLL_X86)
+    if (__builtin_cpu_supports("avx512f")) return "avx512";
+    if (__builtin_cpu_supports("avx2")) return "avx2";
+#endif
+    return "scalar";
+}
+
+inline void cpuRelax() {
+#if defined(SHMCOLL_X86)
+    _mm_pause();
+#endif
+}
+
+enum class Wait { Ok, Aborted, TimedOut };
+
+// 先自旋一小会儿，再让出 CPU：进程数多于核数时纯自旋会把对端饿死。
+// 进入让出阶段后才看 aborted 标志、才开始计时（之后每 64 次看一次钟），快路径上没有额外开销
+inline Wait waitAtLeast(const std::atomic<uint64_t>& a, uint64_t v, const std::atomic<uint64_t>& aborted,
+                        std::chrono::milliseconds timeout) {
+    std::chrono::steady_clock::time_point deadline;
+    for (int spins = 0; a.load(std::memory_order_acquire) < v; ++spins) {
+        if (spins < 256) {
+            cpuRelax();
+            continue;
+        }
+        if (aborted.load(std::memory_order_acquire) != 0) return Wait::Aborted;
+        if (spins == 256) deadline = std::chrono::steady_clock::now() + timeout;
+        else if ((spins & 63) == 0 && std::chrono::steady_clock::now() >= deadline) return Wait::TimedOut;
+        sched_yield();
+    }
+    return Wait::Ok;
+}
+
+struct alignas(64) Slot {
+    std::atomic<uint64_t> v{0};
+};
+
+struct Control {
+    Slot aborted;  // 0 = 正常，否则 = 第一个放弃的 rank + 1
+    Slot barrier;
+    Slot step[kMaxWorld];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory atomics must be lock-free");
+
+// 数据切成 P 块：第 i 块是 [lo(i), hi(i))
+struct Partition {
+    size_t n;
+    size_t per;
+    size_t lo(int i) const { return std::min(n, static_cast<size_t>(i) * per); }
+    size_t hi(int i) const { return std::min(n, static_cast<size_t>(i + 1) * per); }
+};
+
+inline size_t roundUp(size_t x, size_t a) { return (x + a - 1) / a * a; }
+
+}  // namespace detail
+
+// ================= 通信器 =================
+
+class Communicator {
+public:
+    // 在 fork 之前调用：建共享内存并初始化控制区。capacityFloats = 每个 rank 工作缓冲的容量
+    //   allReduce(n) 需要 n，allGather / reduceScatter(n) 需要 world*n
+    static Communicator create(int world, size_t capacityFloats) {
+        if (world < 1 || world > kMaxWorld)
+            throw std::invalid_argument("shmcoll: world must be in [1, " + std::to_string(kMaxWorld) + "]");
+        Communicator c;
+        c.world_ = world;
+        c.capacity_ = capacityFloats;
+        c.bufBytes_ = detail::roundUp(std::max<size_t>(capacityFloats, 1) * sizeof(float), 4096);
+        c.ctlBytes_ = detail::roundUp(sizeof(detail::Control), 4096);
+        c.bytes_ = c.ctlBytes_ + c.bufBytes_ * world;
+
+        std::string name = "/shmcoll." + std::to_string(::getpid());
+        int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+        // 映射建好就 unlink：名字不会残留在 /dev/shm，进程全部退出后内存自动回收
+        ::shm_unlink(name.c_str());
+        if (::ftruncate(fd, static_cast<off_t>(c.bytes_)) != 0) {
+            int e = errno;
+            ::close(fd);
+            throw std::system_error(e, std::generic_category(), "ftruncate " + name);
+        }
+        void* p = ::mmap(nullptr, c.bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) throw std::system_error(errno, std::generic_category(), "mmap " + name);
+        c.base_ = static_cast<char*>(p);
+        c.ctl_ = new (c.base_) detail::Control();
+        return c;
+    }
+
+    Communicator() = default;
+    Communicator(const Communicator&) = delete;
+    Communicator& operator=(const Communicator&) = delete;
+    Communicator(Communicator&& o) noexcept { *this = std::move(o); }
+    Communicator& operator=(Communicator&& o) noexcept {
+        std::swap(base_, o.base_);
+        std::swap(ctl_, o.ctl_);
+        std::swap(bytes_, o.bytes_);
+        std::swap(ctlBytes_, o.ctlBytes_);
+        std::swap(bufBytes_, o.bufBytes_);
+        std::swap(capacity_, o.capacity_);
+        std::swap(world_, o.world_);
+        std::swap(rank_, o.rank_);
+        std::swap(seq_, o.seq_);
+        std::swap(step_, o.step_);
+        std::swap(barrierEpoch_, o.barrierEpoch_);
+        std::swap(timeout_, o.timeout_);
+        return *this;
+    }
+    ~Communicator() {
+        if (base_) ::munmap(base_, bytes_);
+    }
+
+    // fork 之后每个进程调用一次
+    void setRank(int rank) {
+        if (rank < 0 || rank >= world_) throw std::invalid_argument("shmcoll: rank out of range");
+        rank_ = rank;
+    }
+
+    int rank() const { return rank_; }
+    int world() const { return world_; }
+    size_t capacity() const { return capacity_; }
+
+    // 单次等待（一次 barrier 或等对端一步）的上限，超过就认为对端死了
+    void setTimeout(std::chrono::milliseconds t) { timeout_ = t; }
+
+    // 本 rank 放弃：其余 rank 在下一次等待时抛异常而不是一直等下去。只记第一个放弃的 rank
+    void abort() {
+        uint64_t none = 0;
+        ctl_->aborted.v.compare_exchange_strong(none, static_cast<uint64_t>(rank_) + 1, std::memory_order_acq_rel);
+    }
+
+    // 计数器单调递增、从不清零，所以不需要区分“这一轮”和“上一轮”
+    void barrier() {
+        ++barrierEpoch_;
+        ctl_->barrier.v.fetch_add(1, std::memory_order_acq_rel);
+        wait(ctl_->barrier.v, barrierEpoch_ * world_, -1);
+    }
+
+    // data：每个 rank 各 n 个，结束后都变成逐元素之和
+    void allReduce(float* data, size_t n, Algo algo) {
+        checkCapacity(n);
+        checkAlgo(algo);
+        // 每块按 16 个 float（64 字节）对齐，SIMD 与 cache line 都整齐
+        detail::Partition part{n, detail::roundUp((n + world_ - 1) / world_, 16)};
+        begin();
+        std::memcpy(buf(rank_), data, n * sizeof(float));
+        publish();
+        if (algo == Algo::Ring) {
+            ringReduceScatter(part);
+            ringAllGather(part);
+        } else {
+            halvingReduceScatter(part);
+            doublingAllGather(part);
+        }
+        std::memcpy(data, buf(rank_), n * sizeof(float));
+        end();
+    }
+
+    // in：每个 rank 各 n 个；out：world*n 个，第 r 段是 rank r 的 in
+    void allGather(const float* in, float* out, size_t n, Algo algo) {
+        const size_t total = n * world_;
+        checkCapacity(total);
+        checkAlgo(algo);
+        detail::Partition part{total, n};
+        begin();
+        std::memcpy(buf(rank_) + part.lo(rank_), in, n * sizeof(float));
+        publish();
+        if (algo == Algo::Ring) ringAllGather(part);
+        else doublingAllGather(part);
+        std::memcpy(out, buf(rank_), total * sizeof(float));
+        end();
+    }
+
+    // in：每个 rank 各 world*n 个；out：n 个 = 所有 rank 的 in 的第 rank 段之和
+    void reduceScatter(const float* in, float* out, size_t n, Algo algo) {
+        const size_t total = n * world_;
+        checkCapacity(total);
+        checkAlgo(algo);
+        detail::Partition part{total, n};
+        begin();
+        std::memcpy(buf(rank_), in, total * sizeof(float));
+        publish();
+        if (algo == Algo::Ring) ringReduceScatter(part);
+        else halvingReduceScatter(part);
+        std::memcpy(out, buf(rank_) + part.lo(rank_), n * sizeof(float));
+        end();
+    }
+
+private:
+    float* buf(int r) const { return reinterpret_cast<float*>(base_ + ctlBytes_ + bufBytes_ * r); }
+
+    void checkCapacity(size_t need) const {
+        if (need > capacity_)
+            throw std::length_error("shmcoll: need " + std::to_string(need) + " floats per rank, capacity is " +
+                                    std::to_string(capacity_));
+    }
+
+    void checkAlgo(Algo algo) const {
+        if (algo == Algo::HalvingDoubling && (world_ & (world_ - 1)) != 0)
+            throw std::invalid_argument("shmcoll: halving-doubling needs a power-of-two world size");
+    }
+
+    // 一次集合操作：开头 barrier（别人已读完我上一次的缓冲），之后用本地步数 step_ 推进自己的计数器
+    void begin() {
+        barrier();
+        step_ = 0;
+    }
+    void end() { seq_ += step_; }
+
+    // 完成一步：计数器 = seq_ + 已完成步数
+    void publish() {
+        ++step_;
+        ctl_->step[rank_].v.store(seq_ + step_, std::memory_order_release);
+    }
+    // 等 peer 完成和我一样多的步数（即我下一步要读的数据它已经写好）
+    void waitPeer(int peer) { wait(ctl_->step[peer].v, seq_ + step_, peer); }
+
+    // peer < 0 表示在等 barrier；失败时转成异常
+    void wait(const std::atomic<uint64_t>& a, uint64_t v, int peer) {
+        detail::Wait w = detail::waitAtLeast(a, v, ctl_->aborted.v, timeout_);
+        if (w == detail::Wait::Ok) return;
+        const std::string me = "shmcoll: rank " + std::to_string(rank_) + " waiting for " +
+                               (peer < 0 ? std::string("barrier") : "rank " + std::to_string(peer));
+        if (w == detail::Wait::Aborted)
+            throw std::runtime_error(me + ": rank " + std::to_string(ctl_->aborted.v.load() - 1) + " aborted");
+        abort();
+        throw std::runtime_error(me + ": timed out after " + std::to_string(timeout_.count()) + " ms");
+    }
+
+    // 第 k 步把左邻居的第 (r-k-2) 块加到自己的同一块上；P-1 步后第 r 块是全体之和
+    void ringReduceScatter(const detail::Partition& part) {
+        static const detail::AddFn add = detail::pickAdd();
+        const int P = world_, r = rank_, left = (r + P - 1) % P;
+        float* mine = buf(r);
+        const float* lb = buf(left);
+        for (int k = 0; k < P - 1; ++k) {
+            const int c = ((r - k - 2) % P + 2 * P) % P;
+            waitPeer(left);
+            add(mine + part.lo(c), lb + part.lo(c), part.hi(c) - part.lo(c));
+            publish();
+        }
+    }
+
+    // 开始时每个 rank 有第 r 块；第 k 步从左邻居拷第 (r-1-k) 块
+    void ringAllGather(const detail::Partition& part) {
+        const int P = world_, r = rank_, left = (r + P - 1) % P;
+        float* mine = buf(r);
+        const float* lb = buf(left);
+        for (int k = 0; k < P - 1; ++k) {
+            const int c = ((r - 1 - k) % P + P) % P;
+            waitPeer(left);
+            std::memcpy(mine + part.lo(c), lb + part.lo(c), (part.hi(c) - part.lo(c)) * sizeof(float));
+            publish();
+        }
+    }
+
+    // 递归减半：距离 d = P/2 ... 1，伙伴 r^d 和我当前负责同一段块 [cl, ch)；
+    // r 的 d 位为 0 保留前一半，否则保留后一半，把伙伴缓冲里的这一半加过来。最后留下第 r 块
+    void halvingReduceScatter(const detail::Partition& part) {
+        static const detail::AddFn add = detail::pickAdd();
+        const int r = rank_;
+        float* mine = buf(r);
+        int cl = 0, ch = world_;
+        for (int d = world_ / 2; d >= 1; d /= 2) {
+            const int mid = cl + (ch - cl) / 2;
+            if (r & d) cl = mid;
+            else ch = mid;
+            const int peer = r ^ d;
+            const size_t lo = part.lo(cl), hi = part.lo(ch);
+            waitPeer(peer);
+            add(mine + lo, buf(peer) + lo, hi - lo);
+            publish();
+        }
+    }
+
+    // 递归加倍：距离 d = 1 ... P/2，我有对齐到 d 的 d 块，伙伴 r^d 有相邻的 d 块，拷过来后变成 2d 块
+    void doublingAllGather(const detail::Partition& part) {
+        const int r = rank_;
+        float* mine = buf(r);
+        for (int d = 1; d < world_; d *= 2) {
+            const int peer = r ^ d;
+            const int first = peer & ~(d - 1);
+            const size_t lo = part.lo(first), hi = part.lo(first + d);
+            waitPeer(peer);
+            std::memcpy(mine + lo, buf(peer) + lo, (hi - lo) * sizeof(float));
+            publish();
+        }
+    }
+
+    char* base_ = nullptr;
+    detail::Control* ctl_ = nullptr;
+    size_t bytes_ = 0, ctlBytes_ = 0, bufBytes_ = 0, capacity_ = 0;
+    int world_ = 0, rank_ = 0;
+    uint64_t seq_ = 0, step_ = 0, barrierEpoch_ = 0;
+    std::chrono::milliseconds timeout_{30000};
+};
+
+}  // namespace shmcoll
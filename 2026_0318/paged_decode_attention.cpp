@@ -0,0 +1,475 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../common/simd_isa.h"
+#include "../common/verify.h"
+
+// vllm_v1_kvcache_analysis.md / block_manager_deep_dive.md 里的 block_tables 在算子侧长什么样：
+// 一个 CPU 上的 decode attention kernel，K/V 通过 block table 从分页的物理块池里读。
+//
+//   物理池：k_cache / v_cache = [num_blocks][H][block_size][D]（一个块内同一个 head 的 token 连续，点积沿 D 向量化）
+//   block_tables[seq][i] = 该序列第 i 个逻辑块对应的物理块号（由分配器从打乱的空闲链表里取，模拟运行一段时间后的碎片）
+//   decode：每个序列只有 1 个新 query token，q = [H][D]，对 context_len 个历史 token 做 attention
+//
+// 对照组是“连续 KV”：k/v = [seq][H][max_len][D]，按最大长度预留（分页之前 HF 式的做法）。
+// 两种布局用同一个核心函数 attend_span：对一段连续的 token 做点积 + online softmax + 累加 V，
+//   - 连续 KV：每个 (seq, head) 按 128 个 token 一段调用
+//   - 分页 KV：每个逻辑块查一次 block table，对这个块调用一次
+// 所以两者的差别只剩“查表 + 段更短 + 物理地址不连续”，也就是分页本身的开销。
+//
+// SIMD：GCC 向量扩展写一份，按 AVX-512 / AVX2+FMA / 通用指令集实例化，运行时分派；
+//       向量操作和分派在 common/simd_isa.h，与 mha_cpu.cpp 共用。
+// 多线程：以序列为单位动态领取（各序列 context 长度不同）。
+// decode 每个 token 只读一遍 K/V，是访存瓶颈，所以除了 tokens/s 还报告 KV 读取带宽。
+//
+// 编译运行：
+//   g++ -O3 -std=c++17 -pthread paged_decode_attention.cpp -o paged_decode_attention
+//   ./paged_decode_attention                    # 正确性：各 ISA × block_size 对 double 参考值
+//   ./paged_decode_attention bench              # 32 个序列，context 512~1024，H=16，D=128，block 16/64/128
+//   ./paged_decode_attention bench --seqs 64 --ctx 4096 --heads 8 --dim 128 --threads 8 --no-shuffle
+
+using simd::Isa;
+using simd::Simd16;
+using simd::Simd8;
+
+// ================= 1. decode attention 核心 =================
+
+// 一个 (seq, head) 的 online softmax 状态
+struct SoftmaxState {
+    float m;
+    float l;
+    float* acc;  // [D]
+};
+
+constexpr int kMaxSpan = 128;  // 一段最多多少个 token（= 最大 block_size，也是连续 KV 的分段长度）
+
+// 对 n 个连续存放的 token（K/V 各 [n][D]）做：s_j = q·k_j，更新 m / l，acc = acc*alpha + Σ p_j v_j
+// q 已经乘过 sm_scale
+template <class Ops, int D>
+__attribute__((always_inline)) inline void attend_span(const float* q, const float* K, const float* V, int n,
+                                                       SoftmaxState& st) {
+    using VF = decltype(Ops::set1(0));
+    constexpr int W = Ops::W;
+    constexpr int ND = D / W;
+    float s[kMaxSpan];
+
+    VF qv[ND];
+    for (int c = 0; c < ND; ++c) qv[c] = Ops::load(q + c * W);
+    float mx = -std::numeric_limits<float>::infinity();
+    for (int j = 0; j < n; ++j) {
+        const float* kr = K + j * D;
+        // 两路累加，缩短 FMA 依赖链
+        VF a0 = qv[0] * Ops::load(kr), a1 = Ops::set1(0.0f);
+        for (int c = 1; c + 1 < ND; c += 2) {
+            a1 += qv[c] * Ops::load(kr + c * W);
+            a0 += qv[c + 1] * Ops::load(kr + (c + 1) * W);
+        }
+        if (ND % 2 == 0) a1 += qv[ND - 1] * Ops::load(kr + (ND - 1) * W);
+        s[j] = Ops::hsum(a0 + a1);
+        mx = std::max(mx, s[j]);
+    }
+
+    const float mNew = std::max(st.m, mx);
+    const float alpha = std::exp(st.m - mNew);  // 第一段时 m = -inf，alpha = 0
+    float sum = 0;
+    for (int j = 0; j < n; ++j) sum += (s[j] = std::exp(s[j] - mNew));
+    st.l = st.l * alpha + sum;
+    st.m = mNew;
+
+    VF acc[ND];
+    const VF av = Ops::set1(alpha);
+    for (int c = 0; c < ND; ++c) acc[c] = Ops::load(st.acc + c * W) * av;
+    for (int j = 0; j < n; ++j) {
+        const VF pj = Ops::set1(s[j]);
+        const float* vr = V + j * D;
+        for (int c = 0; c < ND; ++c) acc[c] += pj * Ops::load(vr + c * W);
+    }
+    for (int c = 0; c < ND; ++c) Ops::store(st.acc + c * W, acc[c]);
+}
+
+// 一个 decode batch：每个序列 1 个 query token
+struct DecodeBatch {
+    int numSeqs, H, D;
+    float scale;
+    const float* q;                  // [numSeqs][H][D]
+    float* out;                      // [numSeqs][H][D]
+    const int* contextLens;          // [numSeqs]
+    // 连续 KV
+    const float* kContig = nullptr;  // [numSeqs][H][maxLen][D]
+    const float* vContig = nullptr;
+    int maxLen = 0;
+    // 分页 KV
+    const float* kCache = nullptr;   // [numBlocks][H][blockSize][D]
+    const float* vCache = nullptr;
+    const int* blockTables = nullptr;  // [numSeqs][maxBlocksPerSeq]
+    int maxBlocksPerSeq = 0;
+    int blockSize = 0;
+};
+
+template <class Ops, int D>
+__attribute__((always_inline)) inline void decode_seq(const DecodeBatch& b, int seq, bool paged) {
+    const int len = b.contextLens[seq];
+    alignas(64) float q[D];
+    alignas(64) float acc[D];
+    for (int h = 0; h < b.H; ++h) {
+        const float* qs = b.q + (static_cast<size_t>(seq) * b.H + h) * D;
+        for (int d = 0; d < D; ++d) q[d] = qs[d] * b.scale;
+        std::fill(acc, acc + D, 0.0f);
+        SoftmaxState st{-std::numeric_limits<float>::infinity(), 0.0f, acc};
+        if (paged) {
+            const int* table = b.blockTables + static_cast<size_t>(seq) * b.maxBlocksPerSeq;
+            const size_t blockStride = static_cast<size_t>(b.H) * b.blockSize * D;
+            const size_t headOff = static_cast<size_t>(h) * b.blockSize * D;
+            for (int t0 = 0, i = 0; t0 < len; t0 += b.blockSize, ++i) {
+                const size_t off = table[i] * blockStride + headOff;
+                attend_span<Ops, D>(q, b.kCache + off, b.vCache + off, std::min(b.blockSize, len - t0), st);
+            }
+        } else {
+            const size_t off = (static_cast<size_t>(seq) * b.H + h) * b.maxLen * D;
+            for (int t0 = 0; t0 < len; t0 += kMaxSpan) {
+                const size_t o = off + static_cast<size_t>(t0) * D;
+                attend_span<Ops, D>(q, b.kContig + o, b.vContig + o, std::min(kMaxSpan, len - t0), st);
+            }
+        }
+        float* os = b.out + (static_cast<size_t>(seq) * b.H + h) * D;
+        const float inv = 1.0f / st.l;
+        for (int d = 0; d < D; ++d) os[d] = acc[d] * inv;
+    }
+}
+
+using SeqFn = void (*)(const DecodeBatch&, int, bool);
+
+template <int D>
+__attribute__((target("avx512f,avx2,fma"))) void decode_seq_avx512(const DecodeBatch& b, int seq, bool paged) {
+    decode_seq<Simd16, D>(b, seq, paged);
+}
+
+template <int D>
+__attribute__((target("avx2,fma"))) void decode_seq_avx2(const DecodeBatch& b, int seq, bool paged) {
+    decode_seq<Simd8, D>(b, seq, paged);
+}
+
+template <int D>
+void decode_seq_generic(const DecodeBatch& b, int seq, bool paged) {
+    decode_seq<Simd8, D>(b, seq, paged);
+}
+
+template <int D>
+static SeqFn pick_seq(Isa isa) {
+    return simd::pick<SeqFn>(isa, decode_seq_avx512<D>, decode_seq_avx2<D>, decode_seq_generic<D>);
+}
+
+// 线程以序列为单位从计数器领工作；长序列排在前面（调用方按长度降序给出 order）
+static void decode_attention(const DecodeBatch& b, bool paged, Isa isa, int threads, const std::vector<int>& order) {
+    SeqFn fn = nullptr;
+    if (b.D == 64) fn = pick_seq<64>(isa);
+    else if (b.D == 128) fn = pick_seq<128>(isa);
+    else {
+        std::fprintf(stderr, "head_dim D=%d not supported (64 or 128)\n", b.D);
+        std::exit(1);
+    }
+    threads = std::max(1, std::min(threads, b.numSeqs));
+    std::atomic<int> next{0};
+    auto worker = [&] {
+        for (int i; (i = next.fetch_add(1, std::memory_order_relaxed)) < b.numSeqs;) fn(b, order[i], paged);
+    };
+    std::vector<std::thread> team;
+    for (int t = 1; t < threads; ++t) team.emplace_back(worker);
+    worker();
+    for (auto& th : team) th.join();
+}
+
+// ================= 2. KV 数据：连续布局 + 分页布局 =================
+
+struct Workload {
+    int numSeqs, H, D, maxLen;
+    std::vector<int> lens, order;
+    std::vector<float> q, kContig, vContig;
+};
+
+static Workload make_workload(int numSeqs, int H, int D, int minLen, int maxLen, uint32_t seed) {
+    Workload w{numSeqs, H, D, maxLen, {}, {}, {}, {}, {}};
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> lenDist(minLen, maxLen);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    for (int s = 0; s < numSeqs; ++s) w.lens.push_back(lenDist(rng));
+    w.order.resize(numSeqs);
+    std::iota(w.order.begin(), w.order.end(), 0);
+    std::stable_sort(w.order.begin(), w.order.end(), [&](int a, int b) { return w.lens[a] > w.lens[b]; });
+    w.q.resize(static_cast<size_t>(numSeqs) * H * D);
+    for (auto& x : w.q) x = dist(rng);
+    const size_t kvElems = static_cast<size_t>(numSeqs) * H * maxLen * D;
+    w.kContig.assign(kvElems, 0.0f);
+    w.vContig.assign(kvElems, 0.0f);
+    for (int s = 0; s < numSeqs; ++s)
+        for (int h = 0; h < H; ++h) {
+            const size_t off = (static_cast<size_t>(s) * H + h) * maxLen * D;
+            for (size_t x = 0; x < static_cast<size_t>(w.lens[s]) * D; ++x) {
+                w.kContig[off + x] = dist(rng);
+                w.vContig[off + x] = dist(rng);
+            }
+        }
+    return w;
+}
+
+struct PagedCache {
+    int blockSize = 0, numBlocks = 0, maxBlocksPerSeq = 0;
+    std::vector<int> blockTables;
+    std::vector<float> k, v;
+};
+
+// 块分配器：空闲链表默认打乱，同一序列的相邻逻辑块落在池子里不相邻的位置
+static PagedCache build_paged(const Workload& w, int blockSize, bool shuffle, uint32_t seed) {
+    PagedCache pc;
+    pc.blockSize = blockSize;
+    for (int len : w.lens) {
+        const int nb = (len + blockSize - 1) / blockSize;
+        pc.numBlocks += nb;
+        pc.maxBlocksPerSeq = std::max(pc.maxBlocksPerSeq, nb);
+    }
+    std::vector<int> freeList(pc.numBlocks);
+    std::iota(freeList.begin(), freeList.end(), 0);
+    if (shuffle) std::shuffle(freeList.begin(), freeList.end(), std::mt19937(seed));
+
+    const size_t blockElems = static_cast<size_t>(w.H) * blockSize * w.D;
+    pc.k.assign(pc.numBlocks * blockElems, 0.0f);
+    pc.v.assign(pc.numBlocks * blockElems, 0.0f);
+    pc.blockTables.assign(static_cast<size_t>(w.numSeqs) * pc.maxBlocksPerSeq, -1);
+    size_t nextFree = 0;
+    for (int s = 0; s < w.numSeqs; ++s) {
+        for (int t0 = 0, i = 0; t0 < w.lens[s]; t0 += blockSize, ++i) {
+            const int phys = freeList[nextFree++];
+            pc.blockTables[static_cast<size_t>(s) * pc.maxBlocksPerSeq + i] = phys;
+            const int n = std::min(blockSize, w.lens[s] - t0);
+            // 相当于 reshape_and_cache：把这一块 token 的 K/V 按 slot 写进物理块
+            for (int h = 0; h < w.H; ++h) {
+                const size_t src = ((static_cast<size_t>(s) * w.H + h) * w.maxLen + t0) * w.D;
+                const size_t dst = phys * blockElems + static_cast<size_t>(h) * blockSize * w.D;
+                std::copy_n(&w.kContig[src], static_cast<size_t>(n) * w.D, &pc.k[dst]);
+                std::copy_n(&w.vContig[src], static_cast<size_t>(n) * w.D, &pc.v[dst]);
+            }
+        }
+    }
+    return pc;
+}
+
+static DecodeBatch make_batch(const Workload& w, float* out) {
+    DecodeBatch b;
+    b.numSeqs = w.numSeqs;
+    b.H = w.H;
+    b.D = w.D;
+    b.scale = 1.0f / std::sqrt(static_cast<float>(w.D));
+    b.q = w.q.data();
+    b.out = out;
+    b.contextLens = w.lens.data();
+    b.kContig = w.kContig.data();
+    b.vContig = w.vContig.data();
+    b.maxLen = w.maxLen;
+    return b;
+}
+
+static void attach_paged(DecodeBatch& b, const PagedCache& pc) {
+    b.kCache = pc.k.data();
+    b.vCache = pc.v.data();
+    b.blockTables = pc.blockTables.data();
+    b.maxBlocksPerSeq = pc.maxBlocksPerSeq;
+    b.blockSize = pc.blockSize;
+}
+
+// 按定义用 double 算全部输出（从连续布局读）
+static std::vector<float> reference_decode(const Workload& w) {
+    std::vector<float> out(w.q.size());
+    const double scale = 1.0 / std::sqrt(static_cast<double>(w.D));
+    for (int s = 0; s < w.numSeqs; ++s)
+        for (int h = 0; h < w.H; ++h) {
+            const float* q = &w.q[(static_cast<size_t>(s) * w.H + h) * w.D];
+            const size_t off = (static_cast<size_t>(s) * w.H + h) * w.maxLen * w.D;
+            const int n = w.lens[s];
+            std::vector<double> sc(n);
+            double mx = -std::numeric_limits<double>::infinity();
+            for (int j = 0; j < n; ++j) {
+                double dot = 0;
+                for (int d = 0; d < w.D; ++d) dot += static_cast<double>(q[d]) * w.kContig[off + j * w.D + d];
+                sc[j] = dot * scale;
+                mx = std::max(mx, sc[j]);
+            }
+            double sum = 0;
+            for (double& x : sc) sum += (x = std::exp(x - mx));
+            for (int d = 0; d < w.D; ++d) {
+                double o = 0;
+                for (int j = 0; j < n; ++j) o += sc[j] * w.vContig[off + j * w.D + d];
+                out[(static_cast<size_t>(s) * w.H + h) * w.D + d] = static_cast<float>(o / sum);
+            }
+        }
+    return out;
+}
+
+static const verify::Tolerance kTol{1e-5, 1e-4, -1};
+
+// ================= 3. 正确性 demo =================
+
+static bool run_demo() {
+    bool ok = true;
+    const int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const std::vector<Isa> isas = simd::available_isas();
+    for (int D : {64, 128}) {
+        // 长度 1..300：覆盖只有 1 个 token、不足一块、恰好整块、多块加尾块
+        Workload w = make_workload(9, 4, D, 1, 300, 3);
+        w.lens[0] = 1;
+        w.lens[1] = 16;
+        w.lens[2] = 128;
+        std::vector<float> ref = reference_decode(w);
+        std::vector<float> out(w.q.size());
+        DecodeBatch b = make_batch(w, out.data());
+        for (Isa isa : isas) {
+            decode_attention(b, false, isa, threads, w.order);
+            verify::Report r = verify::compare(out.data(), ref.data(), ref.size(), kTol);
+            std::printf("%s D=%-3d %-7s contiguous       max_abs_err=%.2e\n", r.ok ? "✅" : "❌", D, simd::isa_name(isa),
+                        r.maxAbs);
+            if (!r.ok) verify::print(r, "contiguous vs reference");
+            ok &= r.ok;
+            for (int bs : {16, 64, 128}) {
+                PagedCache pc = build_paged(w, bs, true, 5);
+                attach_paged(b, pc);
+                std::fill(out.begin(), out.end(), 0.0f);
+                decode_attention(b, true, isa, threads, w.order);
+                r = verify::compare(out.data(), ref.data(), ref.size(), kTol);
+                std::printf("%s D=%-3d %-7s paged block=%-4d max_abs_err=%.2e\n", r.ok ? "✅" : "❌", D,
+                            simd::isa_name(isa), bs, r.maxAbs);
+                if (!r.ok) verify::print(r, "paged vs reference");
+                ok &= r.ok;
+            }
+        }
+    }
+    return ok;
+}
+
+// ================= 4. benchmark：分页 vs 连续 =================
+
+struct BenchOptions {
+    int numSeqs = 32, H = 16, D = 128, ctx = 1024;
+    bool shuffle = true;
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int iters = 5;
+    int rounds = 7;
+};
+
+static double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    const size_t n = v.size();
+    return n % 2 ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+// 一次采样：预热一次，再取 iters 次里最快的
+static double time_ms(const DecodeBatch& b, bool paged, Isa isa, const BenchOptions& opt, const std::vector<int>& order) {
+    decode_attention(b, paged, isa, opt.threads, order);  // 预热
+    double best = 1e30;
+    for (int i = 0; i < opt.iters; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        decode_attention(b, paged, isa, opt.threads, order);
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count());
+    }
+    return best;
+}
+
+static void run_benchmark(const BenchOptions& opt) {
+    const Isa isa = simd::best_isa();
+    // context 长度在 [ctx/2, ctx] 均匀分布，像一批进度不同的请求
+    Workload w = make_workload(opt.numSeqs, opt.H, opt.D, std::max(1, opt.ctx / 2), opt.ctx, 17);
+    long long tokens = 0;
+    for (int len : w.lens) tokens += len;
+    const double kvBytes = 2.0 * tokens * opt.H * opt.D * sizeof(float);
+    std::printf("seqs=%d H=%d D=%d context=[%d, %d] (avg %.0f) threads=%d isa=%s free_list=%s\n", opt.numSeqs, opt.H,
+                opt.D, std::max(1, opt.ctx / 2), opt.ctx, static_cast<double>(tokens) / opt.numSeqs, opt.threads,
+                simd::isa_name(isa), opt.shuffle ? "shuffled" : "in-order");
+    std::printf("KV read per decode step: %.1f MB\n", kvBytes / 1e6);
+
+    // 连续和分页轮流测 rounds 轮，每轮算一个 分页/连续 的比值，报告比值的中位数和范围：
+    // 只测一次连续当分母的话，机器状态（频率、别的进程、页缓存）一变，overhead 能从 -50% 跳到 +50%
+    std::printf("%d rounds x best of %d, contiguous and paged interleaved; time = median, overhead = median ratio "
+                "[min, max]\n",
+                opt.rounds, opt.iters);
+    std::vector<float> out(w.q.size()), outContig(w.q.size());
+    DecodeBatch b = make_batch(w, outContig.data());
+    auto print_row = [&](const char* name, double ms) {
+        // 每一步 decode 给每个序列产出 1 个 token
+        std::printf("  %-18s time=%8.3f ms  tokens/s=%9.0f  kv_bw=%6.2f GB/s", name, ms, opt.numSeqs / (ms * 1e-3),
+                    kvBytes / (ms * 1e-3) / 1e9);
+    };
+
+    for (int bs : {16, 64, 128}) {
+        PagedCache pc = build_paged(w, bs, opt.shuffle, 23);
+        attach_paged(b, pc);
+        std::vector<double> contigMs, pagedMs, ratio;
+        for (int round = 0; round < opt.rounds; ++round) {
+            // 先后顺序每轮交换，抵消“后测的那个总是更热 / 更冷”
+            double ms[2];
+            for (int k = 0; k < 2; ++k) {
+                const bool paged = (k == 0) == (round % 2 == 1);
+                b.out = paged ? out.data() : outContig.data();
+                ms[paged] = time_ms(b, paged, isa, opt, w.order);
+            }
+            contigMs.push_back(ms[0]);
+            pagedMs.push_back(ms[1]);
+            ratio.push_back(ms[1] / ms[0]);
+        }
+        const auto [lo, hi] = std::minmax_element(ratio.begin(), ratio.end());
+        const double rmin = *lo, rmax = *hi;
+        verify::Report r = verify::compare(out.data(), outContig.data(), out.size(), kTol);
+        char name[32];
+        std::snprintf(name, sizeof(name), "contiguous (bs=%d)", bs);
+        print_row(name, median(contigMs));
+        std::printf("\n");
+        std::snprintf(name, sizeof(name), "paged block=%d", bs);
+        print_row(name, median(pagedMs));
+        std::printf("  overhead=%+6.1f%% [%+.1f%%, %+.1f%%]  %s\n", (median(ratio) - 1.0) * 100.0, (rmin - 1.0) * 100.0,
+                    (rmax - 1.0) * 100.0, r.ok ? "✅" : "❌");
+        if (!r.ok) verify::print(r, "paged vs contiguous");
+    }
+}
+
+// ================= 主函数 =================
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && std::strcmp(argv[1], "bench") == 0) {
+        BenchOptions opt;
+        for (int i = 2; i < argc; ++i) {
+            std::string a = argv[i];
+            auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : "0"; };
+            if (a == "--seqs") opt.numSeqs = std::max(1, std::atoi(next()));
+            else if (a == "--heads") opt.H = std::max(1, std::atoi(next()));
+            else if (a == "--dim") opt.D = std::atoi(next());
+            else if (a == "--ctx") opt.ctx = std::max(1, std::atoi(next()));
+            else if (a == "--threads") opt.threads = std::max(1, std::atoi(next()));
+            else if (a == "--iters") opt.iters = std::max(1, std::atoi(next()));
+            else if (a == "--rounds") opt.rounds = std::max(1, std::atoi(next()));
+            else if (a == "--no-shuffle") opt.shuffle = false;
+            else {
+                std::fprintf(stderr,
+                             "Usage: %s bench [--seqs N] [--ctx MAX_LEN] [--heads H] [--dim 64|128] [--threads T] "
+                             "[--iters K] [--rounds R] [--no-shuffle]\n",
+                             argv[0]);
+                return 1;
+            }
+        }
+        if (opt.D != 64 && opt.D != 128) {
+            std::fprintf(stderr, "--dim must be 64 or 128\n");
+            return 1;
+        }
+        run_benchmark(opt);
+        return 0;
+    }
+    return run_demo() ? 0 : 1;
+}
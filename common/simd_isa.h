@@ -0,0 +1,140 @@
+#pragma once
+
+// CPU attention kernel 的 SIMD 基础（header-only），供 2026_0115/code_learning/mha_cpu.cpp 和
+// 2026_0318/paged_decode_attention.cpp 共用。
+//
+//   - Simd<VF, VI>：GCC 向量扩展上的 load / store / set1 / vmax / hmax / hsum / exp。
+//     kernel 写一份 template <class Ops>，在 target("avx512f") 的函数里内联就是 zmm 指令，
+//     在 target("avx2,fma") 里就是 ymm + vfmadd，在不带 target 的函数里由编译器拆成 SSE
+//   - Isa / isa_name / best_isa / available_isas / pick：运行时按 CPU 选 AVX-512 / AVX2+FMA / 通用实例
+//
+// 用法：
+//   template <class Ops> __attribute__((always_inline)) inline void kernel(...) { ... Ops::load(p) ... }
+//   __attribute__((target("avx512f,avx2,fma"))) void kernel_avx512(...) { kernel<simd::Simd16>(...); }
+//   __attribute__((target("avx2,fma"))) void kernel_avx2(...) { kernel<simd::Simd8>(...); }
+//   void kernel_generic(...) { kernel<simd::Simd8>(...); }
+//   auto fn = simd::pick(simd::best_isa(), kernel_avx512, kernel_avx2, kernel_generic);
+//
+// -Wpsabi：kernel 里到处按值传递和返回 32/64 字节的向量，在没开 AVX 的上下文里 GCC 会提示“这会改变 ABI”。
+// 这里的函数全部 always_inline、kernel 本身也要求 always_inline，不存在真正按值传向量的调用，
+// 所以包含本头文件的翻译单元里这条提示保持关闭（不 pop：提示出现在 kernel 的调用点上，不在本文件里）。
+// 参数一律按 const 引用传：按值传参触发的是另一条“GCC 4.6 起 32 字节对齐参数的 ABI 变了”的 note，pragma 压不住。
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+#define SIMD_INLINE __attribute__((always_inline)) static inline
+
+namespace simd {
+
+// ================= 1. 向量操作 =================
+
+typedef float v8f __attribute__((vector_size(32)));
+typedef int32_t v8i __attribute__((vector_size(32)));
+typedef float v16f __attribute__((vector_size(64)));
+typedef int32_t v16i __attribute__((vector_size(64)));
+
+template <class VF, class VI>
+struct Simd {
+    static constexpr int W = sizeof(VF) / sizeof(float);
+
+    SIMD_INLINE VF load(const float* p) {
+        VF v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    SIMD_INLINE void store(float* p, const VF& v) { std::memcpy(p, &v, sizeof(v)); }
+    SIMD_INLINE VF set1(float x) { return VF{} + x; }
+    SIMD_INLINE VF vmax(const VF& a, const VF& b) { return a > b ? a : b; }
+
+    SIMD_INLINE float hmax(const VF& v) {
+        float m = v[0];
+        for (int i = 1; i < W; ++i) m = std::max(m, v[i]);
+        return m;
+    }
+    SIMD_INLINE float hsum(const VF& v) {
+        float s = 0;
+        for (int i = 0; i < W; ++i) s += v[i];
+        return s;
+    }
+
+    // exp(x)：x = n*ln2 + r，|r| <= ln2/2，e^r 用 Cephes expf 的 6 次多项式，2^n 直接拼进指数位。
+    // 相对误差 ~1e-7；x 小于 -87.3（包括 -inf，即被 mask 掉的分数）返回精确的 0
+    SIMD_INLINE VF exp(const VF& in) {
+        VF x = in;
+        const VF lo = set1(-87.3365447504f), hi = set1(88.3762626647949f);
+        VI under = x < lo;
+        x = x < lo ? lo : x;
+        x = x > hi ? hi : x;
+        VF t = x * 1.44269504088896341f + 0.5f;
+        VI n = __builtin_convertvector(t, VI);  // 向零截断
+        VF nf = __builtin_convertvector(n, VF);
+        VI fix = nf > t;                        // 负数要再减 1 才是 floor
+        n = n + fix;
+        nf = __builtin_convertvector(n, VF);
+        VF r = x - nf * 0.693359375f + nf * 2.12194440e-4f;
+        VF p = set1(1.9875691500E-4f);
+        p = p * r + 1.3981999507E-3f;
+        p = p * r + 8.3334519073E-3f;
+        p = p * r + 4.1665795894E-2f;
+        p = p * r + 1.6666665459E-1f;
+        p = p * r + 5.0000001201E-1f;
+        VF y = p * r * r + r + 1.0f;
+        VI bits = (n + 127) << 23;
+        VF pow2;
+        std::memcpy(&pow2, &bits, sizeof(pow2));
+        VF res = y * pow2;
+        VI keep = ~under;
+        VI rb;
+        std::memcpy(&rb, &res, sizeof(rb));
+        rb &= keep;
+        std::memcpy(&res, &rb, sizeof(res));
+        return res;
+    }
+};
+
+using Simd8 = Simd<v8f, v8i>;
+using Simd16 = Simd<v16f, v16i>;
+
+// ================= 2. 运行时分派 =================
+
+enum class Isa { Generic, Avx2, Avx512 };
+
+inline const char* isa_name(Isa isa) {
+    return isa == Isa::Avx512 ? "avx512" : isa == Isa::Avx2 ? "avx2" : "generic";
+}
+
+inline Isa best_isa() {
+#if defined(__x86_64__) || defined(__i386__)
+    if (__builtin_cpu_supports("avx512f")) return Isa::Avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return Isa::Avx2;
+#endif
+    return Isa::Generic;
+}
+
+// 本机能跑的全部实例，正确性 demo 逐个对照参考值
+inline std::vector<Isa> available_isas() {
+    std::vector<Isa> isas = {Isa::Generic};
+#if defined(__x86_64__) || defined(__i386__)
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) isas.push_back(Isa::Avx2);
+    if (__builtin_cpu_supports("avx512f")) isas.push_back(Isa::Avx512);
+#endif
+    return isas;
+}
+
+template <class Fn>
+Fn pick(Isa isa, Fn avx512, Fn avx2, Fn generic) {
+    switch (isa) {
+        case Isa::Avx512: return avx512;
+        case Isa::Avx2: return avx2;
+        default: return generic;
+    }
+}
+
+}  // namespace simd
+
+#undef SIMD_INLINE
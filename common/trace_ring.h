@@ -0,0 +1,198 @@
+#pragma once
+
+// 算法 demo 用的轻量追踪（header-only），供 2025_0921/134.cpp 和 2026_0227/leetcode 各题的热点解法共用。
+//
+// 两道开关：
+//   - 编译期：TRACE_COMPILED=0（默认）时 TRACE_EVENT 展开成空语句，参数不求值，生成的代码与没写一样
+//   - 运行期：TRACE_COMPILED=1 时每个追踪点只多一次 relaxed 原子读 + 一个预测为不跳转的分支；
+//             环境变量 TRACE=1 或 trace::setEnabled(true) 打开后才真正记录
+// 记录不是文本：每条是 32 字节的二进制 Record（时间戳、事件名指针、两个整数参数），
+// 写进当前线程自己的环形缓冲区（单写者，只有一次 release store，没有锁、没有 iostream、不分配内存），
+// 写满后覆盖最旧的记录。事件名必须是字符串字面量（只存指针）。
+//
+// 用法：
+//   #define TRACE_COMPILED 1          // 或 -DTRACE_COMPILED=1，在 include 之前
+//   #include "../../common/trace_ring.h"
+//   TRACE_EVENT("gas.reset", i, tank);
+//   ...
+//   trace::dumpText(std::cout, 20);   // 被追踪的线程跑完之后再导出
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifndef TRACE_COMPILED
+#define TRACE_COMPILED 0
+#endif
+
+namespace trace {
+
+struct Record {
+    uint64_t ts;       // x86 上是 TSC 周期数，其它平台是 steady_clock 纳秒
+    const char* name;  // 字符串字面量
+    int64_t a;
+    int64_t b;
+};
+
+struct ThreadRecord {
+    uint32_t thread;  // 线程登记的先后序号
+    Record rec;
+};
+
+inline uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// ================= 1. 单线程环形缓冲区 =================
+
+class Ring {
+public:
+    // 下标靠 & mask_ 回绕，容量向上取整到 2 的幂
+    Ring(uint32_t thread, size_t capacity)
+        : thread_(thread), mask_(roundUpPow2(capacity) - 1), slots_(mask_ + 1) {}
+
+    static uint64_t roundUpPow2(size_t n) {
+        uint64_t cap = 1;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+
+    // 仅所属线程调用
+    void push(const char* name, int64_t a, int64_t b) noexcept {
+        uint64_t h = head_.load(std::memory_order_relaxed);
+        slots_[h & mask_] = Record{now(), name, a, b};
+        head_.store(h + 1, std::memory_order_release);
+    }
+
+    // 导出时调用：复制还没被覆盖的记录。复制完再读一次 head，把复制期间可能被覆盖的最旧部分丢掉
+    void copyTo(std::vector<ThreadRecord>& out) const {
+        uint64_t h = head_.load(std::memory_order_acquire);
+        uint64_t cap = mask_ + 1;
+        uint64_t first = std::max(h > cap ? h - cap : 0, std::min(floor_.load(std::memory_order_acquire), h));
+        size_t base = out.size();
+        for (uint64_t i = first; i < h; ++i) out.push_back({thread_, slots_[i & mask_]});
+        uint64_t h2 = head_.load(std::memory_order_acquire);
+        uint64_t safeFirst = h2 > cap ? h2 - cap : 0;
+        if (safeFirst > first) {
+            size_t drop = static_cast<size_t>(std::min(safeFirst - first, h - first));
+            out.erase(out.begin() + static_cast<std::ptrdiff_t>(base),
+                      out.begin() + static_cast<std::ptrdiff_t>(base + drop));
+        }
+    }
+
+    // 任意线程可调用：head_ 只由所属线程写，清空只是把导出的起点挪到当前 head（之前的记录不再导出）
+    void clear() noexcept { floor_.store(head_.load(std::memory_order_acquire), std::memory_order_release); }
+
+private:
+    const uint32_t thread_;
+    const uint64_t mask_;
+    std::vector<Record> slots_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+    std::atomic<uint64_t> floor_{0};  // clear() 时的 head，导出只从这里开始
+};
+
+// ================= 2. 全局开关与线程登记 =================
+
+namespace detail {
+
+inline bool envEnabled() {
+    const char* v = std::getenv("TRACE");
+    return v && *v && std::strcmp(v, "0") != 0;
+}
+
+inline std::atomic<bool> g_enabled{envEnabled()};
+inline std::mutex g_mutex;
+// 用 shared_ptr 登记：线程退出后它的记录仍然可以导出
+inline std::vector<std::shared_ptr<Ring>> g_rings;
+inline size_t g_ringCapacity = 1 << 16;  // 每线程 64K 条 × 32 字节 = 2MB
+
+// 每个线程第一次记录时登记一个环（只有这一次拿锁）
+inline Ring& localRing() {
+    thread_local Ring* ring = nullptr;
+    if (!ring) {
+        std::lock_guard<std::mutex> lk(g_mutex);
+        g_rings.push_back(std::make_shared<Ring>(static_cast<uint32_t>(g_rings.size()), g_ringCapacity));
+        ring = g_rings.back().get();
+    }
+    return *ring;
+}
+
+}  // namespace detail
+
+inline bool enabled() { return detail::g_enabled.load(std::memory_order_relaxed); }
+inline void setEnabled(bool on) { detail::g_enabled.store(on, std::memory_order_relaxed); }
+
+// 只影响之后才登记的线程；不是 2 的幂时向上取整
+inline void setRingCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lk(detail::g_mutex);
+    detail::g_ringCapacity = static_cast<size_t>(Ring::roundUpPow2(capacity));
+}
+
+// 冷路径：不内联，追踪点处只留下一个函数调用
+__attribute__((noinline)) inline void emit(const char* name, int64_t a, int64_t b) noexcept {
+    detail::localRing().push(name, a, b);
+}
+
+// ================= 3. 导出 =================
+
+// 所有线程的记录按时间戳合并。应在被追踪的线程跑完这一段之后调用
+inline std::vector<ThreadRecord> snapshot() {
+    std::vector<ThreadRecord> out;
+    {
+        std::lock_guard<std::mutex> lk(detail::g_mutex);
+        for (const auto& r : detail::g_rings) r->copyTo(out);
+    }
+    std::stable_sort(out.begin(), out.end(),
+                     [](const ThreadRecord& x, const ThreadRecord& y) { return x.rec.ts < y.rec.ts; });
+    return out;
+}
+
+inline void clear() {
+    std::lock_guard<std::mutex> lk(detail::g_mutex);
+    for (const auto& r : detail::g_rings) r->clear();
+}
+
+// 文本化只发生在导出时；maxRecords 只打印最后这么多条
+inline void dumpText(std::ostream& os, size_t maxRecords = 100) {
+    std::vector<ThreadRecord> recs = snapshot();
+    size_t first = recs.size() > maxRecords ? recs.size() - maxRecords : 0;
+    uint64_t t0 = recs.empty() ? 0 : recs[first].rec.ts;
+    os << "[trace] 共 " << recs.size() << " 条记录，显示最后 " << recs.size() - first << " 条\n";
+    for (size_t i = first; i < recs.size(); ++i) {
+        const ThreadRecord& r = recs[i];
+        os << "  +" << r.rec.ts - t0 << " T" << r.thread << " " << r.rec.name << " a=" << r.rec.a
+           << " b=" << r.rec.b << "\n";
+    }
+}
+
+}  // namespace trace
+
+// sizeof 不求值：编译掉时参数里的表达式不会执行，也不会有“未使用变量”警告
+#if TRACE_COMPILED
+#define TRACE_EVENT(name, a, b)                                                                  \
+    do {                                                                                         \
+        if (__builtin_expect(::trace::enabled(), 0))                                             \
+            ::trace::emit(name, static_cast<int64_t>(a), static_cast<int64_t>(b));               \
+    } while (0)
+#else
+#define TRACE_EVENT(name, a, b) \
+    do {                        \
+        (void)sizeof(a);        \
+        (void)sizeof(b);        \
+    } while (0)
+#endif
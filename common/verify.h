@@ -0,0 +1,307 @@
+#pragma once
+
+// kernel 输出的并行校验（header-only），给 2026_0227/cuda 的 vec_add / 融合 kernel、2026_0115 的 MHA、
+// 2026_0318 的 paged decode attention、2026_0305 的 collectives 等 benchmark 共用。
+// day1 的 check_correct 是单线程、逐元素用 double 算误差，16M 元素时比 kernel 本身还慢；
+// 这里：
+//   - 多线程：按 64K 元素分块，线程从共享计数器领块
+//   - SIMD：AVX2 一次比较 8 个 float，同时归约最大绝对误差、最大相对误差、最大 ULP 距离；
+//           atol/rtol 判定和标量 matches 一样在 double 里做（拆成两组 4×double），两条路径结论逐位一致
+//   - 提前退出：发现不匹配后，下标更大的块不再检查；下标更小的块照常检查完，
+//               所以报告里的 firstBad 一定是全局第一个不匹配的位置
+//   - 参考值可以是现成的数组（compare），也可以按块现算（compareFn，例如 ref = a + b），不需要额外 N 个 float
+// 下标全程 size_t，10 亿元素的输出也能校验。
+//
+// 判定：got == want（含两边都是同号无穷）、两边都是 NaN、|got - want| <= atol + rtol * |want|、
+//       或 ULP 距离 <= maxUlp（maxUlp < 0 表示不用 ULP 判定），满足任一条就算匹配。
+//
+// 用法：
+//   verify::Report r = verify::compare(out, ref, n, {1e-5, 0});
+//   verify::Report r = verify::compareFn(c, n, [&](size_t lo, size_t len, float* dst) {
+//       for (size_t i = 0; i < len; ++i) dst[i] = a[lo + i] + b[lo + i];
+//   });
+//   verify::print(r, "vec_add");   // "Correctness OK. ..." 或第一个不匹配的位置
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <vector>
+
+// nvcc 编译的 .cu 里走标量路径（仍然多线程），避免 target 属性和 intrinsics 经过 nvcc 前端
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(__CUDACC__)
+#define VERIFY_HAVE_AVX2 1
+#include <immintrin.h>
+#else
+#define VERIFY_HAVE_AVX2 0
+#endif
+
+namespace verify {
+
+struct Tolerance {
+    double atol = 1e-5;
+    double rtol = 0.0;
+    int64_t maxUlp = -1;
+};
+
+struct Options {
+    int threads = 0;         // 0 = 全部硬件线程
+    bool earlyExit = true;   // 发现不匹配后尽快停
+};
+
+struct Report {
+    bool ok = true;
+    size_t n = 0;
+    size_t checked = 0;                  // 实际检查过的元素数（提前退出时 < n）
+    double maxAbs = 0.0;
+    double maxRel = 0.0;
+    int64_t maxUlp = 0;
+    size_t firstBad = SIZE_MAX;          // 第一个不匹配的下标
+    float got = 0.0f, want = 0.0f;       // 该位置的两个值
+};
+
+// ================= 1. 单块检查（标量 / AVX2） =================
+
+// 把 float 的位模式映射成单调的整数：相邻的 float 映射后相差 1，两数映射值之差就是 ULP 距离
+inline int32_t orderedBits(float f) {
+    int32_t i;
+    std::memcpy(&i, &f, sizeof(i));
+    return i < 0 ? static_cast<int32_t>(0x80000000u - static_cast<uint32_t>(i)) : i;
+}
+
+inline uint32_t ulpDistance(float a, float b) {
+    int32_t x = orderedBits(a), y = orderedBits(b);
+    return x > y ? static_cast<uint32_t>(x) - static_cast<uint32_t>(y)
+                 : static_cast<uint32_t>(y) - static_cast<uint32_t>(x);
+}
+
+struct BlockResult {
+    float maxAbs = 0.0f;
+    float maxRel = 0.0f;
+    uint32_t maxUlp = 0;
+    size_t firstBad = SIZE_MAX;  // 块内偏移
+};
+
+inline bool matches(float g, float w, const Tolerance& tol) {
+    if (g == w) return true;
+    if (std::isnan(g) && std::isnan(w)) return true;
+    double err = std::fabs(static_cast<double>(g) - static_cast<double>(w));
+    if (err <= tol.atol + tol.rtol * std::fabs(static_cast<double>(w))) return true;
+    return tol.maxUlp >= 0 && static_cast<int64_t>(ulpDistance(g, w)) <= tol.maxUlp;
+}
+
+// 误差统计忽略 NaN / 无穷（它们已经按上面的规则判定过了）
+inline void accumulate(BlockResult& r, float g, float w) {
+    float err = std::fabs(g - w);
+    if (!(err <= std::numeric_limits<float>::max())) return;
+    r.maxAbs = std::max(r.maxAbs, err);
+    r.maxRel = std::max(r.maxRel, err / std::max(std::fabs(w), std::numeric_limits<float>::min()));
+    r.maxUlp = std::max(r.maxUlp, ulpDistance(g, w));
+}
+
+inline BlockResult checkBlockScalar(const float* got, const float* want, size_t len, const Tolerance& tol) {
+    BlockResult r;
+    for (size_t i = 0; i < len; ++i) {
+        accumulate(r, got[i], want[i]);
+        if (r.firstBad == SIZE_MAX && !matches(got[i], want[i], tol)) r.firstBad = i;
+    }
+    return r;
+}
+
+#if VERIFY_HAVE_AVX2
+
+// 4 个 lane 的 |g - w| <= atol + rtol * |w|，返回 4 位掩码。float 的差和阈值都会舍入，
+// 边界附近会放过 matches 拒绝的值，所以和 matches 一样转成 double 再算
+__attribute__((target("avx2"))) inline int withinTol4(const float* got, const float* want, const Tolerance& tol) {
+    const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffll));
+    __m256d g = _mm256_cvtps_pd(_mm_loadu_ps(got)), w = _mm256_cvtps_pd(_mm_loadu_ps(want));
+    __m256d err = _mm256_and_pd(_mm256_sub_pd(g, w), absMask);
+    __m256d thr =
+        _mm256_add_pd(_mm256_set1_pd(tol.atol), _mm256_mul_pd(_mm256_set1_pd(tol.rtol), _mm256_and_pd(w, absMask)));
+    return _mm256_movemask_pd(_mm256_cmp_pd(err, thr, _CMP_LE_OQ));
+}
+
+__attribute__((target("avx2"))) inline BlockResult checkBlockAvx2(const float* got, const float* want, size_t len,
+                                                                  const Tolerance& tol) {
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 fmax = _mm256_set1_ps(std::numeric_limits<float>::max());
+    const __m256 fmin = _mm256_set1_ps(std::numeric_limits<float>::min());
+    const __m256i signBit = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+    const bool useUlp = tol.maxUlp >= 0;
+    // ULP 阈值按无符号比较：先都异或符号位，再用有符号比较
+    const __m256i ulpLimit = _mm256_set1_epi32(static_cast<int>(
+        static_cast<uint32_t>(std::min<int64_t>(useUlp ? tol.maxUlp : 0, UINT32_MAX)) ^ 0x80000000u));
+
+    __m256 vAbs = _mm256_setzero_ps(), vRel = _mm256_setzero_ps();
+    __m256i vUlp = _mm256_setzero_si256();
+    BlockResult r;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        __m256 g = _mm256_loadu_ps(got + i);
+        __m256 w = _mm256_loadu_ps(want + i);
+        __m256 err = _mm256_and_ps(_mm256_sub_ps(g, w), absMask);
+        __m256 absW = _mm256_and_ps(w, absMask);
+
+        // 有序整数映射：负数 x -> 0x80000000 - x
+        __m256i gi = _mm256_castps_si256(g), wi = _mm256_castps_si256(w);
+        __m256i go = _mm256_blendv_epi8(gi, _mm256_sub_epi32(signBit, gi), _mm256_srai_epi32(gi, 31));
+        __m256i wo = _mm256_blendv_epi8(wi, _mm256_sub_epi32(signBit, wi), _mm256_srai_epi32(wi, 31));
+        __m256i ulp = _mm256_sub_epi32(_mm256_max_epi32(go, wo), _mm256_min_epi32(go, wo));
+
+        // 统计只看有限的误差（NaN 比较为假，inf > fmax）
+        __m256 finite = _mm256_cmp_ps(err, fmax, _CMP_LE_OQ);
+        vAbs = _mm256_max_ps(vAbs, _mm256_and_ps(err, finite));
+        vRel = _mm256_max_ps(vRel, _mm256_and_ps(_mm256_div_ps(err, _mm256_max_ps(absW, fmin)), finite));
+        vUlp = _mm256_max_epu32(vUlp, _mm256_and_si256(ulp, _mm256_castps_si256(finite)));
+
+        __m256 ok = _mm256_or_ps(_mm256_cmp_ps(g, w, _CMP_EQ_OQ),
+                                 _mm256_and_ps(_mm256_cmp_ps(g, g, _CMP_UNORD_Q), _mm256_cmp_ps(w, w, _CMP_UNORD_Q)));
+        int okBits = withinTol4(got + i, want + i, tol) | withinTol4(got + i + 4, want + i + 4, tol) << 4;
+        if (useUlp) {
+            __m256i over = _mm256_cmpgt_epi32(_mm256_xor_si256(ulp, signBit), ulpLimit);
+            ok = _mm256_or_ps(ok, _mm256_castsi256_ps(_mm256_xor_si256(over, _mm256_set1_epi32(-1))));
+        }
+        int bad = ~(_mm256_movemask_ps(ok) | okBits) & 0xff;
+        if (bad && r.firstBad == SIZE_MAX) r.firstBad = i + __builtin_ctz(bad);
+    }
+
+    alignas(32) float a[8], rel[8];
+    alignas(32) uint32_t u[8];
+    _mm256_store_ps(a, vAbs);
+    _mm256_store_ps(rel, vRel);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(u), vUlp);
+    for (int k = 0; k < 8; ++k) {
+        r.maxAbs = std::max(r.maxAbs, a[k]);
+        r.maxRel = std::max(r.maxRel, rel[k]);
+        r.maxUlp = std::max(r.maxUlp, u[k]);
+    }
+    for (; i < len; ++i) {
+        accumulate(r, got[i], want[i]);
+        if (r.firstBad == SIZE_MAX && !matches(got[i], want[i], tol)) r.firstBad = i;
+    }
+    return r;
+}
+
+inline bool hasAvx2() {
+    static const bool ok = __builtin_cpu_supports("avx2");
+    return ok;
+}
+#endif
+
+inline BlockResult checkBlock(const float* got, const float* want, size_t len, const Tolerance& tol) {
+#if VERIFY_HAVE_AVX2
+    if (hasAvx2()) return checkBlockAvx2(got, want, len, tol);
+#endif
+    return checkBlockScalar(got, want, len, tol);
+}
+
+// ================= 2. 并行驱动 =================
+
+constexpr size_t kBlock = 1 << 16;  // 64K 个 float = 256KB，参考值缓冲区放得进 L2
+
+// refBlock(lo, len, dst)：把参考值 [lo, lo+len) 写进 dst；传 nullptr 时 want 直接是参考数组
+template <class RefBlock>
+Report run(const float* got, const float* want, size_t n, const Tolerance& tol, const Options& opt,
+           const RefBlock* refBlock) {
+    const size_t nblocks = (n + kBlock - 1) / kBlock;
+    int threads = opt.threads > 0 ? opt.threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    threads = static_cast<int>(std::min<size_t>(threads, std::max<size_t>(1, nblocks / 4)));
+
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> firstBad{SIZE_MAX};
+    std::vector<Report> partial(threads);
+
+    auto worker = [&](int t) {
+        Report& p = partial[t];
+        std::vector<float> buf(refBlock ? kBlock : 0);
+        for (size_t b; (b = next.fetch_add(1, std::memory_order_relaxed)) < nblocks;) {
+            size_t lo = b * kBlock;
+            // 已经有更靠前的不匹配，这一块检查了也不会改变结论
+            if (opt.earlyExit && lo > firstBad.load(std::memory_order_relaxed)) break;
+            size_t len = std::min(kBlock, n - lo);
+            const float* w = want + lo;
+            if (refBlock) {
+                (*refBlock)(lo, len, buf.data());
+                w = buf.data();
+            }
+            BlockResult r = checkBlock(got + lo, w, len, tol);
+            p.checked += len;
+            p.maxAbs = std::max<double>(p.maxAbs, r.maxAbs);
+            p.maxRel = std::max<double>(p.maxRel, r.maxRel);
+            p.maxUlp = std::max<int64_t>(p.maxUlp, r.maxUlp);
+            if (r.firstBad != SIZE_MAX) {
+                size_t idx = lo + r.firstBad;
+                if (idx < p.firstBad) {
+                    p.firstBad = idx;
+                    p.got = got[idx];
+                    p.want = w[r.firstBad];
+                }
+                size_t cur = firstBad.load(std::memory_order_relaxed);
+                while (idx < cur && !firstBad.compare_exchange_weak(cur, idx, std::memory_order_relaxed)) {
+                }
+            }
+        }
+    };
+
+    if (threads == 1) {
+        worker(0);
+    } else {
+        std::vector<std::thread> team;
+        for (int t = 1; t < threads; ++t) team.emplace_back(worker, t);
+        worker(0);
+        for (auto& th : team) th.join();
+    }
+
+    Report out;
+    out.n = n;
+    for (const Report& p : partial) {
+        out.checked += p.checked;
+        out.maxAbs = std::max(out.maxAbs, p.maxAbs);
+        out.maxRel = std::max(out.maxRel, p.maxRel);
+        out.maxUlp = std::max(out.maxUlp, p.maxUlp);
+        if (p.firstBad < out.firstBad) {
+            out.firstBad = p.firstBad;
+            out.got = p.got;
+            out.want = p.want;
+        }
+    }
+    out.ok = out.firstBad == SIZE_MAX;
+    return out;
+}
+
+// ================= 3. 入口 =================
+
+inline Report compare(const float* got, const float* want, size_t n, const Tolerance& tol = {},
+                      const Options& opt = {}) {
+    struct None {
+        void operator()(size_t, size_t, float*) const {}
+    };
+    return run<None>(got, want, n, tol, opt, nullptr);
+}
+
+// 参考值按块现算：refBlock(lo, len, dst) 填 dst[0..len)，在工作线程里并行调用
+template <class RefBlock>
+Report compareFn(const float* got, size_t n, const RefBlock& refBlock, const Tolerance& tol = {},
+                 const Options& opt = {}) {
+    return run<RefBlock>(got, nullptr, n, tol, opt, &refBlock);
+}
+
+// 与 day1 check_correct 相同的输出格式：成功打印到 stdout，失败打印到 stderr
+inline bool print(const Report& r, const char* what = nullptr) {
+    const char* sep = what ? "] " : "";
+    if (r.ok) {
+        std::printf("%s%s%sCorrectness OK. max_abs_err=%g max_rel_err=%g max_ulp=%lld\n", what ? "[" : "",
+                    what ? what : "", sep, r.maxAbs, r.maxRel, static_cast<long long>(r.maxUlp));
+    } else {
+        std::fprintf(stderr, "%s%s%sMismatch at i=%zu: got=%f ref=%f err=%g (checked %zu of %zu)\n", what ? "[" : "",
+                     what ? what : "", sep, r.firstBad, r.got, r.want,
+                     std::fabs(static_cast<double>(r.got) - static_cast<double>(r.want)), r.checked, r.n);
+    }
+    return r.ok;
+}
+
+}  // namespace verify
@@ -0,0 +1,506 @@
+#pragma once
+
+// 通用工作窃取线程池（header-only），供 lambda / 排序 / 形状 / leetcode 等 demo 共用。
+// 跨日期目录共用的头文件都放在仓库根目录的 common/ 下，各 demo 用相对路径 include，仍然是一条 g++ 命令编译。
+//
+// 结构：
+//   - 每个工作线程一个 Chase-Lev 双端队列：
+//       owner 线程在底部 push/pop（LIFO，无锁、几乎无竞争）
+//       其它线程在顶部 steal（FIFO，CAS 竞争）
+//   - 外部线程（如 main）提交的任务进入一个全局注入队列（带锁），由工作线程领取
+//   - 另预留一个没有线程的槽位：外部线程在 participate() 期间占用它，像工作线程一样把派生任务
+//     压进槽位自己的 Chase-Lev 队列、边等边干活（parallel_for 从外部调用时就走这条路，
+//     否则外部线程递归二分派生的子任务全部经过注入队列的锁）
+//   - 任务的三种用法：
+//       submit(f)        -> std::future<R>，适合“扔一个任务，之后拿结果”
+//       TaskGroup        -> 一组 fire-and-forget 任务 + wait()，等待方会帮忙执行任务
+//       parallel_for / parallel_reduce -> 递归二分切块，空闲线程偷走大块
+//
+// 注意：不要在池内任务里对 submit() 返回的 future 调用 get()（所有工作线程都阻塞时会死锁），
+//       池内的 fork-join 用 TaskGroup / parallel_for，它们的 wait() 会边等边干活。
+//
+// 参考：Chase & Lev, "Dynamic Circular Work-Stealing Deque" (SPAA'05)；
+//       内存序按 Lê et al., "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP'13)。
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ws {
+
+// ================= 1. Chase-Lev 双端队列 =================
+
+// 只存指针：元素用 std::atomic<T> 存放，steal 读到的旧值不会是“撕裂”的
+template <class T>
+class ChaseLevDeque {
+    static_assert(std::is_pointer<T>::value, "ChaseLevDeque 只存放指针");
+
+public:
+    explicit ChaseLevDeque(int64_t capacity = 256) {
+        int64_t cap = 1;
+        while (cap < capacity) cap <<= 1;
+        auto* a = new Array(cap);
+        arrays_.emplace_back(a);
+        array_.store(a, std::memory_order_relaxed);
+    }
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    // 仅 owner 调用
+    void push(T x) {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        Array* a = array_.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1) {
+            // 扩容：旧数组不能立即释放，并发的 steal 可能还在读它，留到析构时统一释放
+            a = a->grow(t, b);
+            arrays_.emplace_back(a);
+            array_.store(a, std::memory_order_release);
+        }
+        a->put(b, x);
+        // 用 release store 发布（与 steal 里 bottom_ 的 acquire 配对）；论文写法是 release fence + relaxed store，
+        // 效果相同，但 TSan 不认 fence，会把窃贼读任务对象报成数据竞争
+        bottom_.store(b + 1, std::memory_order_release);
+    }
+
+    // 仅 owner 调用，空时返回 nullptr
+    T pop() {
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* a = array_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T x = a->get(b);
+        if (t == b) {
+            // 只剩最后一个元素：与 stealer 抢，用 CAS 决定归属
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed)) {
+                x = nullptr;
+            }
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return x;
+    }
+
+    // 任意线程调用，空或抢失败时返回 nullptr
+    T steal() {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+        Array* a = array_.load(std::memory_order_acquire);
+        T x = a->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return x;
+    }
+
+    bool empty() const {
+        return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Array {
+        int64_t capacity;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Array(int64_t cap) : capacity(cap), slots(new std::atomic<T>[cap]) {}
+
+        T get(int64_t i) const { return slots[i & (capacity - 1)].load(std::memory_order_relaxed); }
+        void put(int64_t i, T x) { slots[i & (capacity - 1)].store(x, std::memory_order_relaxed); }
+
+        Array* grow(int64_t t, int64_t b) const {
+            auto* a = new Array(capacity * 2);
+            for (int64_t i = t; i < b; ++i) a->put(i, get(i));
+            return a;
+        }
+    };
+
+    // top_ 与 bottom_ 分别被 stealer 和 owner 频繁写，放在不同缓存行避免伪共享
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    alignas(64) std::atomic<Array*> array_{nullptr};
+    std::vector<std::unique_ptr<Array>> arrays_;  // owner 独占，含所有历史数组
+};
+
+// ================= 2. 任务 =================
+
+struct TaskBase {
+    virtual ~TaskBase() = default;
+    virtual void run() = 0;
+};
+
+template <class F>
+struct TaskImpl final : TaskBase {
+    F fn;
+    explicit TaskImpl(F f) : fn(std::move(f)) {}
+    void run() override { fn(); }
+};
+
+struct PoolStats {
+    uint64_t executed = 0;  // 总执行任务数
+    uint64_t stolen = 0;    // 其中通过 steal 拿到的
+    uint64_t injected = 0;  // 其中来自外部注入队列的
+};
+
+// ================= 3. 线程池 =================
+
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(size_t threadCount = std::thread::hardware_concurrency()) {
+        if (threadCount == 0) threadCount = 1;
+        threadCount_ = threadCount;
+        // 最后一个是外部线程的槽位，没有自己的线程
+        workers_.reserve(threadCount + 1);
+        for (size_t i = 0; i <= threadCount; ++i) {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+        for (size_t i = 0; i < threadCount; ++i) {
+            workers_[i]->thread = std::thread([this, i] { workerLoop(i); });
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lk(sleepMutex_);
+            stop_.store(true, std::memory_order_relaxed);
+        }
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        sleepCv_.notify_all();
+        for (size_t i = 0; i < threadCount_; ++i) workers_[i]->thread.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    size_t size() const { return threadCount_; }
+
+    // 带返回值的任务
+    template <class F, class R = std::invoke_result_t<std::decay_t<F>>>
+    std::future<R> submit(F&& f) {
+        std::packaged_task<R()> task(std::forward<F>(f));
+        std::future<R> fut = task.get_future();
+        spawn(std::move(task));
+        return fut;
+    }
+
+    // 无返回值、无 future 的任务（开销最小）
+    template <class F>
+    void spawn(F&& f) {
+        TaskBase* t = new TaskImpl<std::decay_t<F>>(std::forward<F>(f));
+        if (tlsPool_ == this) {
+            workers_[tlsIndex_]->deque.push(t);  // 池内派生：压进自己的队列
+        } else {
+            std::lock_guard<std::mutex> lk(injectMutex_);
+            inject_.push_back(t);
+        }
+        wakeOne();
+    }
+
+    // 外部线程在 fn 执行期间占用预留槽位：fn 里派生的任务进槽位自己的队列（可被工作线程偷走），
+    // 等待方也从这个队列 pop。槽位只有一个，已被别的外部线程占用时直接执行 fn（派生走注入队列）
+    template <class F>
+    void participate(F&& fn) {
+        if (tlsPool_ == this) {
+            fn();
+            return;
+        }
+        bool expected = false;
+        if (!slotBusy_.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            fn();
+            return;
+        }
+        struct Leave {
+            WorkStealingPool* self;
+            WorkStealingPool* prevPool;
+            size_t prevIndex;
+            ~Leave() {
+                tlsPool_ = prevPool;
+                tlsIndex_ = prevIndex;
+                // 队列里剩下的任务（别的组派生的）仍然可以被工作线程偷走，下一个占用者接着 pop
+                self->slotBusy_.store(false, std::memory_order_release);
+            }
+        } leave{this, tlsPool_, tlsIndex_};
+        tlsPool_ = this;
+        tlsIndex_ = threadCount_;
+        fn();
+    }
+
+    // 执行一个待办任务（若有）。等待方用它“边等边干活”
+    bool tryRunOne() {
+        TaskBase* t = (tlsPool_ == this) ? findWork(tlsIndex_) : findWorkExternal();
+        if (!t) return false;
+        runTask(t);
+        return true;
+    }
+
+    PoolStats stats() const {
+        PoolStats s;
+        for (auto& w : workers_) {
+            s.executed += w->executed.load(std::memory_order_relaxed);
+            s.stolen += w->stolen.load(std::memory_order_relaxed);
+            s.injected += w->injected.load(std::memory_order_relaxed);
+        }
+        s.executed += externalExecuted_.load(std::memory_order_relaxed);
+        s.stolen += externalStolen_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    void resetStats() {
+        for (auto& w : workers_) {
+            w->executed.store(0, std::memory_order_relaxed);
+            w->stolen.store(0, std::memory_order_relaxed);
+            w->injected.store(0, std::memory_order_relaxed);
+        }
+        externalExecuted_.store(0, std::memory_order_relaxed);
+        externalStolen_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    struct alignas(64) Worker {
+        ChaseLevDeque<TaskBase*> deque;
+        std::thread thread;
+        uint64_t rng = 0;
+        // 仅 owner 写，relaxed 即可；stats() 读到的是近似值
+        std::atomic<uint64_t> executed{0};
+        std::atomic<uint64_t> stolen{0};
+        std::atomic<uint64_t> injected{0};
+    };
+
+    static void runTask(TaskBase* t) {
+        t->run();
+        delete t;
+    }
+
+    TaskBase* popInjected() {
+        std::lock_guard<std::mutex> lk(injectMutex_);
+        if (inject_.empty()) return nullptr;
+        TaskBase* t = inject_.front();
+        inject_.pop_front();
+        return t;
+    }
+
+    // 从随机位置开始轮询所有队列，避免所有窃贼都盯着同一个受害者
+    TaskBase* stealFrom(size_t self, uint64_t& rng) {
+        const size_t n = workers_.size();
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        size_t start = static_cast<size_t>(rng % n);
+        for (size_t k = 0; k < n; ++k) {
+            size_t victim = (start + k) % n;
+            if (victim == self) continue;
+            if (TaskBase* t = workers_[victim]->deque.steal()) return t;
+        }
+        return nullptr;
+    }
+
+    TaskBase* findWork(size_t idx) {
+        Worker& w = *workers_[idx];
+        if (TaskBase* t = w.deque.pop()) {
+            w.executed.fetch_add(1, std::memory_order_relaxed);
+            return t;
+        }
+        if (TaskBase* t = popInjected()) {
+            w.executed.fetch_add(1, std::memory_order_relaxed);
+            w.injected.fetch_add(1, std::memory_order_relaxed);
+            return t;
+        }
+        if (TaskBase* t = stealFrom(idx, w.rng)) {
+            w.executed.fetch_add(1, std::memory_order_relaxed);
+            w.stolen.fetch_add(1, std::memory_order_relaxed);
+            return t;
+        }
+        return nullptr;
+    }
+
+    TaskBase* findWorkExternal() {
+        if (TaskBase* t = popInjected()) {
+            externalExecuted_.fetch_add(1, std::memory_order_relaxed);
+            return t;
+        }
+        thread_local uint64_t rng = 0x9E3779B97F4A7C15ull;
+        if (TaskBase* t = stealFrom(workers_.size(), rng)) {
+            externalExecuted_.fetch_add(1, std::memory_order_relaxed);
+            externalStolen_.fetch_add(1, std::memory_order_relaxed);
+            return t;
+        }
+        return nullptr;
+    }
+
+    // 休眠/唤醒协议：
+    //   生产者：先入队，再 epoch++，再看 sleepers_ 决定是否 notify
+    //   消费者：先读 epoch，再找活；找不到才在锁内检查 epoch 是否变化后睡眠
+    // epoch 与 sleepers_ 都是 seq_cst，保证“入队后没人被叫醒”与“睡前没看到新任务”不会同时发生
+    void wakeOne() {
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+            { std::lock_guard<std::mutex> lk(sleepMutex_); }
+            sleepCv_.notify_one();
+        }
+    }
+
+    void workerLoop(size_t idx) {
+        tlsPool_ = this;
+        tlsIndex_ = idx;
+        workers_[idx]->rng = 0x9E3779B97F4A7C15ull * (idx + 1);
+
+        while (true) {
+            uint64_t seen = epoch_.load(std::memory_order_seq_cst);
+            if (TaskBase* t = findWork(idx)) {
+                runTask(t);
+                continue;
+            }
+            // 短暂让出 CPU 再试几次：细粒度任务场景下比直接睡眠的唤醒延迟低得多
+            bool found = false;
+            for (int spin = 0; spin < 32 && !found; ++spin) {
+                std::this_thread::yield();
+                if (TaskBase* t = findWork(idx)) {
+                    runTask(t);
+                    found = true;
+                }
+            }
+            if (found) continue;
+            if (stop_.load(std::memory_order_relaxed)) return;
+
+            std::unique_lock<std::mutex> lk(sleepMutex_);
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            sleepCv_.wait(lk, [&] {
+                return stop_.load(std::memory_order_relaxed) ||
+                       epoch_.load(std::memory_order_seq_cst) != seen;
+            });
+            sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+
+    size_t threadCount_ = 0;
+    std::vector<std::unique_ptr<Worker>> workers_;  // threadCount_ 个工作线程 + 1 个外部槽位
+    std::atomic<bool> slotBusy_{false};
+
+    std::mutex injectMutex_;
+    std::deque<TaskBase*> inject_;
+
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCv_;
+    std::atomic<uint64_t> epoch_{0};
+    std::atomic<int> sleepers_{0};
+    std::atomic<bool> stop_{false};
+
+    std::atomic<uint64_t> externalExecuted_{0};
+    std::atomic<uint64_t> externalStolen_{0};
+
+    static thread_local WorkStealingPool* tlsPool_;
+    static thread_local size_t tlsIndex_;
+};
+
+inline thread_local WorkStealingPool* WorkStealingPool::tlsPool_ = nullptr;
+inline thread_local size_t WorkStealingPool::tlsIndex_ = 0;
+
+// ================= 4. TaskGroup：fork-join =================
+
+class TaskGroup {
+public:
+    explicit TaskGroup(WorkStealingPool& pool) : pool_(pool) {}
+    ~TaskGroup() { wait(); }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    template <class F>
+    void run(F&& f) {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        pool_.spawn([this, fn = std::forward<F>(f)]() mutable {
+            fn();
+            // 这是任务对 TaskGroup 的最后一次访问：等待方看到 0 后可以立即析构 TaskGroup
+            pending_.fetch_sub(1, std::memory_order_acq_rel);
+        });
+    }
+
+    // 等待期间帮忙执行池里的任务（不一定是本组的），既避免死锁也不浪费等待线程
+    void wait() {
+        int idle = 0;
+        while (pending_.load(std::memory_order_acquire) != 0) {
+            if (pool_.tryRunOne()) {
+                idle = 0;
+            } else if (++idle < 64) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(20));
+            }
+        }
+    }
+
+private:
+    WorkStealingPool& pool_;
+    std::atomic<size_t> pending_{0};
+};
+
+// ================= 5. parallel_for / parallel_reduce =================
+
+namespace detail {
+
+// 递归二分：右半边派生成任务（可被偷走），左半边自己继续切，直到不大于 grain
+template <class Body>
+void splitRange(TaskGroup& g, size_t lo, size_t hi, size_t grain, const Body& body) {
+    while (hi - lo > grain) {
+        size_t mid = lo + (hi - lo) / 2;
+        g.run([&g, mid, hi, grain, &body] { splitRange(g, mid, hi, grain, body); });
+        hi = mid;
+    }
+    body(lo, hi);
+}
+
+}  // namespace detail
+
+// body(lo, hi) 处理 [lo, hi)；grain 为叶子块的最大元素数
+template <class Body>
+void parallel_for(WorkStealingPool& pool, size_t begin, size_t end, size_t grain,
+                  const Body& body) {
+    if (begin >= end) return;
+    if (grain == 0) grain = 1;
+    pool.participate([&] {
+        TaskGroup g(pool);
+        detail::splitRange(g, begin, end, grain, body);
+        g.wait();
+    });
+}
+
+// map(lo, hi) -> T 计算一个块的部分结果；combine(T, T) -> T 合并
+// 叶子块按 grain 固定切分、按下标顺序合并：与线程数和调度顺序无关，浮点结果逐位可复现
+template <class T, class Map, class Combine>
+T parallel_reduce(WorkStealingPool& pool, size_t begin, size_t end, size_t grain, T identity,
+                  const Map& map, const Combine& combine) {
+    if (begin >= end) return identity;
+    if (grain == 0) grain = 1;
+    const size_t leaves = (end - begin + grain - 1) / grain;
+    std::vector<T> partial(leaves, identity);
+    parallel_for(pool, 0, leaves, 1, [&](size_t l0, size_t l1) {
+        for (size_t l = l0; l < l1; ++l) {
+            size_t lo = begin + l * grain;
+            size_t hi = lo + grain < end ? lo + grain : end;
+            partial[l] = map(lo, hi);
+        }
+    });
+    T acc = identity;
+    for (const T& p : partial) acc = combine(acc, p);
+    return acc;
+}
+
+}  // namespace ws